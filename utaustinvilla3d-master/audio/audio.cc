@@ -50,16 +50,15 @@ bool makeSayMessage(const int &uNum, const double &currentServerTime, const doub
         return false;
     }
 
-    vector<int> bits;
-    if(!(dataToBits(currentServerTime, ballLastSeenServerTime, ballX, ballY, myX, myY, fFallen, bits))) {
+    message = "(say ";
+    SayMessageWriter writer(message);
+    if(!(writeSayData(currentServerTime, ballLastSeenServerTime, ballX, ballY, myX, myY, fFallen, writer))) {
+        message = "";
         return false;
     }
+    writer.finish();
 
-    if(!(bitsToString(bits, message))) {
-        return false;
-    }
-
-    message = "(say " + message + ")";
+    message += ")";
 
     return true;
 }
@@ -91,12 +90,8 @@ bool processHearMessage(const string &message, const double &heardServerTime, in
     time = 0;
 
 
-    vector<int> bits;
-    if(!(stringToBits(message, bits))) {
-        return false;
-    }
-
-    if(!(bitsToData(bits, time, ballLastSeenServerTime, ballX, ballY, agentX, agentY, fFallen))) {
+    HearMessageReader reader(message);
+    if(!(readHearData(reader, time, ballLastSeenServerTime, ballX, ballY, agentX, agentY, fFallen))) {
         return false;
     }
 
@@ -116,199 +111,149 @@ bool processHearMessage(const string &message, const double &heardServerTime, in
 
 //------ Implentation Methods (called by inteface methods) ------
 
-vector<int> intToBits(const int &n, const int &numBits) {
-
-    vector<int> bits;
+/*
+  Symbol of every 6 bit value and value of every character, -1 for
+  characters not in commAlphabet
+*/
+static char commSymbols[256];
+static signed char commSymbolValues[256];
 
-    if(n < 0) {
-        bits.clear();
-        return bits;
+static bool initCommTables() {
+    if(commAlphabet.size() != 64) {
+        cerr << "audio: alphabet size not 64!\n";
+        return false;
     }
-
-    int m = n; //Copy.
-
-    bits.resize(numBits);
-    for(int i = numBits - 1; i >= 0; i--) {
-        bits[i] = m % 2;
-        m /= 2;
+    for(int i = 0; i < 256; i++) {
+        commSymbols[i] = commAlphabet[i & 63];
+        commSymbolValues[i] = -1;
     }
-
-    return bits;
+    for(int i = 0; i < 64; i++) {
+        commSymbolValues[(unsigned char)commAlphabet[i]] = i;
+    }
+    return true;
 }
 
-vector<int> intToBits(const unsigned long long &n, const int &numBits) {
-    vector<int> bits;
+static const bool fCommTablesValid = initCommTables();
 
-    unsigned long long m = n; //Copy.
+SayMessageWriter::SayMessageWriter(string &message) :
+    message(message),
+    bits(0),
+    numPendingBits(0) {
+}
 
-    bits.resize(numBits);
-    for(int i = numBits - 1; i >= 0; i--) {
-        bits[i] = m % 2;
-        m /= 2;
+void SayMessageWriter::write(const unsigned int &value, const int &numBits) {
+    // Never more than 5 + 32 bits are pending, older ones just get shifted out
+    bits = (bits << numBits) | (value & ((1ULL << numBits) - 1));
+    numPendingBits += numBits;
+    while(numPendingBits >= COMM_SYMBOL_BITS) {
+        numPendingBits -= COMM_SYMBOL_BITS;
+        message += commSymbols[(bits >> numPendingBits) & 63];
     }
+}
 
-    return bits;
+void SayMessageWriter::finish() {
+    if(numPendingBits > 0) {
+        message += commSymbols[(bits << (COMM_SYMBOL_BITS - numPendingBits)) & 63];
+        numPendingBits = 0;
+    }
 }
 
-int bitsToInt(const vector<int> &bits, const int &start, const int &end) {
+HearMessageReader::HearMessageReader(const string &message) :
+    message(message),
+    pos(0),
+    bits(0),
+    numPendingBits(0) {
+}
 
-    if(start < 0 || end >= (int)bits.size()) {
-        return 0;//Error.
+bool HearMessageReader::read(const int &numBits, unsigned int &value) {
+    while(numPendingBits < numBits) {
+        if(pos >= message.length()) {
+            return false;
+        }
+        int symbolValue = commSymbolValues[(unsigned char)message[pos++]];
+        if(symbolValue < 0) {
+            return false;
+        }
+        bits = (bits << COMM_SYMBOL_BITS) | symbolValue;
+        numPendingBits += COMM_SYMBOL_BITS;
     }
+    numPendingBits -= numBits;
+    value = (bits >> numPendingBits) & ((1ULL << numBits) - 1);
+    return true;
+}
 
-    int n = 0;
-    for(int i = start; i <= end; i++) {
-        n *= 2;
-        n += bits[i];
+bool HearMessageReader::restIsValid() const {
+    for(size_t i = pos; i < message.length(); i++) {
+        if(commSymbolValues[(unsigned char)message[i]] < 0) {
+            return false;
+        }
     }
+    return true;
+}
 
+/*
+  Fixed point value of x in [min, max] with numBits bits
+*/
+static unsigned int quantize(const double &x, const double &min, const double &max, const int &numBits) {
+    double clipped = (x < min)? min : ((x > max)? max : x);
+    int steps = (1 << numBits) - 1;
+    int n = (((clipped - min) * steps) / (max - min)) + 0.5;
     return n;
 }
 
-bool dataToBits(const double &time, const double &ballLastSeenTime, const double &ballX, const double &ballY, const double &myX, const double &myY, const bool &fFallen, vector<int> &bits) {
-
-    int cycles = (time * 50) + 0.1;
-    cycles = cycles%(1<<16);
-    vector<int> timeBits = intToBits(cycles, 16);
-
-    int ballLastSeenCycle = (ballLastSeenTime * 50) + 0.1;
-    ballLastSeenCycle = ballLastSeenCycle%(1<<16);
-    vector<int> ballLastSeenTimeBits = intToBits(ballLastSeenCycle, 16);
-
-    double clippedBallX = (ballX < minBallX)? minBallX : ((ballX > maxBallX)? maxBallX : ballX);
-    int bx = (((clippedBallX - minBallX) * 1023) / (maxBallX - minBallX)) + 0.5;
-    vector<int> ballXBits = intToBits(bx, 10);
-
-    double clippedBallY = (ballY < minBallY)? minBallY : ((ballY > maxBallY)? maxBallY : ballY);
-    int by = (((clippedBallY - minBallY) * 1023) / (maxBallY - minBallY)) + 0.5;
-    vector<int> ballYBits = intToBits(by, 10);
-
-    double clippedMyX = (myX < minAgentX)? minAgentX : ((myX > maxAgentX)? maxAgentX : myX);
-    int mx = (((clippedMyX - minAgentX) * 1023) / (maxAgentX - minAgentX)) + 0.5;
-    vector<int> myXBits = intToBits(mx, 10);
-
-    double clippedMyY = (myY < minAgentY)? minAgentY : ((myY > maxAgentY)? maxAgentY : myY);
-    int my = (((clippedMyY - minAgentY) * 1023) / (maxAgentY - minAgentY)) + 0.5;
-    vector<int> myYBits = intToBits(my, 10);
-
-    int fallenBit = (fFallen)? 1 : 0;
-
-    bits.insert(bits.end(), timeBits.begin(), timeBits.end());//16
-    bits.insert(bits.end(), ballLastSeenTimeBits.begin(), ballLastSeenTimeBits.end());//16
-    bits.insert(bits.end(), ballXBits.begin(), ballXBits.end());//10
-    bits.insert(bits.end(), ballYBits.begin(), ballYBits.end());//10
-    bits.insert(bits.end(), myXBits.begin(), myXBits.end());//10
-    bits.insert(bits.end(), myYBits.begin(), myYBits.end());//10
-    bits.push_back(fallenBit);//1
-
-    return true;
-
+static double unquantize(const unsigned int &n, const double &min, const double &max, const int &numBits) {
+    int steps = (1 << numBits) - 1;
+    return min + ((max - min) * (n / double(steps)));
 }
 
-bool bitsToString(const vector<int> &bits, string &message) {
+bool writeSayData(const double &time, const double &ballLastSeenTime, const double &ballX, const double &ballY, const double &myX, const double &myY, const bool &fFallen, SayMessageWriter &writer) {
 
-    message = "";
-    if(commAlphabet.size() != 64) {
-        cerr << "bitsToString: alphabet size not 64!\n";
+    if(!fCommTablesValid) {
         return false;
     }
 
-    vector<int> index;
-    index.resize((bits.size() + 5) / 6);
-    size_t ctr = 0;
-    for(size_t i = 0; i < index.size(); i++) {
-
-        index[i] = 0;
-        for(int j = 0; j < 6; j++) {
-
-            index[i] *= 2;
-
-            if(ctr < bits.size()) {
-                index[i] += bits[ctr];
-                ctr++;
-            }
-
-        }
+    int cycles = (time * 50) + 0.1;
+    int ballLastSeenCycle = (ballLastSeenTime * 50) + 0.1;
+    if(cycles < 0 || ballLastSeenCycle < 0) {
+        return false;
     }
 
-    for(size_t i = 0; i < index.size(); i++) {
-        message += commAlphabet.at(index[i]);
-    }
+    writer.write(cycles%(1<<16), 16);
+    writer.write(ballLastSeenCycle%(1<<16), 16);
+    writer.write(quantize(ballX, minBallX, maxBallX, 10), 10);
+    writer.write(quantize(ballY, minBallY, maxBallY, 10), 10);
+    writer.write(quantize(myX, minAgentX, maxAgentX, 10), 10);
+    writer.write(quantize(myY, minAgentY, maxAgentY, 10), 10);
+    writer.write((fFallen)? 1 : 0, 1);
 
     return true;
 }
 
+bool readHearData(HearMessageReader &reader, double &time, double &ballLastSeenTime, double &ballX, double &ballY, double &agentX, double &agentY, bool &fFallen) {
 
-bool bitsToData(const vector<int> &bits, double &time, double &ballLastSeenTime, double &ballX, double &ballY, double &agentX, double &agentY, bool &fFallen) {
-    if(bits.size() < (16 + 16 + 10 + 10 + 10 + 10 + 1)) {
-        time = 0;
-        ballLastSeenTime = 0,
-        ballX = 0;
-        ballY = 0;
-        agentX = 0;
-        agentY = 0;
-        fFallen = false;
+    if(!fCommTablesValid) {
         return false;
     }
 
-    int ctr = 0;
-
-    int cycles = bitsToInt(bits, ctr, ctr + 15);
-    time = cycles * 0.02;
-    ctr += 16;
-
-    int ballLastSeenCycles = bitsToInt(bits, ctr, ctr + 15);
-    ballLastSeenTime = ballLastSeenCycles * 0.02;
-    ctr += 16;
-
-    int bx = bitsToInt(bits, ctr, ctr + 9);
-    ballX = minBallX + ((maxBallX - minBallX) * (bx / 1023.0));
-    ctr += 10;
-
-    int by = bitsToInt(bits, ctr, ctr + 9);
-    ballY = minBallY + ((maxBallY - minBallY) * (by / 1023.0));
-    ctr += 10;
-
-    int ax = bitsToInt(bits, ctr, ctr + 9);
-    agentX = minAgentX + ((maxAgentX - minAgentX) * (ax / 1023.0));
-    ctr += 10;
-
-    int ay = bitsToInt(bits, ctr, ctr + 9);
-    agentY = minAgentY + ((maxAgentY - minAgentY) * (ay / 1023.0));
-    ctr += 10;
-
-    fFallen = (bits[ctr] == 0)? false : true;
-    ctr += 1;
-
-    return true;
-}
-
-
-bool stringToBits(const string &message, vector<int> &bits) {
-
-    if(commAlphabet.size() != 64) {
-        cerr << "bits2String: alphabet size not 64!\n";
+    unsigned int cycles, ballLastSeenCycles, bx, by, ax, ay, fallenBit;
+    if(!(reader.read(16, cycles) &&
+         reader.read(16, ballLastSeenCycles) &&
+         reader.read(10, bx) &&
+         reader.read(10, by) &&
+         reader.read(10, ax) &&
+         reader.read(10, ay) &&
+         reader.read(1, fallenBit) &&
+         reader.restIsValid())) {
         return false;
     }
 
-    bits.resize(message.length() * 6);
-
-    for(size_t i = 0; i < message.length(); i++) {
-
-        // Make sure every letter in the message comes from our alphabet. Make a mapping.
-        // If any violation, return false;
-        const char c = message.at(i);
-        size_t n = commAlphabet.find(c);
-        if(n == string::npos) {
-            bits.clear();
-            return false;
-        }
-
-        for(int j = 5; j >= 0; j--) {
-            bits[(i * 6) + j] = n % 2;
-            n /= 2;
-        }
-    }
+    time = cycles * 0.02;
+    ballLastSeenTime = ballLastSeenCycles * 0.02;
+    ballX = unquantize(bx, minBallX, maxBallX, 10);
+    ballY = unquantize(by, minBallY, maxBallY, 10);
+    agentX = unquantize(ax, minAgentX, maxAgentX, 10);
+    agentY = unquantize(ay, minAgentY, maxAgentY, 10);
+    fFallen = (fallenBit == 0)? false : true;
 
     return true;
 }
@@ -7,24 +7,62 @@ drop-in player challenge
 #define _AUDIO_H
 
 #include <string>
-#include <vector>
 
 // Communication alphabet must have 64 symbols.
 const std::string commAlphabet =  "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789*#";
 
-/*-------------------------------Utilities---------------------------------------------*/
-std::vector<int> intToBits(const int &n, const int &numBits);
-std::vector<int> intToBits(const unsigned long long &n, const int &numBits);
-int bitsToInt(const std::vector<int> &bits, const int &start, const int &end);
+// Each symbol of a message carries this many bits
+#define COMM_SYMBOL_BITS 6
+
+/*-------------------------------Bit packing---------------------------------------------*/
+
+/*
+ * Appends fields to a message most significant bit first, six bits per
+ * symbol of commAlphabet.  Bits are collected in a 64 bit accumulator and
+ * turned into symbols with a lookup table, so a message of any layout is
+ * built without per bit work or allocations.
+ */
+class SayMessageWriter {
+public:
+    SayMessageWriter(std::string &message);
+
+    // Appends the numBits (at most 32) low bits of value
+    void write(const unsigned int &value, const int &numBits);
+    // Pads the last symbol with zero bits
+    void finish();
+
+private:
+    std::string &message;
+    unsigned long long bits;
+    int numPendingBits;
+};
+
+/*
+ * Reads back the fields written by SayMessageWriter
+ */
+class HearMessageReader {
+public:
+    HearMessageReader(const std::string &message);
+
+    // Reads the next numBits (at most 32) bits, false if the message is too
+    // short or has a symbol not in commAlphabet
+    bool read(const int &numBits, unsigned int &value);
+    // Whether the symbols not read yet are all in commAlphabet
+    bool restIsValid() const;
+
+private:
+    const std::string &message;
+    size_t pos;
+    unsigned long long bits;
+    int numPendingBits;
+};
 
 /*-------------------------------Encoding---------------------------------------------*/
 bool makeSayMessage(const int &uNum, const double &currentServerTime, const double &ballLastSeenServerTime, const double &ballX, const double &ballY, const double &myX, const double &myY, const bool &fFallen, std::string &message);
-bool dataToBits(const double &time, const double &ballLastSeenTime, const double &ballX, const double &ballY, const double &myX, const double &myY, const bool &fFallen, std::vector<int> &bits);
-bool bitsToString(const std::vector<int> &bits, std::string &message);
+bool writeSayData(const double &time, const double &ballLastSeenTime, const double &ballX, const double &ballY, const double &myX, const double &myY, const bool &fFallen, SayMessageWriter &writer);
 
 /*-------------------------------Decoding---------------------------------------------*/
 bool processHearMessage(const std::string &message, const double &heardServerTime, int &uNum, double &ballLastSeenServerTime, double &ballX, double &ballY, double &agentX, double &agentY, bool &fFallen, double &time);
-bool bitsToData(const std::vector<int> &bits, double &time, double &ballLastSeenTime, double &ballX, double &ballY, double &agentX, double &agentY, bool &fFallen);
-bool stringToBits(const std::string &message, std::vector<int> &bits);
+bool readHearData(HearMessageReader &reader, double &time, double &ballLastSeenTime, double &ballX, double &ballY, double &agentX, double &agentY, bool &fFallen);
 
 #endif
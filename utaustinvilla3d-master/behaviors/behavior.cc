@@ -1,8 +1,15 @@
 #include "behavior.h"
 
+#include <common/ParamRegistry.h>
+
 Behavior::Behavior() {
 }
 
 Behavior::~Behavior() {
 }
 
+
+bool Behavior::reloadParameters(const ParamRegistry& params) {
+    getParams() = params;
+    return true;
+}
@@ -3,6 +3,8 @@
 
 #include <string>
 
+class ParamRegistry;
+
 class Behavior {
 
 public:
@@ -21,6 +23,13 @@ public:
 
     /** Get message for sending to the server through the monitor port */
     virtual std::string getMonMessage() = 0;
+
+    /** called between messages after the parameter files were loaded
+        again into params; makes them the agent's parameters and picks
+        them up without reconnecting.  Returns false, keeping the old
+        parameters, if the behavior can't use them
+    */
+    virtual bool reloadParameters(const ParamRegistry& params);
 };
 
 #endif // BEHAVIOR_H
@@ -1,5 +1,54 @@
 #include "naobehavior.h"
 
+// Getup parameters, the L7 (toe) ones are only in the parameter files of
+// the body type with toes
+static const Param getupStateDownInitialWait("getup_parms_stateDownInitialWait");
+static const Param getupStateUpInitialWait("getup_parms_stateUpInitialWait");
+static const Param getupStateDown3A1("getup_parms_stateDown3A1");
+static const Param getupStateDown3L3("getup_parms_stateDown3L3");
+static const Param getupStateDown3L7("getup_parms_stateDown3L7", false);
+static const Param getupStateDown3MinTime("getup_parms_stateDown3MinTime");
+static const Param getupStateDown5L1("getup_parms_stateDown5L1");
+static const Param getupStateDown5L7("getup_parms_stateDown5L7", false);
+static const Param getupStateDown5MinTime("getup_parms_stateDown5MinTime");
+static const Param getupStateDown7L1("getup_parms_stateDown7L1");
+static const Param getupStateDown7L3("getup_parms_stateDown7L3");
+static const Param getupStateDown7L7("getup_parms_stateDown7L7", false);
+static const Param getupStateDown7MinTime("getup_parms_stateDown7MinTime");
+static const Param getupStateDown10MinTime("getup_parms_stateDown10MinTime");
+static const Param getupStateUp3A1("getup_parms_stateUp3A1");
+static const Param getupStateUp3A2("getup_parms_stateUp3A2");
+static const Param getupStateUp3A4("getup_parms_stateUp3A4");
+static const Param getupStateUp3L3("getup_parms_stateUp3L3");
+static const Param getupStateUp3L7("getup_parms_stateUp3L7", false);
+static const Param getupStateUp3MinTime("getup_parms_stateUp3MinTime");
+static const Param getupStateUp5L3("getup_parms_stateUp5L3");
+static const Param getupStateUp5L7("getup_parms_stateUp5L7", false);
+static const Param getupStateUp5MinTime("getup_parms_stateUp5MinTime");
+static const Param getupStateUp7L1("getup_parms_stateUp7L1");
+static const Param getupStateUp7L7("getup_parms_stateUp7L7", false);
+static const Param getupStateUp7MinTime("getup_parms_stateUp7MinTime");
+static const Param getupStateUp9A1("getup_parms_stateUp9A1");
+static const Param getupStateUp9L1("getup_parms_stateUp9L1");
+static const Param getupStateUp9L4("getup_parms_stateUp9L4");
+static const Param getupStateUp9L5("getup_parms_stateUp9L5");
+static const Param getupStateUp9L6("getup_parms_stateUp9L6");
+static const Param getupStateUp9L7("getup_parms_stateUp9L7", false);
+static const Param getupStateUp9MinTime("getup_parms_stateUp9MinTime");
+static const Param getupStateUp11A1("getup_parms_stateUp11A1");
+static const Param getupStateUp11L1("getup_parms_stateUp11L1");
+static const Param getupStateUp11L5("getup_parms_stateUp11L5");
+static const Param getupStateUp11L7("getup_parms_stateUp11L7", false);
+static const Param getupStateUp11MinTime("getup_parms_stateUp11MinTime");
+static const Param getupStateUp13A1("getup_parms_stateUp13A1");
+static const Param getupStateUp13L1("getup_parms_stateUp13L1");
+static const Param getupStateUp13L3("getup_parms_stateUp13L3");
+static const Param getupStateUp13L4("getup_parms_stateUp13L4");
+static const Param getupStateUp13L5("getup_parms_stateUp13L5");
+static const Param getupStateUp13L7("getup_parms_stateUp13L7", false);
+static const Param getupStateUp13MinTime("getup_parms_stateUp13MinTime");
+static const Param getupStateUp15MinTime("getup_parms_stateUp15MinTime");
+
 /*
   This function returns true if we are taking some action
   to avert or recover from fall; false otherwise.
@@ -96,7 +145,7 @@ bool NaoBehavior::checkingFall() {
             currentFallStateStartTime = worldModel->getTime();
         }
 
-        if(worldModel->getTime() > (fallTimeStamp + (fallenDown ? atof(namedParams.find("getup_parms_stateDownInitialWait")->second.c_str()) : atof(namedParams.find("getup_parms_stateUpInitialWait")->second.c_str())))) {
+        if(worldModel->getTime() > (fallTimeStamp + (fallenDown ? getupStateDownInitialWait : getupStateUpInitialWait))) {
             fallTimeStamp = -1;
             fallState = 1;
             currentFallStateStartTime = -1.0;
@@ -135,25 +184,25 @@ bool NaoBehavior::checkingFall() {
                 currentFallStateStartTime = worldModel->getTime();
             }
 
-            bodyModel->setTargetAngle(EFF_LA1, atof(namedParams.find("getup_parms_stateDown3A1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RA1, atof(namedParams.find("getup_parms_stateDown3A1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LA1, getupStateDown3A1);
+            bodyModel->setTargetAngle(EFF_RA1, getupStateDown3A1);
 
             bodyModel->setTargetAngle(EFF_LA2, 0);
             bodyModel->setTargetAngle(EFF_RA2, 0);
 
-            bodyModel->setTargetAngle(EFF_LL3, atof(namedParams.find("getup_parms_stateDown3L3")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL3, atof(namedParams.find("getup_parms_stateDown3L3")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL3, getupStateDown3L3);
+            bodyModel->setTargetAngle(EFF_RL3, getupStateDown3L3);
 
             if (bodyModel->hasToe()) {
-                bodyModel->setTargetAngle(EFF_LL7, atof(namedParams.find("getup_parms_stateDown3L7")->second.c_str()));
-                bodyModel->setTargetAngle(EFF_RL7, atof(namedParams.find("getup_parms_stateDown3L7")->second.c_str()));
+                bodyModel->setTargetAngle(EFF_LL7, getupStateDown3L7);
+                bodyModel->setTargetAngle(EFF_RL7, getupStateDown3L7);
             }
 
             if (fallTimeWait < 0) {
                 fallTimeWait = worldModel->getTime();
             }
 
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateDown3MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateDown3MinTime) {
                 fallState = 4;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -178,15 +227,15 @@ bool NaoBehavior::checkingFall() {
                 currentFallStateStartTime = worldModel->getTime();
             }
 
-            bodyModel->setTargetAngle(EFF_LL1, atof(namedParams.find("getup_parms_stateDown5L1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL1, atof(namedParams.find("getup_parms_stateDown5L1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL1, getupStateDown5L1);
+            bodyModel->setTargetAngle(EFF_RL1, getupStateDown5L1);
 
             bodyModel->setTargetAngle(EFF_LL5, 0);
             bodyModel->setTargetAngle(EFF_RL5, 0);
 
             if (bodyModel->hasToe()) {
-                bodyModel->setTargetAngle(EFF_LL7, atof(namedParams.find("getup_parms_stateDown5L7")->second.c_str()));
-                bodyModel->setTargetAngle(EFF_RL7, atof(namedParams.find("getup_parms_stateDown5L7")->second.c_str()));
+                bodyModel->setTargetAngle(EFF_LL7, getupStateDown5L7);
+                bodyModel->setTargetAngle(EFF_RL7, getupStateDown5L7);
             }
 
 
@@ -194,7 +243,7 @@ bool NaoBehavior::checkingFall() {
                 fallTimeWait = worldModel->getTime();
             }
 
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateDown5MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateDown5MinTime) {
                 fallState = 6;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -218,22 +267,22 @@ bool NaoBehavior::checkingFall() {
                 currentFallStateStartTime = worldModel->getTime();
             }
 
-            bodyModel->setTargetAngle(EFF_LL1, atof(namedParams.find("getup_parms_stateDown7L1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL1, atof(namedParams.find("getup_parms_stateDown7L1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL1, getupStateDown7L1);
+            bodyModel->setTargetAngle(EFF_RL1, getupStateDown7L1);
 
-            bodyModel->setTargetAngle(EFF_LL3, atof(namedParams.find("getup_parms_stateDown7L3")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL3, atof(namedParams.find("getup_parms_stateDown7L3")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL3, getupStateDown7L3);
+            bodyModel->setTargetAngle(EFF_RL3, getupStateDown7L3);
 
             if (bodyModel->hasToe()) {
-                bodyModel->setTargetAngle(EFF_LL7, atof(namedParams.find("getup_parms_stateDown7L7")->second.c_str()));
-                bodyModel->setTargetAngle(EFF_RL7, atof(namedParams.find("getup_parms_stateDown7L7")->second.c_str()));
+                bodyModel->setTargetAngle(EFF_LL7, getupStateDown7L7);
+                bodyModel->setTargetAngle(EFF_RL7, getupStateDown7L7);
             }
 
             if (fallTimeWait < 0) {
                 fallTimeWait = worldModel->getTime();
             }
 
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateDown7MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateDown7MinTime) {
                 fallState = 8;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -266,7 +315,7 @@ bool NaoBehavior::checkingFall() {
                 fallTimeWait = worldModel->getTime();
             }
 
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateDown10MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateDown10MinTime) {
                 fallState = 10;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -308,28 +357,28 @@ bool NaoBehavior::checkingFall() {
                 currentFallStateStartTime = worldModel->getTime();
             }
 
-            bodyModel->setTargetAngle(EFF_LA1, atof(namedParams.find("getup_parms_stateUp3A1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RA1, atof(namedParams.find("getup_parms_stateUp3A1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LA1, getupStateUp3A1);
+            bodyModel->setTargetAngle(EFF_RA1, getupStateUp3A1);
 
-            bodyModel->setTargetAngle(EFF_LA2, atof(namedParams.find("getup_parms_stateUp3A2")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RA2, -atof(namedParams.find("getup_parms_stateUp3A2")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LA2, getupStateUp3A2);
+            bodyModel->setTargetAngle(EFF_RA2, -getupStateUp3A2);
 
-            bodyModel->setTargetAngle(EFF_LA4, atof(namedParams.find("getup_parms_stateUp3A4")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RA4, -atof(namedParams.find("getup_parms_stateUp3A4")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LA4, getupStateUp3A4);
+            bodyModel->setTargetAngle(EFF_RA4, -getupStateUp3A4);
 
-            bodyModel->setTargetAngle(EFF_LL3, atof(namedParams.find("getup_parms_stateUp3L3")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL3, atof(namedParams.find("getup_parms_stateUp3L3")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL3, getupStateUp3L3);
+            bodyModel->setTargetAngle(EFF_RL3, getupStateUp3L3);
 
             if (bodyModel->hasToe()) {
-                bodyModel->setTargetAngle(EFF_LL7, atof(namedParams.find("getup_parms_stateUp3L7")->second.c_str()));
-                bodyModel->setTargetAngle(EFF_RL7, atof(namedParams.find("getup_parms_stateUp3L7")->second.c_str()));
+                bodyModel->setTargetAngle(EFF_LL7, getupStateUp3L7);
+                bodyModel->setTargetAngle(EFF_RL7, getupStateUp3L7);
             }
 
             if (fallTimeWait < 0) {
                 fallTimeWait = worldModel->getTime();
             }
 
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateUp3MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateUp3MinTime) {
                 fallState = 4;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -354,19 +403,19 @@ bool NaoBehavior::checkingFall() {
                 currentFallStateStartTime = worldModel->getTime();
             }
 
-            bodyModel->setTargetAngle(EFF_LL3, atof(namedParams.find("getup_parms_stateUp5L3")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL3, atof(namedParams.find("getup_parms_stateUp5L3")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL3, getupStateUp5L3);
+            bodyModel->setTargetAngle(EFF_RL3, getupStateUp5L3);
 
             if (bodyModel->hasToe()) {
-                bodyModel->setTargetAngle(EFF_LL7, atof(namedParams.find("getup_parms_stateUp5L7")->second.c_str()));
-                bodyModel->setTargetAngle(EFF_RL7, atof(namedParams.find("getup_parms_stateUp5L7")->second.c_str()));
+                bodyModel->setTargetAngle(EFF_LL7, getupStateUp5L7);
+                bodyModel->setTargetAngle(EFF_RL7, getupStateUp5L7);
             }
 
             if (fallTimeWait < 0) {
                 fallTimeWait = worldModel->getTime();
             }
 
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateUp5MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateUp5MinTime) {
                 fallState = 6;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -397,19 +446,19 @@ bool NaoBehavior::checkingFall() {
             bodyModel->setTargetAngle(EFF_LA2, 0);
             bodyModel->setTargetAngle(EFF_RA2, 0);
 
-            bodyModel->setTargetAngle(EFF_LL1, atof(namedParams.find("getup_parms_stateUp7L1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL1, atof(namedParams.find("getup_parms_stateUp7L1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL1, getupStateUp7L1);
+            bodyModel->setTargetAngle(EFF_RL1, getupStateUp7L1);
 
             if (bodyModel->hasToe()) {
-                bodyModel->setTargetAngle(EFF_LL7, atof(namedParams.find("getup_parms_stateUp7L7")->second.c_str()));
-                bodyModel->setTargetAngle(EFF_RL7, atof(namedParams.find("getup_parms_stateUp7L7")->second.c_str()));
+                bodyModel->setTargetAngle(EFF_LL7, getupStateUp7L7);
+                bodyModel->setTargetAngle(EFF_RL7, getupStateUp7L7);
             }
 
             if (fallTimeWait < 0) {
                 fallTimeWait = worldModel->getTime();
             }
 
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateUp7MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateUp7MinTime) {
                 fallState = 8;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -435,31 +484,31 @@ bool NaoBehavior::checkingFall() {
                 currentFallStateStartTime = worldModel->getTime();
             }
 
-            bodyModel->setTargetAngle(EFF_LA1, atof(namedParams.find("getup_parms_stateUp9A1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RA1, atof(namedParams.find("getup_parms_stateUp9A1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LA1, getupStateUp9A1);
+            bodyModel->setTargetAngle(EFF_RA1, getupStateUp9A1);
 
-            bodyModel->setTargetAngle(EFF_LL1, atof(namedParams.find("getup_parms_stateUp9L1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL1, atof(namedParams.find("getup_parms_stateUp9L1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL1, getupStateUp9L1);
+            bodyModel->setTargetAngle(EFF_RL1, getupStateUp9L1);
 
-            bodyModel->setTargetAngle(EFF_LL4, atof(namedParams.find("getup_parms_stateUp9L4")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL4, atof(namedParams.find("getup_parms_stateUp9L4")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL4, getupStateUp9L4);
+            bodyModel->setTargetAngle(EFF_RL4, getupStateUp9L4);
 
-            bodyModel->setTargetAngle(EFF_LL5, atof(namedParams.find("getup_parms_stateUp9L5")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL5, atof(namedParams.find("getup_parms_stateUp9L5")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL5, getupStateUp9L5);
+            bodyModel->setTargetAngle(EFF_RL5, getupStateUp9L5);
 
-            bodyModel->setTargetAngle(EFF_LL6, atof(namedParams.find("getup_parms_stateUp9L6")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL6, -atof(namedParams.find("getup_parms_stateUp9L6")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL6, getupStateUp9L6);
+            bodyModel->setTargetAngle(EFF_RL6, -getupStateUp9L6);
 
             if (bodyModel->hasToe()) {
-                bodyModel->setTargetAngle(EFF_LL7, atof(namedParams.find("getup_parms_stateUp9L7")->second.c_str()));
-                bodyModel->setTargetAngle(EFF_RL7, atof(namedParams.find("getup_parms_stateUp9L7")->second.c_str()));
+                bodyModel->setTargetAngle(EFF_LL7, getupStateUp9L7);
+                bodyModel->setTargetAngle(EFF_RL7, getupStateUp9L7);
             }
 
             if (fallTimeWait < 0) {
                 fallTimeWait = worldModel->getTime();
             }
 
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateUp9MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateUp9MinTime) {
                 fallState = 10;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -484,25 +533,25 @@ bool NaoBehavior::checkingFall() {
                 currentFallStateStartTime = worldModel->getTime();
             }
 
-            bodyModel->setTargetAngle(EFF_LA1, atof(namedParams.find("getup_parms_stateUp11A1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RA1, atof(namedParams.find("getup_parms_stateUp11A1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LA1, getupStateUp11A1);
+            bodyModel->setTargetAngle(EFF_RA1, getupStateUp11A1);
 
-            bodyModel->setTargetAngle(EFF_LL1, atof(namedParams.find("getup_parms_stateUp11L1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL1, atof(namedParams.find("getup_parms_stateUp11L1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL1, getupStateUp11L1);
+            bodyModel->setTargetAngle(EFF_RL1, getupStateUp11L1);
 
-            bodyModel->setTargetAngle(EFF_LL5, atof(namedParams.find("getup_parms_stateUp11L5")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL5, atof(namedParams.find("getup_parms_stateUp11L5")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL5, getupStateUp11L5);
+            bodyModel->setTargetAngle(EFF_RL5, getupStateUp11L5);
 
             if (bodyModel->hasToe()) {
-                bodyModel->setTargetAngle(EFF_LL7, atof(namedParams.find("getup_parms_stateUp11L7")->second.c_str()));
-                bodyModel->setTargetAngle(EFF_RL7, atof(namedParams.find("getup_parms_stateUp11L7")->second.c_str()));
+                bodyModel->setTargetAngle(EFF_LL7, getupStateUp11L7);
+                bodyModel->setTargetAngle(EFF_RL7, getupStateUp11L7);
             }
 
             if (fallTimeWait < 0) {
                 fallTimeWait = worldModel->getTime();
             }
 
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateUp11MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateUp11MinTime) {
                 fallState = 12;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -527,24 +576,24 @@ bool NaoBehavior::checkingFall() {
                 currentFallStateStartTime = worldModel->getTime();
             }
 
-            bodyModel->setTargetAngle(EFF_LA1, atof(namedParams.find("getup_parms_stateUp13A1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RA1, atof(namedParams.find("getup_parms_stateUp13A1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LA1, getupStateUp13A1);
+            bodyModel->setTargetAngle(EFF_RA1, getupStateUp13A1);
 
-            bodyModel->setTargetAngle(EFF_LL1, atof(namedParams.find("getup_parms_stateUp13L1")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL1, atof(namedParams.find("getup_parms_stateUp13L1")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL1, getupStateUp13L1);
+            bodyModel->setTargetAngle(EFF_RL1, getupStateUp13L1);
 
-            bodyModel->setTargetAngle(EFF_LL3, atof(namedParams.find("getup_parms_stateUp13L3")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL3, atof(namedParams.find("getup_parms_stateUp13L3")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL3, getupStateUp13L3);
+            bodyModel->setTargetAngle(EFF_RL3, getupStateUp13L3);
 
-            bodyModel->setTargetAngle(EFF_LL4, atof(namedParams.find("getup_parms_stateUp13L4")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL4, atof(namedParams.find("getup_parms_stateUp13L4")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL4, getupStateUp13L4);
+            bodyModel->setTargetAngle(EFF_RL4, getupStateUp13L4);
 
-            bodyModel->setTargetAngle(EFF_LL5, atof(namedParams.find("getup_parms_stateUp13L5")->second.c_str()));
-            bodyModel->setTargetAngle(EFF_RL5, atof(namedParams.find("getup_parms_stateUp13L5")->second.c_str()));
+            bodyModel->setTargetAngle(EFF_LL5, getupStateUp13L5);
+            bodyModel->setTargetAngle(EFF_RL5, getupStateUp13L5);
 
             if (bodyModel->hasToe()) {
-                bodyModel->setTargetAngle(EFF_LL7, atof(namedParams.find("getup_parms_stateUp13L7")->second.c_str()));
-                bodyModel->setTargetAngle(EFF_RL7, atof(namedParams.find("getup_parms_stateUp13L7")->second.c_str()));
+                bodyModel->setTargetAngle(EFF_LL7, getupStateUp13L7);
+                bodyModel->setTargetAngle(EFF_RL7, getupStateUp13L7);
             }
 
             if (fallTimeWait < 0) {
@@ -552,7 +601,7 @@ bool NaoBehavior::checkingFall() {
             }
 
             //      if(bodyModel->targetsReached()){
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateUp13MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateUp13MinTime) {
                 fallState = 14;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -586,7 +635,7 @@ bool NaoBehavior::checkingFall() {
                 fallTimeWait = worldModel->getTime();
             }
 
-            if(worldModel->getTime() - currentFallStateStartTime > atof(namedParams.find("getup_parms_stateUp15MinTime")->second.c_str())) {
+            if(worldModel->getTime() - currentFallStateStartTime > getupStateUp15MinTime) {
                 fallState = 16;
                 currentFallStateStartTime = -1.0;
                 fallTimeStamp = worldModel->getTime();
@@ -3,11 +3,11 @@
 GazeboBehavior::
 GazeboBehavior( const std::string teamName,
                 int uNum,
-                const map<string, string>& namedParams_,
+                const ParamRegistry& params_,
                 const string& rsg_)
     : NaoBehavior( teamName,
                    uNum,
-                   namedParams_,
+                   params_,
                    rsg_) {
 }
 
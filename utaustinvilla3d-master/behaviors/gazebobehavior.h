@@ -6,7 +6,7 @@
 class GazeboBehavior : public NaoBehavior {
 public:
 
-    GazeboBehavior(const std::string teamName, int uNum, const map<string, string>& namedParams_, const string& rsg_);
+    GazeboBehavior(const std::string teamName, int uNum, const ParamRegistry& params_, const string& rsg_);
 
     virtual void beam( double& beamX, double& beamY, double& beamAngle );
     virtual SkillType selectSkill();
@@ -2,21 +2,35 @@
 #include <list>
 #include <algorithm>
 #include "../rvdraw/rvdraw.h"
+#include "../math/affine3f.h"
 
 #include <sys/time.h>
 
 extern int agentBodyType;
 
-// The names of important kicking parameters
-const string& ANGLE = "angle";
-const string& CW_ANGLE_THRESH = "cw_angle_thresh";
-const string& CCW_ANGLE_THRESH = "ccw_angle_thresh";
-const string& OFFSET_X = "xoffset";
-const string& OFFSET_Y = "yoffset";
-const string& BOUNDING_BOX_RIGHT = "max_displacement_right"; // Right and left are flipped for right legged kicks
-const string& BOUNDING_BOX_LEFT = "max_displacement_left";
-const string& BOUNDING_BOX_TOP = "max_displacement_top";
-const string& BOUNDING_BOX_BOTTOM = "max_displacement_bottom";
+// The names of important kicking parameters, in the order of KickParameter
+static const char* kickParameterNames[] = {
+    "angle",
+    "cw_angle_thresh",
+    "ccw_angle_thresh",
+    "xoffset",
+    "yoffset",
+    "max_displacement_right",
+    "max_displacement_left",
+    "max_displacement_top",
+    "max_displacement_bottom"
+};
+
+static const Param dribTarget("drib_target");
+static const Param dribCollThresh("drib_coll_thresh");
+static const Param approachNavBallAngle("kick_gen_approach_navBallAngle");
+static const Param approachNavBallDist("kick_gen_approach_navBallDist");
+static const Param approachNavBallCollision("kick_gen_approach_navBallCollision");
+static const Param approachTurnDist("kick_gen_approach_turnDist");
+static const Param approachMaxDecelX("kick_gen_approach_maxDecelX");
+static const Param approachMaxDecelY("kick_gen_approach_maxDecelY");
+static const Param approachBuff("kick_gen_approach_buff");
+static const Param approachEstVelCorrection("kick_gen_approach_estVelCorrection");
 
 
 /*
@@ -30,7 +44,7 @@ SkillType NaoBehavior::kickBall(const int kickTypeToUse, const VecPosition &targ
 
     if (me.getDistanceTo(ball) > 1) {
         // Far away from the ball so walk toward target offset from the ball
-        VecPosition approachBallTarget = ball - kickDirection*atof(namedParams.find("drib_target")->second.c_str());
+        VecPosition approachBallTarget = ball - kickDirection*dribTarget;
         return goToTarget(approachBallTarget);
     }
 
@@ -41,25 +55,94 @@ SkillType NaoBehavior::kickBall(const int kickTypeToUse, const VecPosition &targ
 /*Computes an estimated cost of reaching the appropriate position to execute a kick
   */
 double NaoBehavior::computeKickCost(VecPosition target, SkillType kickType) {
-    const double TURN_PENALTY = .5;
-    double angle = getStdNameParameter(kickType, ANGLE);
-
-    VecPosition x_vec = (target - ball).normalize();
-    VecPosition y_vec = x_vec.rotateAboutZ(-90);
+    double cost;
+    computeKickCosts(&target, 1, &kickType, 1, &cost);
+    return cost;
+}
 
-    VecPosition offX = x_vec * getStdNameParameter(kickType, OFFSET_X);
-    VecPosition offY = y_vec * (isRightSkill(kickType) ? -1 : 1) * getStdNameParameter(kickType, OFFSET_Y);
-    VecPosition stand_pos = ball + offX + offY;
-    SIM::AngDeg walkRotation = abs(x_vec.getTheta() + angle - worldModel->getMyAngDeg());
-    if (walkRotation > 180.0) {
-        walkRotation -= 180.0;
+/*
+ * Computes the kick cost of every pair of numTargets targets and numKicks
+ * kick skills: costs[k * numTargets + t] is the estimated cost of reaching
+ * the position to kick at targets[t] with kicks[k].
+ *
+ * The cost is the distance to the kick's standing position, plus a penalty
+ * for the turn needed to face the target and another if the ball is in the
+ * way.  The kick parameters are looked up once per call and the direction
+ * to each target once for all kicks, then targets are scored four at a
+ * time in float lanes, so behaviors can afford to sample many candidate
+ * targets every cycle.
+ */
+void NaoBehavior::computeKickCosts(const VecPosition *targets, int numTargets,
+                                   const SkillType *kicks, int numKicks, double *costs) {
+    using namespace affine3f_detail;
+    const float TURN_PENALTY = .5;
+    const float BALL_IN_PATH_PENALTY = .5;
+
+    // Angle, forward offset and (leg signed) sideways offset of each kick
+    vector<float> kickValues(3 * numKicks);
+    for (int k = 0; k < numKicks; k++) {
+        kickValues[3 * k] = getStdNameParameter(kicks[k], ANGLE);
+        kickValues[3 * k + 1] = getStdNameParameter(kicks[k], OFFSET_X);
+        kickValues[3 * k + 2] = (isRightSkill(kicks[k]) ? -1 : 1) * getStdNameParameter(kicks[k], OFFSET_Y);
     }
-    double cost = me.getDistanceTo(stand_pos) + walkRotation / 180.0 * TURN_PENALTY;
-    bool ballInPath =  abs(VecPosition(0, 0, 0).getAngleBetweenPoints(stand_pos - ball, me - ball)) > 90;
-    if (ballInPath) {
-        cost += .5;
+
+    const Lanes ballX = splat(ball.getX());
+    const Lanes ballY = splat(ball.getY());
+    const Lanes ballZ = splat(ball.getZ());
+    const Lanes meX = sub(splat(me.getX()), ballX);
+    const Lanes meY = sub(splat(me.getY()), ballY);
+    const Lanes meZ = sub(splat(me.getZ()), ballZ);
+    const Lanes halfTurn = splat(180);
+    const Lanes zero = splat(0);
+    const double myAngle = worldModel->getMyAngDeg();
+
+    for (int t = 0; t < numTargets; t += 4) {
+        // Unit direction from the ball to each target, the last target
+        // repeated to fill the lanes past the end
+        float dirX[4], dirY[4], dirZ[4], turn[4];
+        for (int i = 0; i < 4; i++) {
+            VecPosition dir = (targets[min(t + i, numTargets - 1)] - ball).normalize();
+            dirX[i] = dir.getX();
+            dirY[i] = dir.getY();
+            dirZ[i] = dir.getZ();
+            turn[i] = dir.getTheta() - myAngle;
+        }
+        const Lanes dx = load(dirX);
+        const Lanes dy = load(dirY);
+        const Lanes dz = load(dirZ);
+        const Lanes dTurn = load(turn);
+
+        for (int k = 0; k < numKicks; k++) {
+            const Lanes offX = splat(kickValues[3 * k + 1]);
+            const Lanes offY = splat(kickValues[3 * k + 2]);
+
+            // Standing position relative to the ball: offX along the
+            // direction and offY along it turned 90 degrees counterclockwise
+            Lanes standX = sub(mul(dx, offX), mul(dy, offY));
+            Lanes standY = add(mul(dy, offX), mul(dx, offY));
+            Lanes standZ = mul(dz, add(offX, offY));
+
+            Lanes toStandX = sub(meX, standX);
+            Lanes toStandY = sub(meY, standY);
+            Lanes toStandZ = sub(meZ, standZ);
+            Lanes cost = sqrt(add(add(mul(toStandX, toStandX), mul(toStandY, toStandY)), mul(toStandZ, toStandZ)));
+
+            Lanes walkRotation = abs(add(dTurn, splat(kickValues[3 * k])));
+            walkRotation = sub(walkRotation, ifLess(halfTurn, walkRotation, halfTurn));
+            cost = add(cost, mul(walkRotation, splat(TURN_PENALTY / 180)));
+
+            // The ball is in the way when we and the standing position are
+            // on opposite sides of it
+            Lanes dot = add(add(mul(standX, meX), mul(standY, meY)), mul(standZ, meZ));
+            cost = add(cost, ifLess(dot, zero, splat(BALL_IN_PATH_PENALTY)));
+
+            float laneCosts[4];
+            store(laneCosts, cost);
+            for (int i = 0; i < 4 && t + i < numTargets; i++) {
+                costs[k * numTargets + t + i] = laneCosts[i];
+            }
+        }
     }
-    return cost;
 }
 
 /**
@@ -92,14 +175,14 @@ SkillType NaoBehavior::kickBallAtPresetTarget() {
         SkillType kick_array[2];
         getSkillsForKickType(kickType, kick_array);
         const int NUM_KICKS = sizeof(kick_array)/sizeof(SkillType);
+        double kickCosts[NUM_KICKS];
+        computeKickCosts(&kickTarget, 1, kick_array, NUM_KICKS, kickCosts);
         double lowestKickCost = 99999999;
         SkillType kickSkill = kick_array[0];
         for (int k = 0; k < NUM_KICKS; k++) {
-            SkillType kick = kick_array[k];
-            double kickCost = computeKickCost(kickTarget, kick);
-            if (kickCost < lowestKickCost) {
-                lowestKickCost = kickCost;
-                kickSkill = kick;
+            if (kickCosts[k] < lowestKickCost) {
+                lowestKickCost = kickCosts[k];
+                kickSkill = kick_array[k];
             }
         }
 
@@ -152,15 +235,15 @@ SkillType NaoBehavior::kickBallAtPresetTarget() {
 
         VecPosition ballTarget = ball;
 
-        target = ballTarget - (VecPosition(kickDirection)  * atof(namedParams.find("drib_target")->second.c_str()));
+        target = ballTarget - (VecPosition(kickDirection)  * dribTarget);
         target.setZ(0);
 
         VecPosition originalTarget = target;
-        target = navigateAroundBall(target, .5 /*PROXIMITY_TRESH*/,atof(namedParams.find("drib_coll_thresh")->second.c_str()));
+        target = navigateAroundBall(target, .5 /*PROXIMITY_TRESH*/,dribCollThresh);
         target = collisionAvoidance(true /*Avoid teamate*/, false /*Avoid opponent*/, false /*Avoid ball*/, .5, .5, target,
                                     false /*fKeepDistance*/);
         target = collisionAvoidance(false /*Avoid teamate*/, false /*Avoid opponent*/, true /*Avoid ball*/, .5 /*PROXIMITY_TRESH*/,
-                                    atof(namedParams.find("drib_coll_thresh")->second.c_str()), target);
+                                    dribCollThresh, target);
         VecPosition localTarget = worldModel->g2l(target);
         SIM::AngDeg localTargetAngle = atan2Deg(localTarget.getY(), localTarget.getX());
         //cout << "CIRCLE\t" << worldModel->getGameTime() << "\n";
@@ -262,15 +345,15 @@ SkillType NaoBehavior::kickBallAtTargetSimplePositioning(const VecPosition &targ
     VecPosition targetLoc = worldModel->g2l(stand_pos);
     double walkSpeed = 1;
 
-    if (ball.getAngleBetweenPoints(stand_pos, me) >= atof(namedParams.find("kick_gen_approach_navBallAngle")->second.c_str())) { // If we're not behind the ball, consider navigating around it
-        double navBallDist = atof(namedParams.find("kick_gen_approach_navBallDist")->second.c_str());
-        targetLoc = worldModel->g2l(navigateAroundBall(stand_pos, navBallDist, atof(namedParams.find("kick_gen_approach_navBallCollision")->second.c_str())));
+    if (ball.getAngleBetweenPoints(stand_pos, me) >= approachNavBallAngle) { // If we're not behind the ball, consider navigating around it
+        double navBallDist = approachNavBallDist;
+        targetLoc = worldModel->g2l(navigateAroundBall(stand_pos, navBallDist, approachNavBallCollision));
     }
 
     SIM::AngDeg walkDirection = targetLoc.getTheta();
     targetLoc.setZ(0);
 
-    if (me.getDistanceTo(stand_pos) > atof(namedParams.find("kick_gen_approach_turnDist")->second.c_str())) { // Face toward stand_pos (to facilitate walking to it) until close enough. Then face the correct angle.
+    if (me.getDistanceTo(stand_pos) > approachTurnDist) { // Face toward stand_pos (to facilitate walking to it) until close enough. Then face the correct angle.
         VecPosition localStandPos = worldModel->g2l(stand_pos);
         localStandPos.setZ(0);
         SIM::AngDeg localSPAngle = atan2Deg(localStandPos.getY(), localStandPos.getX());
@@ -282,14 +365,14 @@ SkillType NaoBehavior::kickBallAtTargetSimplePositioning(const VecPosition &targ
 
     const double MPS_SCALE = 43.674733875; // multiply particle filter's velocity estimate by this to get m/s
     /*const*/
-    double MAX_DECEL_X = atof(namedParams.find("kick_gen_approach_maxDecelX")->second.c_str()); // m/s^2
-    const double MAX_DECEL_Y = atof(namedParams.find("kick_gen_approach_maxDecelY")->second.c_str()); //m/s^2 // TODO: The command getWalk(90, 0, 1) doesn't actually cause the robot to walk directly to the side...
+    double MAX_DECEL_X = approachMaxDecelX; // m/s^2
+    const double MAX_DECEL_Y = approachMaxDecelY; //m/s^2 // TODO: The command getWalk(90, 0, 1) doesn't actually cause the robot to walk directly to the side...
     const double MAX_VELOCITY_Y = 0.3;//core->motion_->getMaxYSpeed(); // m/s
     const double MAX_VELOCITY_X = 0.8;//core->motion_->getMaxXSpeed(); // m/s
     /*const*/
-    double BUFFER_DIST = atof(namedParams.find("kick_gen_approach_buff")->second.c_str()); // Try to stop this far behind the ball
+    double BUFFER_DIST = approachBuff; // Try to stop this far behind the ball
 
-    VecPosition estimatedVelocity = particleFilter->getOdometryDisplacementEstimateXY() * MPS_SCALE + atof(namedParams.find("kick_gen_approach_estVelCorrection")->second.c_str());
+    VecPosition estimatedVelocity = particleFilter->getOdometryDisplacementEstimateXY() * MPS_SCALE + approachEstVelCorrection;
 
     double theta = targetLoc.getTheta();
     if (targetLoc.getX() >= 0 && targetLoc.getY() >= 0) {
@@ -325,25 +408,29 @@ SkillType NaoBehavior::kickBallAtTargetSimplePositioning(const VecPosition &targ
 
 
 double NaoBehavior::getParameter(const string& name) {
-    return atof(namedParams.find(name)->second.c_str());
+    return params.get(name);
 }
 
-double NaoBehavior::getStdNameParameter(const SkillType kick_skill, const string& parameter) {
-    string prefix = "";
-    switch(kick_skill) {
-    case SKILL_KICK_IK_0_LEFT_LEG:
-    case SKILL_KICK_IK_0_RIGHT_LEG:
-        prefix = "kick_ik_0_";
-        break;
-    case SKILL_KICK_LEFT_LEG:
-    case SKILL_KICK_RIGHT_LEG:
-        prefix = "kick_";
-        break;
-    default:
+/*
+ * Looks up the handles of all kick parameters, so that reading them while
+ * kicking doesn't need to build and look up their names
+ */
+void NaoBehavior::initKickParameters() {
+    for (int skill = 0; skill < SKILL_NONE; skill++) {
+        const char* prefix = getSkillInfo(SkillType(skill)).paramPrefix;
+        for (int i = 0; i < NUM_KICK_PARAMETERS; i++) {
+            kickParameters[skill][i] = prefix == NULL ? NO_PARAM :
+                                       params.require(string(prefix) + kickParameterNames[i]);
+        }
+    }
+}
+
+double NaoBehavior::getStdNameParameter(const SkillType kick_skill, const KickParameter parameter) {
+    if (kick_skill >= SKILL_NONE || kickParameters[kick_skill][parameter] == NO_PARAM) {
         cerr << "Tried to get a parameter for unsupported kick: " + EnumParser<SkillType>::getStringFromEnum(kick_skill) << endl;
-        break;
+        return 0;
     }
-    return getParameter(prefix + parameter);
+    return params.get(kickParameters[kick_skill][parameter]);
 }
 
 void NaoBehavior::getSkillsForKickType(int kickType, SkillType skills[]) {
@@ -406,6 +493,6 @@ VecPosition NaoBehavior::navigateAroundBall(VecPosition target, double PROXIMITY
     }
 
     target = collisionAvoidance(true/*Avoid teammate*/,false/*Avoid opponent*/,false/*Avoid ball*/,.5,.5,target, false /*fKeepDistance*/);
-    target = collisionAvoidance(false/*Avoid teammate*/,false/*Avoid opponent*/,true/*Avoid ball*/,PROXIMITY_THRESH,atof(namedParams.find("drib_coll_thresh")->second.c_str()),target);
+    target = collisionAvoidance(false/*Avoid teammate*/,false/*Avoid opponent*/,true/*Avoid ball*/,PROXIMITY_THRESH,dribCollThresh,target);
     return target;
 }
@@ -0,0 +1,253 @@
+#include "naobehavior.h"
+#include "../rvdraw/rvdraw.h"
+
+#include <cstdlib>
+#include <sched.h>
+
+extern bool useMotionThread;
+
+/*
+ * Running motion on its own thread (--motionthread)
+ *
+ * The thread calling Think() becomes the motion thread.  Every cycle it
+ * parses just the joint and inertial perceptors into the UT Walk memory
+ * blocks, runs the walk engine and servos the joints, so the time it takes
+ * to answer the server does not depend on how long perception and strategy
+ * take.  Perception and strategy run on a separate behavior thread.  The
+ * two threads only talk through the lock-free behaviorInput and
+ * behaviorOutput buffers: the motion thread keeps applying the last walk
+ * request and joint targets it got until the behavior thread publishes new
+ * ones, so walk requests take effect one behavior cycle after the message
+ * they are based on.
+ *
+ * No message is lost when the behavior thread falls behind.  The motion
+ * thread copies every message, with the skill it executed that cycle,
+ * into a ring of MAX_PENDING_MOTION_CYCLES slots allocated up front and
+ * hands over only the number of the newest cycle, so it never allocates
+ * once running.  The behavior thread takes in the perceptors of every
+ * cycle it has not acknowledged through consumedMotionCycle and records
+ * each executed skill for odometry, and only decides what to do on the
+ * newest.  Should it fall so far behind that the ring is full, the motion
+ * thread counts the cycles it could not hand over and the behavior thread
+ * reports them.
+ */
+
+void NaoBehavior::startBehaviorThread() {
+    motionEffectors.clear();
+    for (int i = 0; i < EFF_NUM; i++) {
+        motionEffectors.push_back(bodyModel->getEffector(i));
+    }
+
+    // The behavior thread is started again after every reload, by which
+    // time the motion thread runs at real time priority, so it is given
+    // normal priority explicitly rather than inheriting it
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+    struct sched_param behaviorParam;
+    behaviorParam.sched_priority = 0;
+    pthread_attr_setschedparam(&attr, &behaviorParam);
+
+    sem_init(&behaviorWakeup, 0, 0);
+    fBehaviorThreadRunning = true;
+    if (pthread_create(&behaviorThread, &attr, &NaoBehavior::behaviorThreadMain, this) != 0) {
+        cerr << "Could not create behavior thread" << endl;
+        exit(1);
+    }
+    pthread_attr_destroy(&attr);
+
+    if (!fMotionThreadPriorityRaised) {
+        fMotionThreadPriorityRaised = true;
+        struct sched_param param;
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+            cerr << "Could not raise motion thread priority, running it at normal priority" << endl;
+        }
+    }
+}
+
+void NaoBehavior::stopBehaviorThread() {
+    if (!fBehaviorThreadRunning) {
+        return;
+    }
+    fBehaviorThreadRunning = false;
+    sem_post(&behaviorWakeup);
+    pthread_join(behaviorThread, NULL);
+    sem_destroy(&behaviorWakeup);
+}
+
+void* NaoBehavior::behaviorThreadMain(void *behavior) {
+    static_cast<NaoBehavior*>(behavior)->runBehaviorThread();
+    return NULL;
+}
+
+void NaoBehavior::runBehaviorThread() {
+    while (true) {
+        sem_wait(&behaviorWakeup);
+        if (!fBehaviorThreadRunning) {
+            break;
+        }
+
+        // Several wakeups may have piled up while we were busy, in which
+        // case the newest input has every cycle since and there is
+        // nothing new for the extra ones
+        if (!behaviorInput.update()) {
+            continue;
+        }
+
+        thinkBehavior(behaviorInput.readBuffer(), behaviorOutput.writeBuffer());
+        behaviorOutput.publish();
+    }
+}
+
+/*
+ * Takes in the cycles before the newest that the behavior thread has not
+ * seen yet, as Think() would have if it had kept up, acknowledging each
+ * once done with its slot.  The newest is left to thinkBehavior().
+ */
+void NaoBehavior::catchUpMotionCycles(const BehaviorInput& input) {
+    if (input.droppedMotionCycles != reportedDroppedMotionCycles) {
+        reportedDroppedMotionCycles = input.droppedMotionCycles;
+        cerr << "Behavior thread fell behind, dropped " << reportedDroppedMotionCycles << " messages" << endl;
+    }
+
+    unsigned long consumed = consumedMotionCycle.load(boost::memory_order_relaxed);
+    for (unsigned long seq = consumed + 1; seq < input.newestMotionCycle; seq++) {
+        const MotionCycle &cycle = motionCycles[seq % MAX_PENDING_MOTION_CYCLES];
+        fParsedVision = false;
+        parser->parse(cycle.message, fParsedVision);
+        updatePerception();
+        if (cycle.fExecuted) {
+            worldModel->addExecutedSkill(cycle.executedSkill);
+        }
+        consumedMotionCycle.store(seq, boost::memory_order_release);
+    }
+}
+
+/*
+ * One cycle of the behavior thread: everything Think() does when not
+ * running with a motion thread, except for what touches the memory blocks.
+ */
+void NaoBehavior::thinkBehavior(const BehaviorInput& input, BehaviorOutput& output) {
+
+    catchUpMotionCycles(input);
+    const MotionCycle &newest = motionCycles[input.newestMotionCycle % MAX_PENDING_MOTION_CYCLES];
+
+    fParsedVision = false;
+    parser->parse(newest.message, fParsedVision);
+    bool fNewestExecuted = newest.fExecuted;
+    SkillType newestExecutedSkill = newest.executedSkill;
+    consumedMotionCycle.store(input.newestMotionCycle, boost::memory_order_release);
+
+    // The walk engine's targets are what composeAction() would have left in
+    // the body model last cycle
+    if (bodyModel->useOmniWalk()) {
+        for (int i = 0; i < EFF_NUM; i++) {
+            if (i != EFF_H1 && i != EFF_H2) {
+                bodyModel->setTargetAngle(i, input.walkTargetAngle[i]);
+            }
+        }
+    }
+
+    output.fValid = true;
+    output.fMove = false;
+    output.action = "";
+    output.sayMessage = "";
+    output.fCompose = updateBehaviorState(output.action);
+    if (fNewestExecuted) {
+        worldModel->addExecutedSkill(newestExecutedSkill);
+    }
+
+    output.executedSkill = SKILL_NONE;
+    if (output.fCompose) {
+        // act() calls requestWalk() which fills in the walk request
+        act();
+        output.executedSkill = executedSkill;
+
+        worldModel->getRVSender()->refresh();
+
+        output.useOmniWalk = bodyModel->useOmniWalk();
+        for (int i = 0; i < EFF_NUM; i++) {
+            output.targetAngle[i] = bodyModel->getTargetAngle(i);
+            output.scale[i] = bodyModel->getScale(i);
+        }
+        output.sayMessage = composeSayMessage();
+    }
+
+    output.monMsg = monMsg;
+    monMsg = "";
+}
+
+/*
+ * One cycle of the motion thread
+ */
+string NaoBehavior::thinkMotion(const std::string& message) {
+
+    if (!fBehaviorThreadRunning) {
+        startBehaviorThread();
+    }
+
+    bool fParsedVisionIgnored = false;
+    motionParser->parse(message, fParsedVisionIgnored);
+    senseMotionEffectors();
+    processJointBlocks();
+
+    bool fNewDecision = behaviorOutput.update();
+    const BehaviorOutput &decision = behaviorOutput.readBuffer();
+
+    // Hand the message over to the behavior thread, with what this cycle
+    // goes on executing, unless its slot still holds a cycle the behavior
+    // thread has not acknowledged.  Nothing new is published then, so the
+    // behavior thread only ever reads slots the motion thread is done with.
+    unsigned long consumed = consumedMotionCycle.load(boost::memory_order_acquire);
+    if (nextMotionCycle - consumed > MAX_PENDING_MOTION_CYCLES) {
+        droppedMotionCycles++;
+    } else {
+        MotionCycle &cycle = motionCycles[nextMotionCycle % MAX_PENDING_MOTION_CYCLES];
+        cycle.message.assign(message.data(), message.size());
+        cycle.fExecuted = decision.fValid && decision.fCompose && decision.executedSkill != SKILL_NONE;
+        cycle.executedSkill = decision.executedSkill;
+
+        BehaviorInput &input = behaviorInput.writeBuffer();
+        input.newestMotionCycle = nextMotionCycle++;
+        input.droppedMotionCycles = droppedMotionCycles;
+        getMotionWalkTargets(input.walkTargetAngle);
+        behaviorInput.publish();
+        sem_post(&behaviorWakeup);
+    }
+
+    if (!decision.fValid) {
+        return "";
+    }
+
+    frame_info_->frame_id++;
+    if (decision.fMove) {
+        core->move(decision.walkRequest.paramSet, decision.walkRequest.x, decision.walkRequest.y, decision.walkRequest.rot);
+    }
+
+    string action;
+    if (fNewDecision) {
+        action = decision.action;
+        motionMonMsg = decision.monMsg;
+    }
+    if (decision.fCompose) {
+        action += composeMotionAction(decision);
+        if (fNewDecision) {
+            action += decision.sayMessage;
+        }
+    }
+
+    return action;
+}
+
+void NaoBehavior::requestWalk(WalkRequestBlock::ParamSet paramSet, double x, double y, double rot) {
+    if (useMotionThread) {
+        // Called from act() on the behavior thread, which owns the write buffer
+        BehaviorOutput &output = behaviorOutput.writeBuffer();
+        output.fMove = true;
+        output.walkRequest = WalkVelocity(paramSet, x, y, rot);
+    } else {
+        core->move(paramSet, x, y, rot);
+    }
+}
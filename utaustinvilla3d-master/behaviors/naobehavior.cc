@@ -15,14 +15,15 @@
 #include <motion/MotionModule.h>
 
 extern int agentBodyType;
+extern bool useMotionThread;
 
 
 /*
- * namedParams_ are a mapping between parameters and their values
+ * params_ are the parameters loaded from the parameter files
  */
 NaoBehavior::
-NaoBehavior(const std::string teamName, int uNum, const map<string, string>& namedParams_, const string& rsg_) :
-    namedParams( namedParams_ ),
+NaoBehavior(const std::string teamName, int uNum, const ParamRegistry& params_, const string& rsg_) :
+    params( params_ ),
     rsg( rsg_ )
 {
 
@@ -47,17 +48,17 @@ NaoBehavior(const std::string teamName, int uNum, const map<string, string>& nam
 
     memory_ = new Memory(false,true);
 
-    memory_->getOrAddBlockByName(frame_info_,"frame_info");
-    memory_->getOrAddBlockByName(vision_frame_info_,"vision_frame_info");
+    memory_->getOrAddBlock<MB_FRAME_INFO>(frame_info_);
+    memory_->getOrAddBlock<MB_VISION_FRAME_INFO>(vision_frame_info_);
     frame_info_->source = MEMORY_SIM; // set to simulaor
     vision_frame_info_->source = MEMORY_SIM;
 
-    memory_->getOrAddBlockByName(raw_sensors_,"raw_sensors");
-    memory_->getOrAddBlockByName(raw_joint_angles_,"raw_joint_angles");
-    memory_->getOrAddBlockByName(processed_joint_angles_,"processed_joint_angles");
-    memory_->getOrAddBlockByName(raw_joint_commands_,"raw_joint_commands");
-    memory_->getOrAddBlockByName(processed_joint_commands_,"processed_joint_commands");
-    memory_->getOrAddBlockByName(sim_effectors_,"sim_effectors");
+    memory_->getOrAddBlock<MB_RAW_SENSORS>(raw_sensors_);
+    memory_->getOrAddBlock<MB_RAW_JOINT_ANGLES>(raw_joint_angles_);
+    memory_->getOrAddBlock<MB_PROCESSED_JOINT_ANGLES>(processed_joint_angles_);
+    memory_->getOrAddBlock<MB_RAW_JOINT_COMMANDS>(raw_joint_commands_);
+    memory_->getOrAddBlock<MB_PROCESSED_JOINT_COMMANDS>(processed_joint_commands_);
+    memory_->getOrAddBlock<MB_SIM_EFFECTORS>(sim_effectors_);
 
     core = new MotionCore(CORE_SIM, true, *memory_);
     fParsedVision = false;
@@ -67,7 +68,28 @@ NaoBehavior(const std::string teamName, int uNum, const map<string, string>& nam
                         vision_frame_info_,
                         frame_info_,
                         raw_joint_angles_,
-                        raw_sensors_ );
+                        raw_sensors_,
+                        useMotionThread ? Parser::PARSE_MODELS : Parser::PARSE_ALL );
+
+    motionParser = NULL;
+    fBehaviorThreadRunning = false;
+    nextMotionCycle = 1;
+    droppedMotionCycles = 0;
+    consumedMotionCycle = 0;
+    reportedDroppedMotionCycles = 0;
+    fMotionThreadPriorityRaised = false;
+    executedSkill = SKILL_NONE;
+    if (useMotionThread) {
+        for (int i = 0; i < MAX_PENDING_MOTION_CYCLES; i++) {
+            motionCycles[i].message.reserve(MOTION_CYCLE_MESSAGE_CAPACITY);
+        }
+        motionParser = new Parser(worldModel, bodyModel, teamName, particleFilter,
+                                  vision_frame_info_,
+                                  frame_info_,
+                                  raw_joint_angles_,
+                                  raw_sensors_,
+                                  Parser::PARSE_MEMORY_BLOCKS );
+    }
 
 
 
@@ -88,26 +110,7 @@ NaoBehavior(const std::string teamName, int uNum, const map<string, string>& nam
 
     monMsg = "";
 
-    // TODO: Treat paths more correctly? (system independent way)
-    try {
-        readSkillsFromFile( "./skills/stand.skl" );
-        readSkillsFromFile( "./skills/down.skl" );
-        readSkillsFromFile( "./skills/kick.skl" );
-
-        // ik skills
-        readSkillsFromFile( "./skills/kick_ik_0.skl" );
-        // end ik skills
-
-    }
-    catch( std::string& what ) {
-        cerr << "Exception caught: " << what << endl;
-        exit(1);
-    }
-    catch (std::exception& e)
-    {
-        cerr << e.what() << endl;
-        exit(1);
-    }
+    readSkills();
 
     // initialize just so reset Skill doesnt segfault
     skill = SKILL_STAND;
@@ -120,6 +123,8 @@ NaoBehavior(const std::string teamName, int uNum, const map<string, string>& nam
 
 NaoBehavior::~NaoBehavior() {
 
+    stopBehaviorThread();
+    delete motionParser;
     delete parser;
     delete worldModel;
     delete bodyModel;
@@ -140,6 +145,10 @@ string NaoBehavior::Think(const std::string& message) {
 
     //  cout << "(NaoBehavior) received message " << message << endl;
 
+    if (useMotionThread) {
+        return thinkMotion(message);
+    }
+
     fParsedVision = false;
     bool parseSuccess = parser->parse(message, fParsedVision);
     if(!parseSuccess && (worldModel->getPlayMode() != PM_BEFORE_KICK_OFF)) {
@@ -149,7 +158,50 @@ string NaoBehavior::Think(const std::string& message) {
     }
 
     //  cout << "\nparseSuccess: " << parseSuccess << "\n";
-    //  worldModel->display();
+    processJointBlocks();
+
+    string action;
+    if (!updateBehaviorState(action)) {
+        return action;
+    }
+
+    frame_info_->frame_id++;
+    act();
+
+    worldModel->getRVSender()->refresh();
+
+    action = action + composeAction();
+
+    //std::cout << "Sending action: " << action << "\n";
+    return action;
+}
+
+/*
+ * Prepares the sensor and joint memory blocks the walk engine reads for
+ * this frame.  Only touches memory blocks, never the world or body model.
+ */
+void NaoBehavior::processJointBlocks() {
+    calculateAngles();
+
+
+    if (frame_info_->start_time == -1) {
+        frame_info_->start_time = frame_info_->seconds_since_start;
+        vision_frame_info_->start_time = frame_info_->start_time;
+    }
+    frame_info_->seconds_since_start= frame_info_->seconds_since_start - frame_info_->start_time;
+
+    raw_joint_angles_->values_[RHipYawPitch] = raw_joint_angles_->values_[LHipYawPitch];
+
+    preProcessJoints();  // Apply the correct sign to the joint angles
+
+    postProcessJoints(); // Flip the joint angles back
+}
+
+/*
+ * Updates the body model, and the world model from vision if the message
+ * just parsed had any
+ */
+void NaoBehavior::updatePerception() {
     bodyModel->refresh();
     if(fParsedVision) {
         if (!worldModel->isFallen()) {
@@ -158,6 +210,17 @@ string NaoBehavior::Think(const std::string& message) {
             parser->processSightings(true /*fIgnoreVision*/);
         }
     }
+}
+
+/*
+ * Updates the world and body models from the message just parsed and takes
+ * care of initializing and beaming.  Returns false if the agent should not
+ * act this cycle, in which case action is the complete message to send.
+ */
+bool NaoBehavior::updateBehaviorState(string& action) {
+
+    //  worldModel->display();
+    updatePerception();
     this->updateFitness();
     //  bodyModel->display();
     //  bodyModel->displayDerived();
@@ -173,30 +236,13 @@ string NaoBehavior::Think(const std::string& message) {
     worldModel->getRVSender()->drawLine(pos.getX(), pos.getY(), pos.getX()+dir.getX(), pos.getY()+dir.getY());
     */
 
-    calculateAngles();
-
-
-    if (frame_info_->start_time == -1) {
-        frame_info_->start_time = frame_info_->seconds_since_start;
-        vision_frame_info_->start_time = frame_info_->start_time;
-    }
-    frame_info_->seconds_since_start= frame_info_->seconds_since_start - frame_info_->start_time;
-
-    raw_joint_angles_->values_[RHipYawPitch] = raw_joint_angles_->values_[LHipYawPitch];
-
-    preProcessJoints();  // Apply the correct sign to the joint angles
-
-    postProcessJoints(); // Flip the joint angles back
-
-    string action;
-
     if (!mInit) {
 
         mInit = true;
         stringstream ss;
         ss << "(init (unum " << agentUNum << ")(teamname " << agentTeamName << "))";
         action = ss.str();
-        return action;
+        return false;
     }
 
     if (worldModel->getLastPlayMode() != worldModel->getPlayMode() &&
@@ -233,7 +279,7 @@ string NaoBehavior::Think(const std::string& message) {
         if(!worldModel->getUNumSet() || !worldModel->getSideSet()) {
             //      cout << "UNum and side not received yet.\n";
             action = "";
-            return action;
+            return false;
         }
 
         if(!initBeamed) {
@@ -251,7 +297,7 @@ string NaoBehavior::Think(const std::string& message) {
             ss << "(beam " << beamX << " " << beamY << " " << beamAngle << ")";
             particleFilter->setForBeam(beamX, beamY, beamAngle);
             action = ss.str();
-            return action;
+            return false;
         }
         else {
             // Not Initialized
@@ -280,18 +326,11 @@ string NaoBehavior::Think(const std::string& message) {
         action = ss.str();
     }
 
-    frame_info_->frame_id++;
-    act();
-
-    worldModel->getRVSender()->refresh();
-
-    action = action + composeAction();
-
-    //std::cout << "Sending action: " << action << "\n";
-    return action;
+    return true;
 }
 
 void NaoBehavior::act() {
+    executedSkill = SKILL_NONE;
     refresh();
 
     const double LAST_LINE_SIGHTING_THRESH = 0.1;
@@ -322,7 +361,7 @@ void NaoBehavior::act() {
         }
         resetSkills();
         skill = SKILL_STAND;
-        core->move(0,0,0);
+        requestWalk(WalkRequestBlock::PARAMS_DEFAULT, 0, 0, 0);
         velocity.paramSet = WalkRequestBlock::PARAMS_DEFAULT;
     }
     else {
@@ -340,10 +379,10 @@ void NaoBehavior::act() {
             bodyModel->setUseOmniWalk(true);
             switch(currentSkill) {
             case SKILL_WALK_OMNI:
-                core->move(velocity.paramSet, velocity.x, velocity.y, velocity.rot);
+                requestWalk(velocity.paramSet, velocity.x, velocity.y, velocity.rot);
                 break;
             case SKILL_STAND:
-                core->move(0,0,0);
+                requestWalk(WalkRequestBlock::PARAMS_DEFAULT, 0, 0, 0);
                 break;
             default:
                 bodyModel->setUseOmniWalk(false);
@@ -373,11 +412,11 @@ void NaoBehavior::act() {
 
 
     worldModel->setLastSkill(skill);
-    // to be used by odometry
-    if (bodyModel->useOmniWalk()) {
-        worldModel->addExecutedSkill(SKILL_WALK_OMNI);
-    } else {
-        worldModel->addExecutedSkill( skill );
+    // to be used by odometry; with a motion thread it records what it
+    // executes every motion cycle instead
+    executedSkill = bodyModel->useOmniWalk() ? SKILL_WALK_OMNI : skill;
+    if (!useMotionThread) {
+        worldModel->addExecutedSkill( executedSkill );
     }
 
 
@@ -423,10 +462,102 @@ void NaoBehavior::act() {
 }
 
 
+/*
+ * Parses all skill files, substituting the current parameter values.
+ * Exits if a skill file can't be read or is missing a parameter.
+ */
+void NaoBehavior::readSkills() {
+    try {
+        readSkillFiles( params, skills );
+
+        initKickParameters();
+        walkSpeeds.build(params);
+
+    }
+    catch( std::string& what ) {
+        cerr << "Exception caught: " << what << endl;
+        exit(1);
+    }
+    catch (std::exception& e)
+    {
+        cerr << e.what() << endl;
+        exit(1);
+    }
+}
+
+/*
+ * Parses all skill files into skillsRead, substituting the values in
+ * skillParams.  Throws string if a skill file can't be read or is
+ * missing a parameter.
+ */
+void NaoBehavior::readSkillFiles( const ParamRegistry& skillParams, map< SkillType, boost::shared_ptr<Skill> >& skillsRead ) {
+    // TODO: Treat paths more correctly? (system independent way)
+    readSkillsFromFile( "./skills/stand.skl", skillParams, skillsRead );
+    readSkillsFromFile( "./skills/down.skl", skillParams, skillsRead );
+    readSkillsFromFile( "./skills/kick.skl", skillParams, skillsRead );
+
+    // ik skills
+    readSkillsFromFile( "./skills/kick_ik_0.skl", skillParams, skillsRead );
+    // end ik skills
+}
+
+/*
+ * Recompiles the skills from newParams and, if they compile, makes
+ * newParams the agent's parameters, rebuilds the kick parameter handles,
+ * walk speeds and walk parameter sets and starts over standing.  Called
+ * between messages, so with a motion thread the behavior thread is
+ * stopped before anything it reads changes; thinkMotion() starts it
+ * again on the next message.  Returns false with the old parameters and
+ * skills still in use if newParams can't be used.
+ */
+bool NaoBehavior::reloadParameters(const ParamRegistry& newParams) {
+    // Only reads newParams, so the behavior thread keeps running
+    map< SkillType, boost::shared_ptr<Skill> > newSkills;
+    try {
+        readSkillFiles( newParams, newSkills );
+    }
+    catch( std::string& what ) {
+        cerr << what << "; keeping the old parameters" << endl;
+        return false;
+    }
+    catch (std::exception& e)
+    {
+        cerr << e.what() << "; keeping the old parameters" << endl;
+        return false;
+    }
+
+    stopBehaviorThread();
+
+    // These read the agent's registry, which params refers to, and throw
+    // for a parameter they need that checkDeclared() doesn't know of
+    ParamRegistry oldParams(getParams());
+    getParams() = newParams;
+    try {
+        initKickParameters();
+        walkSpeeds.build(params);
+        core->reloadParameters();
+    }
+    catch( std::string& what ) {
+        cerr << what << "; keeping the old parameters" << endl;
+        getParams() = oldParams;
+        initKickParameters();
+        walkSpeeds.build(params);
+        core->reloadParameters();
+        return false;
+    }
+    skills.swap(newSkills);
+
+    skill = SKILL_STAND;
+    resetSkills();
+    resetKickState();
+    return true;
+}
+
 /*
  * Throws string
  */
-void NaoBehavior::readSkillsFromFile( const std::string& filename) {
+void NaoBehavior::readSkillsFromFile( const std::string& filename, const ParamRegistry& skillParams,
+                                      map< SkillType, boost::shared_ptr<Skill> >& skillsRead ) {
 //  cerr << "Loading skills from file " << filename << endl;
 
 
@@ -464,11 +595,11 @@ void NaoBehavior::readSkillsFromFile( const std::string& filename) {
                 ++i;
             }
 
-            map<string, string>::const_iterator it = namedParams.find( param );
-            if( it == namedParams.end() ) {
+            ParamID id = skillParams.find( param );
+            if( !skillParams.has( id ) ) {
                 throw "Missing parameter in skill file " + filename + ": " + param;
             }
-            skillDescription += it->second;
+            skillDescription += skillParams.getText( id );
 
             if( i < numRead )
                 skillDescription += buff[i];
@@ -485,7 +616,7 @@ void NaoBehavior::readSkillsFromFile( const std::string& filename) {
 
     // Parse
 
-    SkillParser parser( skills, bodyModel );
+    SkillParser parser( skillsRead, bodyModel );
     parse_info<iterator_t> info = parse( skillDescription.c_str(),
                                          parser,
                                          ( space_p | comment_p("#") )
@@ -516,13 +647,11 @@ void NaoBehavior::readSkillsFromFile( const std::string& filename) {
 
 
 bool NaoBehavior::isRightSkill( SkillType skill ) {
-    string skillStr = EnumParser<SkillType>::getStringFromEnum( skill );
-    return skillStr.find("RIGHT") != string::npos;
+    return getSkillInfo(skill).side == SIDE_RIGHT;
 }
 
 bool NaoBehavior::isLeftSkill( SkillType skill ) {
-    string skillStr = EnumParser<SkillType>::getStringFromEnum( skill );
-    return skillStr.find("LEFT") != string::npos;
+    return getSkillInfo(skill).side == SIDE_LEFT;
 }
 
 
@@ -610,26 +739,24 @@ VecPosition NaoBehavior::collisionAvoidance(bool avoidTeammate, bool avoidOppone
         }
     }
 
+    const PlayerIndex& players = worldModel->getPlayerIndex();
+
     // Avoid all of your teamates if flag is set
     if(avoidTeammate) {
-        for(int i = WO_TEAMMATE1; i <= WO_TEAMMATE11; ++i) {
+        for(int i = 0; i < players.getNumTeammates(); ++i) {
             // Skip ourself
-            if (worldModel->getUNum() == i - WO_TEAMMATE1 + 1) {
+            if (players.getTeammate(i).fSelf) {
                 continue;
             }
-            WorldObject* teammate = worldModel->getWorldObject( i );
-            if (teammate->validPosition == true) {
-                VecPosition temp = teammate->pos;
-                temp.setZ(0);
-                if (abs(me.getAngleBetweenPoints(target, temp)) < 90.0) {
-                    if (!fKeepDistance && me.getDistanceTo(temp) > me.getDistanceTo(target)) {
-                        continue;
-                    }
-                    double distance = me.getDistanceTo(temp);
-                    if (distance < closestObjDistance) {
-                        closestObjDistance = distance;
-                        closestObjPos = temp;
-                    }
+            VecPosition temp = players.getTeammate(i).pos;
+            if (abs(me.getAngleBetweenPoints(target, temp)) < 90.0) {
+                if (!fKeepDistance && me.getDistanceTo(temp) > me.getDistanceTo(target)) {
+                    continue;
+                }
+                double distance = me.getDistanceTo(temp);
+                if (distance < closestObjDistance) {
+                    closestObjDistance = distance;
+                    closestObjPos = temp;
                 }
             }
         }
@@ -638,18 +765,14 @@ VecPosition NaoBehavior::collisionAvoidance(bool avoidTeammate, bool avoidOppone
     // Avoid opponents if flag is set
     if(avoidOpponent) {
         if (closestObjDistance > PROXIMITY_THRESH) {
-            for(int i = WO_OPPONENT1; i <= WO_OPPONENT11; ++i) {
-                WorldObject* opponent = worldModel->getWorldObject( i );
-                if (opponent->validPosition == true) {
-                    VecPosition temp = opponent->pos;
-                    temp.setZ(0);
-                    if (abs(me.getAngleBetweenPoints(target, temp)) < 90.0 &&
-                            me.getDistanceTo(temp) < me.getDistanceTo(target)) {
-                        double distance = me.getDistanceTo(temp);
-                        if (distance < closestObjDistance) {
-                            closestObjDistance = distance;
-                            closestObjPos = temp;
-                        }
+            for(int i = 0; i < players.getNumOpponents(); ++i) {
+                VecPosition temp = players.getOpponent(i).pos;
+                if (abs(me.getAngleBetweenPoints(target, temp)) < 90.0 &&
+                        me.getDistanceTo(temp) < me.getDistanceTo(target)) {
+                    double distance = me.getDistanceTo(temp);
+                    if (distance < closestObjDistance) {
+                        closestObjDistance = distance;
+                        closestObjPos = temp;
                     }
                 }
             }
@@ -750,15 +873,10 @@ SkillType NaoBehavior::getWalk(WalkRequestBlock::ParamSet paramSet, const double
     relSpeed = trim(speed, 0, 1);
 
     double tanReqDirection, tanMaxSpeed;
-    double maxSpeedX, maxSpeedY, maxRot;
 
     // Desired velocity and rotation as a percentage of the maximum speed.
     double relSpeedX, relSpeedY, relRot;
 
-    // Get the maximum speed.
-    maxSpeedX = core->motion_->getMaxXSpeed(); //core->walkEngine.p.speedMax.translation.x;
-    maxSpeedY = core->motion_->getMaxYSpeed(); // core->walkEngine.p.speedMax.translation.y;
-
     relRot = rotation;
     // There is no reason to request a turn > 180 or < -180 as in that case
     // we should just turn the other way instead
@@ -785,7 +903,8 @@ SkillType NaoBehavior::getWalk(WalkRequestBlock::ParamSet paramSet, const double
     else
         tanReqDirection = abs(tanDeg(reqDirection));
 
-    tanMaxSpeed = maxSpeedY / maxSpeedX;
+    // Ratio of the maximum speeds of the requested parameter set
+    tanMaxSpeed = walkSpeeds.getTanMaxSpeed(paramSet);
 
     // Determine the maximum relative speeds that will result in
     // a walk in the appropriate direction.
@@ -906,23 +1025,21 @@ SkillType NaoBehavior::goToTarget(const VecPosition &target) {
 }
 
 double NaoBehavior::getLimitingAngleForward() {
-    double maxSpeedX = core->motion_->getMaxXSpeed(); //core->walkEngine.p.speedMax.translation.x;
-    double maxSpeedY = core->motion_->getMaxYSpeed(); // core->walkEngine.p.speedMax.translation.y;
-    return abs(atan2Deg(maxSpeedY, maxSpeedX));
+    return walkSpeeds.getLimitingAngleForward(WalkRequestBlock::PARAMS_DEFAULT);
 }
 
 
 void NaoBehavior::refresh() {
-    myXDirection = worldModel->l2g(VecPosition(1.0, 0, 0)) - worldModel->l2g(VecPosition(0, 0, 0));
+    myXDirection = worldModel->getMyTorsoAxisGlobal(0);
     myXDirection.setZ(0);
     myXDirection.normalize();
 
-    myYDirection = worldModel->l2g(VecPosition(0, 1.0, 0)) - worldModel->l2g(VecPosition(0, 0, 0));
+    myYDirection = worldModel->getMyTorsoAxisGlobal(1);
     myYDirection.setZ(0);
     myYDirection.normalize();
 
     //Anomalous
-    myZDirection = worldModel->l2g(VecPosition(0, 0, 1.0)) - worldModel->l2g(VecPosition(0, 0, 0));
+    myZDirection = worldModel->getMyTorsoAxisGlobal(2);
     myZDirection.normalize();
 
     me = worldModel->getMyPosition(); // ->l2g(VecPosition(0, 0, 0)); // <- had consistency problems
@@ -930,6 +1047,8 @@ void NaoBehavior::refresh() {
 
     ball = worldModel->getBall();
     ball.setZ(0);
+
+    worldModel->updatePlayerIndex();
 }
 
 
@@ -969,7 +1088,10 @@ void NaoBehavior::setMonMessage(const std::string& msg) {
 
 /* Get message to be sent to the monitor port.  Also flushes message */
 string NaoBehavior::getMonMessage() {
-    string ret = monMsg;
-    monMsg = "";
+    // With a motion thread monMsg belongs to the behavior thread, which
+    // passes it on to the motion thread along with its decisions
+    string &msg = useMotionThread ? motionMonMsg : monMsg;
+    string ret = msg;
+    msg = "";
     return ret;
 }
@@ -8,6 +8,7 @@
 #include "../bodymodel/bodymodel.h"
 #include "../particlefilter/PFLocalization.h"
 #include "../skills/skill.h"
+#include "walkspeedtable.h"
 
 // For UT Walk
 #include <MotionCore.h>
@@ -18,6 +19,12 @@
 #include <memory/JointCommandBlock.h>
 #include <memory/SimEffectorBlock.h>
 #include <memory/WalkRequestBlock.h>
+#include <common/TripleBuffer.h>
+#include <common/ParamRegistry.h>
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <boost/atomic.hpp>
 
 using namespace std;
 
@@ -45,6 +52,63 @@ struct WalkVelocity
     }
 };
 
+/*
+ * When running with --motionthread: one cycle of the motion thread, the
+ * message the server sent and the skill the motion thread went on
+ * executing in answer to it.  Kept in a ring that is allocated once, so
+ * that the motion thread copies each message into a string that already
+ * has room for it.
+ */
+struct MotionCycle
+{
+    string message;
+    bool fExecuted;          // whether effector commands were sent
+    SkillType executedSkill; // SKILL_WALK_OMNI while walking
+};
+
+// Cycles the motion thread holds for a behavior thread that has fallen
+// behind, about a second's worth, and so the size of the ring
+#define MAX_PENDING_MOTION_CYCLES 50
+// Room reserved for each message in the ring, more than the server sends
+#define MOTION_CYCLE_MESSAGE_CAPACITY 16384
+
+/*
+ * When running with --motionthread: the newest cycle in the ring, handed
+ * from the motion thread together with the joint targets the walk engine
+ * last commanded.  The behavior thread takes in every cycle after the
+ * last one it acknowledged up to this one.
+ */
+struct BehaviorInput
+{
+    unsigned long newestMotionCycle;
+    unsigned long droppedMotionCycles; // cycles not handed over so far
+    double walkTargetAngle[EFF_NUM];
+};
+
+/*
+ * When running with --motionthread: everything the behavior thread decided
+ * during one cycle, handed to the motion thread which keeps applying it to
+ * new sensor data until the next decision comes in.
+ */
+struct BehaviorOutput
+{
+    bool fValid;        // false until the behavior thread finished its first cycle
+    bool fCompose;      // whether to send effector commands
+    string action;      // init and beam commands, sent once
+    string sayMessage;  // sent once
+    string monMsg;      // message for the monitor port, sent once
+
+    bool fMove;         // whether act() asked the walk engine for a motion frame
+    WalkVelocity walkRequest;
+    bool useOmniWalk;
+    SkillType executedSkill; // what act() executed, SKILL_NONE if nothing
+
+    double targetAngle[EFF_NUM];
+    double scale[EFF_NUM];
+
+    BehaviorOutput() : fValid(false), fCompose(false), fMove(false), useOmniWalk(false), executedSkill(SKILL_NONE) {}
+};
+
 class NaoBehavior : public Behavior {
     friend class KickClassifier;
 protected:
@@ -55,7 +119,7 @@ protected:
     string classname;
 
     map< SkillType, boost::shared_ptr<Skill> > skills;
-    const map<string, string>& namedParams;
+    const ParamRegistry& params;
     string rsg;
 
     std::string agentTeamName;
@@ -83,6 +147,38 @@ protected:
     void calculateAngles();
     void preProcessJoints();
     void postProcessJoints();
+    void processJointBlocks();
+    void requestWalk(WalkRequestBlock::ParamSet paramSet, double x, double y, double rot);
+
+    // For running motion on its own thread (--motionthread)
+    Parser *motionParser;
+    pthread_t behaviorThread;
+    sem_t behaviorWakeup;
+    boost::atomic<bool> fBehaviorThreadRunning;
+    TripleBuffer<BehaviorInput> behaviorInput;
+    TripleBuffer<BehaviorOutput> behaviorOutput;
+    vector<Effector> motionEffectors;
+    string motionMonMsg;
+    // Cycle seq is in motionCycles[seq % MAX_PENDING_MOTION_CYCLES].  The
+    // motion thread only writes the slot of a cycle the behavior thread
+    // acknowledged through consumedMotionCycle.
+    MotionCycle motionCycles[MAX_PENDING_MOTION_CYCLES];
+    unsigned long nextMotionCycle;
+    unsigned long droppedMotionCycles;
+    boost::atomic<unsigned long> consumedMotionCycle;
+    // Owned by the behavior thread
+    unsigned long reportedDroppedMotionCycles;
+    bool fMotionThreadPriorityRaised;
+    // The skill act() executed this cycle, SKILL_NONE if it returned early
+    SkillType executedSkill;
+
+    void startBehaviorThread();
+    void stopBehaviorThread();
+    static void* behaviorThreadMain(void *behavior);
+    void runBehaviorThread();
+    void catchUpMotionCycles(const BehaviorInput& input);
+    string thinkMotion(const std::string& message);
+    void thinkBehavior(const BehaviorInput& input, BehaviorOutput& output);
 
     double hoverTime;
     bool mInit;
@@ -121,7 +217,13 @@ protected:
     string monMsg;
 
     bool fParsedVision;
+    void updatePerception();
+    bool updateBehaviorState(string& action);
     string composeAction();
+    string composeSayMessage();
+    void senseMotionEffectors();
+    void getMotionWalkTargets(double targetAngle[]);
+    string composeMotionAction(const BehaviorOutput& decision);
 
     virtual void resetSkills();
     void resetScales();
@@ -184,6 +286,17 @@ protected:
      */
     SkillType goToTargetRelative(const VecPosition& targetLoc, const double& targetRot, double speed=1, bool fAllowOver180Turn=false, WalkRequestBlock::ParamSet paramSet=WalkRequestBlock::PARAMS_DEFAULT);
 
+    // Walk limits of every walk parameter set, rebuilt with the skills
+    WalkSpeedTable walkSpeeds;
+
+    /**
+     * Estimated seconds to walk at full speed to a target relative to the
+     * torso while turning targetRot degrees.  See WalkSpeedTable.
+     */
+    inline double estimateTimeToReach(const VecPosition& targetLoc, double targetRot, WalkRequestBlock::ParamSet paramSet=WalkRequestBlock::PARAMS_DEFAULT) const {
+        return walkSpeeds.estimateTimeToReach(paramSet, targetLoc, targetRot);
+    }
+
     SkillType goToTarget(const VecPosition &target);
 
     VecPosition collisionAvoidance(bool avoidTeammate, bool avoidOpponent, bool avoidBall, double PROXIMITY_THRESH, double COLLISION_THRESH, VecPosition target, bool fKeepDistance=true);
@@ -195,6 +308,8 @@ protected:
     void resetKickState();
 
     double computeKickCost(VecPosition target, SkillType kickType);
+    void computeKickCosts(const VecPosition *targets, int numTargets,
+                          const SkillType *kicks, int numKicks, double *costs);
     SkillType kickBall(const int kickTypeToUse, const VecPosition &target);
     SkillType kickBallAtPresetTarget();
 
@@ -211,24 +326,46 @@ protected:
 
     bool beamablePlayMode();
 
-    void readSkillsFromFile( const std::string& filename);
+    void readSkills();
+    void readSkillFiles( const ParamRegistry& skillParams, map< SkillType, boost::shared_ptr<Skill> >& skillsRead );
+    void readSkillsFromFile( const std::string& filename, const ParamRegistry& skillParams,
+                             map< SkillType, boost::shared_ptr<Skill> >& skillsRead );
 
     bool isRightSkill( SkillType skill );
     bool isLeftSkill( SkillType skill );
 
+    // The parameters every kick skill has, named <kick prefix><parameter>
+    enum KickParameter {
+        ANGLE,
+        CW_ANGLE_THRESH,
+        CCW_ANGLE_THRESH,
+        OFFSET_X,
+        OFFSET_Y,
+        BOUNDING_BOX_RIGHT, // Right and left are flipped for right legged kicks
+        BOUNDING_BOX_LEFT,
+        BOUNDING_BOX_TOP,
+        BOUNDING_BOX_BOTTOM,
+        NUM_KICK_PARAMETERS
+    };
+    // Handles of the parameters of every kick skill, NO_PARAM for the
+    // skills that aren't kicks
+    ParamID kickParameters[SKILL_NONE][NUM_KICK_PARAMETERS];
+    void initKickParameters();
+
     double getParameter(const std::string& name);
-    double getStdNameParameter(const SkillType kick_skill, const std::string& parameter);
+    double getStdNameParameter(const SkillType kick_skill, const KickParameter parameter);
     void getSkillsForKickType(int kickType, SkillType skillsForType[]);
 
     SkillType demoKickingCircle();
 
 public:
 
-    NaoBehavior(const std::string teamName, int uNum, const map<string, string>& namedParams_, const string& rsg_);
+    NaoBehavior(const std::string teamName, int uNum, const ParamRegistry& params_, const string& rsg_);
     virtual ~NaoBehavior();
 
     virtual std::string Init();
     virtual std::string Think(const std::string& message);
+    virtual bool reloadParameters(const ParamRegistry& newParams);
 
     void setMonMessage(const std::string& msg);
     string getMonMessage();
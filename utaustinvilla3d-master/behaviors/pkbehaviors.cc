@@ -11,11 +11,11 @@
 PKGoalieBehavior::
 PKGoalieBehavior( const std::string teamName,
                   int uNum,
-                  const map<string, string>& namedParams_,
+                  const ParamRegistry& params_,
                   const string& rsg_)
     : NaoBehavior( teamName,
                    uNum,
-                   namedParams_,
+                   params_,
                    rsg_) {
 }
 
@@ -48,11 +48,11 @@ selectSkill() {
 PKShooterBehavior::
 PKShooterBehavior( const std::string teamName,
                    int uNum,
-                   const map<string, string>& namedParams_,
+                   const ParamRegistry& params_,
                    const string& rsg_ )
     : NaoBehavior( teamName,
                    uNum,
-                   namedParams_,
+                   params_,
                    rsg_ ) {
 }
 
@@ -6,7 +6,7 @@
 class PKShooterBehavior : public NaoBehavior {
 public:
 
-    PKShooterBehavior(const std::string teamName, int uNum, const map<string, string>& namedParams_, const string& rsg_);
+    PKShooterBehavior(const std::string teamName, int uNum, const ParamRegistry& params_, const string& rsg_);
 
     virtual void beam( double& beamX, double& beamY, double& beamAngle );
     virtual SkillType selectSkill();
@@ -15,7 +15,7 @@ public:
 class PKGoalieBehavior : public NaoBehavior {
 public:
 
-    PKGoalieBehavior(const std::string teamName, int uNum, const map<string, string>& namedParams_, const string& rsg_);
+    PKGoalieBehavior(const std::string teamName, int uNum, const ParamRegistry& params_, const string& rsg_);
 
     virtual void beam( double& beamX, double& beamY, double& beamAngle );
     virtual SkillType selectSkill();
@@ -84,30 +84,8 @@ SkillType NaoBehavior::demoKickingCircle() {
     double rotateRate = 2.5;
 
     // Find closest player to ball
-    int playerClosestToBall = -1;
-    double closestDistanceToBall = 10000;
-    for(int i = WO_TEAMMATE1; i < WO_TEAMMATE1+NUM_AGENTS; ++i) {
-        VecPosition temp;
-        int playerNum = i - WO_TEAMMATE1 + 1;
-        if (worldModel->getUNum() == playerNum) {
-            // This is us
-            temp = worldModel->getMyPosition();
-        } else {
-            WorldObject* teammate = worldModel->getWorldObject( i );
-            if (teammate->validPosition) {
-                temp = teammate->pos;
-            } else {
-                continue;
-            }
-        }
-        temp.setZ(0);
-
-        double distanceToBall = temp.getDistanceTo(ball);
-        if (distanceToBall < closestDistanceToBall) {
-            playerClosestToBall = playerNum;
-            closestDistanceToBall = distanceToBall;
-        }
-    }
+    const IndexedPlayer* closestToBall = worldModel->getPlayerIndex().getTeammateClosestToBall();
+    int playerClosestToBall = closestToBall != NULL ? closestToBall->uNum : -1;
 
     if (playerClosestToBall == worldModel->getUNum()) {
         // Have closest player kick the ball toward the center
@@ -0,0 +1,85 @@
+#include "walkspeedtable.h"
+
+#include <cmath>
+
+WalkSpeedTable::WalkSpeedTable() {
+    for (int i = 0; i < WalkRequestBlock::NUM_PARAM_SETS; i++) {
+        SetLimits &set = sets[i];
+        set.tanMaxSpeed = 1;
+        set.limitingAngleForward = 45;
+        set.maxTurnRate = 0;
+        for (int d = 0; d < NUM_DIRECTIONS; d++) {
+            set.speed[d] = 0;
+        }
+    }
+}
+
+void WalkSpeedTable::build(const ParamRegistry &params) {
+    // Prefixes as in UTWalkEngine; PARAMS_NONE gets the default set's
+    // limits so that a lookup with it is still sensible
+    buildSet(params, "", sets[WalkRequestBlock::PARAMS_NONE]);
+    buildSet(params, "", sets[WalkRequestBlock::PARAMS_DEFAULT]);
+    buildSet(params, "pos_", sets[WalkRequestBlock::PARAMS_POSITIONING]);
+    buildSet(params, "app_", sets[WalkRequestBlock::PARAMS_APPROACH_BALL]);
+}
+
+void WalkSpeedTable::buildSet(const ParamRegistry &params, const std::string &prefix, SetLimits &set) {
+    // Step sizes are in mm and radians, for one step every phase
+    double maxStepX = params.get(prefix + "utwalk_max_step_size_x");
+    double maxStepY = params.get(prefix + "utwalk_max_step_size_y");
+    double maxStepRot = params.get(prefix + "utwalk_max_step_size_angle");
+    double phaseLength = params.get(prefix + "utwalk_phase_length");
+
+    set.tanMaxSpeed = maxStepY / maxStepX;
+    set.limitingAngleForward = fabs(atan2Deg(maxStepY, maxStepX));
+    set.maxTurnRate = Rad2Deg(maxStepRot) / phaseLength;
+
+    // The forward and sideways split getWalk() makes for each direction
+    for (int d = 0; d < NUM_DIRECTIONS; d++) {
+        double relSpeedX, relSpeedY;
+        if (d % 180 == 0) {
+            relSpeedX = 1;
+            relSpeedY = 0;
+        } else if (d % 90 == 0) {
+            relSpeedX = 0;
+            relSpeedY = 1;
+        } else {
+            double tanDirection = fabs(tanDeg(d));
+            if (tanDirection < set.tanMaxSpeed) {
+                relSpeedX = 1;
+                relSpeedY = tanDirection / set.tanMaxSpeed;
+            } else {
+                relSpeedX = set.tanMaxSpeed / tanDirection;
+                relSpeedY = 1;
+            }
+        }
+        double stepX = relSpeedX * maxStepX;
+        double stepY = relSpeedY * maxStepY;
+        set.speed[d] = sqrt(stepX * stepX + stepY * stepY) / 1000.0 / phaseLength;
+    }
+}
+
+double WalkSpeedTable::getSpeed(WalkRequestBlock::ParamSet paramSet, double direction) const {
+    direction = fmod(direction, 360.0);
+    direction += (direction < 0) ? 360 : 0;
+
+    int d = (int)direction;
+    if (d >= NUM_DIRECTIONS - 1) {
+        return sets[paramSet].speed[NUM_DIRECTIONS - 1];
+    }
+    double frac = direction - d;
+    return sets[paramSet].speed[d] * (1 - frac) + sets[paramSet].speed[d + 1] * frac;
+}
+
+double WalkSpeedTable::estimateTimeToReach(WalkRequestBlock::ParamSet paramSet, const VecPosition &localTarget,
+        double rotation) const {
+    double walkTime = 0;
+    double distance = hypot(localTarget.getX(), localTarget.getY());
+    if (distance > 0) {
+        walkTime = distance / getSpeed(paramSet, atan2Deg(localTarget.getY(), localTarget.getX()));
+    }
+
+    double turnTime = fabs(VecPosition::normalizeAngle(rotation)) / sets[paramSet].maxTurnRate;
+
+    return walkTime > turnTime ? walkTime : turnTime;
+}
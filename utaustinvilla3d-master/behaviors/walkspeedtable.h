@@ -0,0 +1,72 @@
+#ifndef WALKSPEEDTABLE_H
+#define WALKSPEEDTABLE_H
+
+#include "../math/vecposition.h"
+#include <common/ParamRegistry.h>
+#include <memory/WalkRequestBlock.h>
+
+/*
+ * The walk engine's limits for every walk parameter set, read from the
+ * parameters once when the agent starts (and again when they are
+ * reloaded), and the full speed walk in every direction they allow.
+ *
+ * getWalk() splits a walk direction into forward and sideways speeds with
+ * the ratio of the maximum step sizes; the table holds the speed that
+ * split gives in each whole degree of direction, so planners can estimate
+ * travel times to many candidate targets with a lookup instead of the
+ * trigonometry.  Times are nominal: a step of the maximum size every phase,
+ * without the walk engine's acceleration or slowdowns for balance.
+ */
+class WalkSpeedTable {
+
+public:
+
+    WalkSpeedTable();
+
+    // Reads the limits of every parameter set; throws string if one is
+    // missing
+    void build(const ParamRegistry &params);
+
+    // Ratio of the maximum sideways and forward step sizes
+    inline double getTanMaxSpeed(WalkRequestBlock::ParamSet paramSet) const {
+        return sets[paramSet].tanMaxSpeed;
+    }
+    // The widest walk direction, in degrees off forward, that still
+    // walks at the maximum forward speed
+    inline double getLimitingAngleForward(WalkRequestBlock::ParamSet paramSet) const {
+        return sets[paramSet].limitingAngleForward;
+    }
+    // Maximum turn rate in degrees per second
+    inline double getMaxTurnRate(WalkRequestBlock::ParamSet paramSet) const {
+        return sets[paramSet].maxTurnRate;
+    }
+
+    // Full speed, in meters per second, walking in direction degrees from
+    // forward (counterclockwise)
+    double getSpeed(WalkRequestBlock::ParamSet paramSet, double direction) const;
+
+    /*
+     * Seconds to walk to a target relative to the torso while turning
+     * rotation degrees, walking and turning at the same time at full speed
+     */
+    double estimateTimeToReach(WalkRequestBlock::ParamSet paramSet, const VecPosition &localTarget,
+                               double rotation) const;
+
+private:
+
+    // One entry per degree of direction, 0 and 360 both included
+    static const int NUM_DIRECTIONS = 361;
+
+    struct SetLimits {
+        double tanMaxSpeed;
+        double limitingAngleForward;
+        double maxTurnRate;
+        double speed[NUM_DIRECTIONS];
+    };
+
+    SetLimits sets[WalkRequestBlock::NUM_PARAM_SETS];
+
+    static void buildSet(const ParamRegistry &params, const std::string &prefix, SetLimits &set);
+};
+
+#endif // WALKSPEEDTABLE_H
@@ -40,35 +40,35 @@ BodyModel::BodyModel(WorldModel *worldModel) {
 
     refreshTorso();
 
-    ll1 = HCTMatrix(component[COMP_LHIP1].backTranslateMatrix);
+    ll1 = Affine3f(component[COMP_LHIP1].backTranslateMatrix);
     ll1.multiply(component[COMP_LHIP2].translateMatrix);
 
-    ll2 = HCTMatrix(component[COMP_LHIP2].backTranslateMatrix);
+    ll2 = Affine3f(component[COMP_LHIP2].backTranslateMatrix);
     ll2.multiply(component[COMP_LTHIGH].translateMatrix);
 
-    ll3 = HCTMatrix(component[COMP_LTHIGH].backTranslateMatrix);
+    ll3 = Affine3f(component[COMP_LTHIGH].backTranslateMatrix);
     ll3.multiply(component[COMP_LSHANK].translateMatrix);
 
-    ll4 = HCTMatrix(component[COMP_LSHANK].backTranslateMatrix);
+    ll4 = Affine3f(component[COMP_LSHANK].backTranslateMatrix);
     ll4.multiply(component[COMP_LANKLE].translateMatrix);
 
-    ll5 = HCTMatrix(component[COMP_LANKLE].backTranslateMatrix);
+    ll5 = Affine3f(component[COMP_LANKLE].backTranslateMatrix);
     ll5.multiply(component[COMP_LFOOT].translateMatrix);
 
 
-    rl1 = HCTMatrix(component[COMP_RHIP1].backTranslateMatrix);
+    rl1 = Affine3f(component[COMP_RHIP1].backTranslateMatrix);
     rl1.multiply(component[COMP_RHIP2].translateMatrix);
 
-    rl2 = HCTMatrix(component[COMP_RHIP2].backTranslateMatrix);
+    rl2 = Affine3f(component[COMP_RHIP2].backTranslateMatrix);
     rl2.multiply(component[COMP_RTHIGH].translateMatrix);
 
-    rl3 = HCTMatrix(component[COMP_RTHIGH].backTranslateMatrix);
+    rl3 = Affine3f(component[COMP_RTHIGH].backTranslateMatrix);
     rl3.multiply(component[COMP_RSHANK].translateMatrix);
 
-    rl4 = HCTMatrix(component[COMP_RSHANK].backTranslateMatrix);
+    rl4 = Affine3f(component[COMP_RSHANK].backTranslateMatrix);
     rl4.multiply(component[COMP_RANKLE].translateMatrix);
 
-    rl5 = HCTMatrix(component[COMP_RANKLE].backTranslateMatrix);
+    rl5 = Affine3f(component[COMP_RANKLE].backTranslateMatrix);
     rl5.multiply(component[COMP_RFOOT].translateMatrix);
 
     fUseOmniWalk = true;
@@ -85,16 +85,16 @@ BodyModel::BodyModel(const BodyModel *current, const int legIndex, const double
     joint = std::vector<SIMJoint>(current->joint);
 
     bodyWorldInterface = HCTMatrix(current->bodyWorldInterface);
-    ll1 = HCTMatrix(current->ll1);
-    ll2 = HCTMatrix(current->ll2);
-    ll3 = HCTMatrix(current->ll3);
-    ll4 = HCTMatrix(current->ll4);
-    ll5 = HCTMatrix(current->ll5);
-    rl1 = HCTMatrix(current->rl1);
-    rl2 = HCTMatrix(current->rl2);
-    rl3 = HCTMatrix(current->rl3);
-    rl4 = HCTMatrix(current->rl4);
-    rl5 = HCTMatrix(current->rl5);
+    ll1 = current->ll1;
+    ll2 = current->ll2;
+    ll3 = current->ll3;
+    ll4 = current->ll4;
+    ll5 = current->ll5;
+    rl1 = current->rl1;
+    rl2 = current->rl2;
+    rl3 = current->rl3;
+    rl4 = current->rl4;
+    rl5 = current->rl5;
 
     if(LEG_LEFT == legIndex) {
         joint[HJ_LL1].angle = a1;
@@ -480,19 +480,17 @@ void BodyModel::refreshTorso() {
 
 void BodyModel::refreshComponent(const int &index) {
 
-    component[index].transformFromParent.createIdentity();
-
-    HCTMatrix translate = HCTMatrix(HCT_TRANSLATE, component[index].translation + component[index].anchor);
+    // translate to the anchor, rotate about the joint axis and translate back
+    Affine3f fromParent = component[index].translateMatrix;
     //Hack: Assumes joint[index] = component[index + 1]
-    HCTMatrix rotate = HCTMatrix(HCT_GENERALIZED_ROTATE, component[index].axis, joint[index - 1].angle);
-    HCTMatrix backTranslate = HCTMatrix(HCT_TRANSLATE, -component[index].anchor);
+    fromParent.multiply(Affine3f::rotation(Vec3f(component[index].axis), joint[index - 1].angle));
+    fromParent.multiply(component[index].backTranslateMatrix);
 
-    component[index].transformFromParent.multiply(translate);
-    component[index].transformFromParent.multiply(rotate);
-    component[index].transformFromParent.multiply(backTranslate);
+    Affine3f fromRoot(component[component[index].parent].transformFromRoot);
+    fromRoot.multiply(fromParent);
 
-    component[index].transformFromRoot = HCTMatrix(component[component[index].parent].transformFromRoot);
-    component[index].transformFromRoot.multiply(component[index].transformFromParent);
+    component[index].transformFromParent = fromParent.toHCTMatrix();
+    component[index].transformFromRoot = fromRoot.toHCTMatrix();
 }
 
 void BodyModel::refreshHead() {
@@ -655,7 +653,7 @@ void BodyModel::display() {
 
 void BodyModel::displayDerived() {
 
-    VecPosition CG = worldModel->l2g(VecPosition(0, 0, 0));
+    VecPosition CG = worldModel->getMyTorsoGlobal();
     cout << "TORSO: " << CG << "\n";
 
     VecPosition rightFootCG = worldModel->l2g(HCTMatrix((component[COMP_RFOOT].transformFromRoot)).transform(VecPosition(0, 0, 0)));
@@ -813,51 +811,53 @@ VecPosition BodyModel::getFootCG(const int &legIndex, const double &ang1, const
 
 void BodyModel::getFootTransform(const int &legIndex, HCTMatrix &m, const double &ang1, const double &ang2, const double &ang3, const double &ang4, const double &ang5, const double &ang6) const {
 
-    m = HCTMatrix(component[COMP_TORSO].transformFromRoot);
+    Affine3f f(component[COMP_TORSO].transformFromRoot);
 
     if(legIndex == LEG_LEFT) {
 
-        m.multiply(component[COMP_LHIP1].translateMatrix);
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_LHIP1].axis, ang1));
-        m.multiply(ll1);
+        f.multiply(component[COMP_LHIP1].translateMatrix);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_LHIP1].axis), ang1));
+        f.multiply(ll1);
 
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_LHIP2].axis, ang2));
-        m.multiply(ll2);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_LHIP2].axis), ang2));
+        f.multiply(ll2);
 
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_LTHIGH].axis, ang3));
-        m.multiply(ll3);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_LTHIGH].axis), ang3));
+        f.multiply(ll3);
 
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_LSHANK].axis, ang4));
-        m.multiply(ll4);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_LSHANK].axis), ang4));
+        f.multiply(ll4);
 
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_LANKLE].axis, ang5));
-        m.multiply(ll5);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_LANKLE].axis), ang5));
+        f.multiply(ll5);
 
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_LFOOT].axis, ang6));
-        m.multiply(component[COMP_LFOOT].backTranslateMatrix);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_LFOOT].axis), ang6));
+        f.multiply(component[COMP_LFOOT].backTranslateMatrix);
     }
     else if(legIndex == LEG_RIGHT) {
 
-        m.multiply(component[COMP_RHIP1].translateMatrix);
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_RHIP1].axis, ang1));
-        m.multiply(rl1);
+        f.multiply(component[COMP_RHIP1].translateMatrix);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_RHIP1].axis), ang1));
+        f.multiply(rl1);
 
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_RHIP2].axis, ang2));
-        m.multiply(rl2);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_RHIP2].axis), ang2));
+        f.multiply(rl2);
 
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_RTHIGH].axis, ang3));
-        m.multiply(rl3);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_RTHIGH].axis), ang3));
+        f.multiply(rl3);
 
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_RSHANK].axis, ang4));
-        m.multiply(rl4);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_RSHANK].axis), ang4));
+        f.multiply(rl4);
 
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_RANKLE].axis, ang5));
-        m.multiply(rl5);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_RANKLE].axis), ang5));
+        f.multiply(rl5);
 
-        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, component[COMP_RFOOT].axis, ang6));
-        m.multiply(component[COMP_RFOOT].backTranslateMatrix);
+        f.multiply(Affine3f::rotation(Vec3f(component[COMP_RFOOT].axis), ang6));
+        f.multiply(component[COMP_RFOOT].backTranslateMatrix);
     }
 
+    m = f.toHCTMatrix();
+
 }
 
 VecPosition BodyModel::getFootCG(const int &legIndex) const {
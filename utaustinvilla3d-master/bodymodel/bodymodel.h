@@ -4,6 +4,7 @@
 #include "../headers/headers.h"
 #include "../math/vecposition.h"
 #include "../math/hctmatrix.h"
+#include "../math/affine3f.h"
 #include "../worldmodel/worldmodel.h"
 #include "../ikfast/ikfast.h"
 
@@ -131,8 +132,10 @@ struct Component {
     HCTMatrix transformFromParent;
     HCTMatrix transformFromRoot;
 
-    HCTMatrix translateMatrix;
-    HCTMatrix backTranslateMatrix;
+    // Float transforms for the forward kinematics in refreshComponent and
+    // getFootTransform
+    Affine3f translateMatrix;
+    Affine3f backTranslateMatrix;
 
     Component(const int &parent, const double &mass, const VecPosition &translation, const VecPosition &anchor, const VecPosition &axis) {
 
@@ -146,8 +149,8 @@ struct Component {
         transformFromParent = HCTMatrix();
         transformFromRoot = HCTMatrix();
 
-        translateMatrix = HCTMatrix(HCT_TRANSLATE, VecPosition(translation) + VecPosition(anchor));
-        backTranslateMatrix = HCTMatrix(HCT_TRANSLATE, -VecPosition(anchor));
+        translateMatrix = Affine3f::translation(Vec3f(VecPosition(translation) + VecPosition(anchor)));
+        backTranslateMatrix = Affine3f::translation(Vec3f(-VecPosition(anchor)));
     }
 };
 
@@ -184,8 +187,8 @@ private:
 
     HCTMatrix bodyWorldInterface;
 
-    HCTMatrix ll1, ll2, ll3, ll4, ll5;
-    HCTMatrix rl1, rl2, rl3, rl4, rl5;
+    Affine3f ll1, ll2, ll3, ll4, ll5;
+    Affine3f rl1, rl2, rl3, rl4, rl5;
 
     double fallAngle;
 
@@ -203,7 +206,8 @@ private:
     inline void computeFallAngle() {
 
         VecPosition zAxis = VecPosition(0, 0, 1.0);
-        VecPosition bodyZAxis = (worldModel->l2g(VecPosition(0, 0, 1.0)) - worldModel->l2g(VecPosition(0, 0, 0))).normalize();
+        VecPosition bodyZAxis = worldModel->getMyTorsoAxisGlobal(2);
+        bodyZAxis.normalize();
         fallAngle = VecPosition(0, 0, 0).getAngleBetweenPoints(zAxis, bodyZAxis);
     }
 
@@ -226,6 +230,10 @@ public:
     void display();
     void displayDerived();
 
+    inline const Effector& getEffector(const int &EffectorID) const {
+        return effector[EffectorID];
+    }
+
     inline double getCurrentAngle(const int &EffectorID) const {
         return effector[EffectorID].currentAngle;
     }
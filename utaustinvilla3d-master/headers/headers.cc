@@ -1,4 +1,5 @@
 #include "headers.h"
+#include <boost/static_assert.hpp>
 
 // This file contains mapping between enums to strings, to
 // be used by the parser (mainly) when reading from file
@@ -160,15 +161,36 @@ EnumParser<Effectors>::EnumParser()
 template class EnumParser<Effectors>;
 template<>
 const EnumParser<Effectors> EnumParser<Effectors>::parser = EnumParser<Effectors>();
+
+// Side, mirror, kick type and kick parameter prefix of every skill, one
+// row per SkillType in the order of the enum.  The mirrors are filled in
+// by setSkillMirror() as the skill files are read.
+SkillInfo skillInfo[] = {
+    { -1, SKILL_NONE, KICK_NONE, NULL },                        // SKILL_WALK_OMNI
+    { -1, SKILL_NONE, KICK_NONE, NULL },                        // SKILL_STAND
+    { -1, SKILL_NONE, KICK_NONE, NULL },                        // SKILL_DOWN
+    { SIDE_LEFT, SKILL_NONE, KICK_FORWARD, "kick_" },           // SKILL_KICK_LEFT_LEG
+    { SIDE_RIGHT, SKILL_NONE, KICK_FORWARD, "kick_" },          // SKILL_KICK_RIGHT_LEG
+    { SIDE_LEFT, SKILL_NONE, KICK_IK, "kick_ik_0_" },           // SKILL_KICK_IK_0_LEFT_LEG
+    { SIDE_RIGHT, SKILL_NONE, KICK_IK, "kick_ik_0_" },          // SKILL_KICK_IK_0_RIGHT_LEG
+    { -1, SKILL_NONE, KICK_NONE, NULL }                         // SKILL_NONE
+};
+// A skill added to SkillType needs its row above
+BOOST_STATIC_ASSERT(sizeof(skillInfo) / sizeof(skillInfo[0]) == SKILL_NONE + 1);
+
+void setSkillMirror(SkillType source, SkillType target)
+{
+    skillInfo[source].mirror = target;
+    skillInfo[target].mirror = source;
+}
+
 bool isKickSkill(SkillType skill)
 {
-    string skillStr = EnumParser<SkillType>::getStringFromEnum( skill );
-    return skillStr.find("KICK") != string::npos;
+    return skillInfo[skill].kickType != KICK_NONE;
 }
 
 bool isKickIKSkill(SkillType skill)
 {
-    string skillStr = EnumParser<SkillType>::getStringFromEnum( skill );
-    return skillStr.find("KICK_IK") != string::npos;
+    return skillInfo[skill].kickType == KICK_IK;
 }
 
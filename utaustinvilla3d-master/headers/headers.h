@@ -314,6 +314,31 @@ std::ostream& operator<<(std::ostream& out, const std::vector<T>& t) {
 bool isKickSkill(SkillType skill);
 bool isKickIKSkill(SkillType skill);
 
+// What is known about a skill, so that questions about it don't need to
+// look at its name
+struct SkillInfo {
+    int side;                 // SIDE_LEFT or SIDE_RIGHT for one legged skills, -1 otherwise
+    SkillType mirror;         // its reflection, SKILL_NONE if no skill file reflects it
+    int kickType;             // KICK_FORWARD or KICK_IK, KICK_NONE if it is not a kick
+    const char* paramPrefix;  // prefix of its kick parameters, NULL if it is not a kick
+};
+
+// Indexed by SkillType, SKILL_NONE included
+extern SkillInfo skillInfo[];
+
+inline const SkillInfo& getSkillInfo(SkillType skill) {
+    return skillInfo[skill];
+}
+
+// The same skill on the other side, SKILL_NONE if no skill file reflects
+// skill into another
+inline SkillType getSkillMirror(SkillType skill) {
+    return skillInfo[skill].mirror;
+}
+
+// Records that target is the reflection of source, as read from a skill file
+void setSkillMirror(SkillType source, SkillType target);
+
 
 #endif // HEADERS_H
 
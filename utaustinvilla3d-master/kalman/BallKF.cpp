@@ -367,7 +367,7 @@ void BallKF::ballMeasurementUpdate(int modelNumber) {
     WorldObject* ball = worldModel->getWorldObject(WO_BALL);
 
     // no update here if we didn't see the ball
-    if (!ball->currentlySeen)
+    if (!measurementStats.count(ball->currentlySeen))
         return;
 
     // Todd: for some reason normal update is going crazy
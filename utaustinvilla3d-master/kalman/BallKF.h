@@ -7,6 +7,7 @@
 #include "../headers/Field.h"
 #include "../worldmodel/WorldObject.h"
 #include "../worldmodel/worldmodel.h"
+#include "../parser/stagestats.h"
 #include <stdarg.h>
 
 #define MAX_MODELS_UT 1
@@ -42,6 +43,8 @@ public:
     WorldObjectBlock *world_objects_;
 
     float prev_time_;
+    // Measurement updates run and skipped for not having seen the ball
+    StageStats measurementStats;
     void processFrame();
     // updates
     void timeUpdate(int modelNumber, float timePassed);
@@ -374,7 +374,7 @@ void PlayerKF::playerMeasurementUpdate(int modelNumber) {
     WorldObject* player = worldModel->getWorldObject(WO_OPPONENT1+modelNumber);
 
     // no update here if we didn't see the player
-    if (!player->currentlySeen && (!player->haveSighting || !player->validPosition))
+    if (!measurementStats.count(player->currentlySeen || (player->haveSighting && player->validPosition)))
         return;
 
     // Todd: for some reason normal update is going crazy
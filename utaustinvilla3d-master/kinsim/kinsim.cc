@@ -0,0 +1,809 @@
+#include "kinsim.h"
+#include "../headers/Field.h"
+
+#include <stdlib.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#define KS_BALL_RADIUS 0.042
+// Fraction of its speed the ball keeps every cycle
+#define KS_BALL_DECAY 0.98
+#define KS_GRAVITY 9.81
+// Share of the foot's speed the ball bounces off with
+#define KS_KICK_RESTITUTION 0.6
+
+#define KS_TORSO_RADIUS 0.1
+#define KS_FOOT_RADIUS 0.06
+#define KS_FOOT_HALF_HEIGHT 0.01
+// Feet closer in height than this both carry the robot
+#define KS_DOUBLE_SUPPORT_Z 0.005
+// Weight of the robot in newtons, split between the feet on the ground
+#define KS_WEIGHT 46.0
+#define KS_CAMERA_Z (0.09 + 0.065)
+#define KS_VIEW_ANGLE 60.0
+
+#define KS_GOAL_PAUSE 3.0
+#define KS_KICK_OFF_TIME 15.0
+
+static const char* effectorNames[HJ_NUM] = {
+    "he1", "he2",
+    "lae1", "lae2", "lae3", "lae4",
+    "rae1", "rae2", "rae3", "rae4",
+    "lle1", "lle2", "lle3", "lle4", "lle5", "lle6", "lle7",
+    "rle1", "rle2", "rle3", "rle4", "rle5", "rle6", "rle7"
+};
+
+static const char* jointNames[HJ_NUM] = {
+    "hj1", "hj2",
+    "laj1", "laj2", "laj3", "laj4",
+    "raj1", "raj2", "raj3", "raj4",
+    "llj1", "llj2", "llj3", "llj4", "llj5", "llj6", "llj7",
+    "rlj1", "rlj2", "rlj3", "rlj4", "rlj5", "rlj6", "rlj7"
+};
+
+// Joint limits in degrees, the same as the effectors' in BodyModel
+static const double jointMin[HJ_NUM] = {
+    -120, -45,
+    -120, -1, -120, -90,
+    -120, -95, -120, -1,
+    -90, -25, -25, -130, -45, -45, -1,
+    -90, -45, -25, -130, -45, -25, -1
+};
+static const double jointMax[HJ_NUM] = {
+    120, 45,
+    120, 95, 120, 1,
+    120, 1, 120, 90,
+    1, 45, 100, 1, 75, 25, 70,
+    1, 25, 100, 1, 75, 45, 70
+};
+
+static const char* playModeNames[KS_NUM_PLAY_MODES] = {
+    "BeforeKickOff", "KickOff_Left", "KickOff_Right", "PlayOn",
+    "Goal_Left", "Goal_Right", "GameOver"
+};
+
+#define KS_NUM_LANDMARKS 8
+static const char* landmarkNames[KS_NUM_LANDMARKS] = {
+    "F1L", "F2L", "F1R", "F2R", "G1L", "G2L", "G1R", "G2R"
+};
+static const VecPosition landmarks[KS_NUM_LANDMARKS] = {
+    VecPosition(-HALF_FIELD_X, HALF_FIELD_Y, 0),
+    VecPosition(-HALF_FIELD_X, -HALF_FIELD_Y, 0),
+    VecPosition(HALF_FIELD_X, HALF_FIELD_Y, 0),
+    VecPosition(HALF_FIELD_X, -HALF_FIELD_Y, 0),
+    VecPosition(-HALF_FIELD_X, HALF_GOAL_Y, GOAL_Z),
+    VecPosition(-HALF_FIELD_X, -HALF_GOAL_Y, GOAL_Z),
+    VecPosition(HALF_FIELD_X, HALF_GOAL_Y, GOAL_Z),
+    VecPosition(HALF_FIELD_X, -HALF_GOAL_Y, GOAL_Z)
+};
+
+// Leg links from hip1 to foot, [leg][link], the same as the components in
+// BodyModel.  Leg 0 is the left leg.
+#define KS_LEG_LINKS 6
+static const VecPosition legTranslation[2][KS_LEG_LINKS] = {
+    {
+        VecPosition(-0.01, 0.055, -0.115), VecPosition(0, 0, 0),
+        VecPosition(0.01, 0, -0.04), VecPosition(0.005, 0, -0.125),
+        VecPosition(-0.01, 0, -0.055), VecPosition(0.03, 0, -0.04)
+    },
+    {
+        VecPosition(-0.01, -0.055, -0.115), VecPosition(0, 0, 0),
+        VecPosition(0.01, 0, -0.04), VecPosition(0.005, 0, -0.125),
+        VecPosition(-0.01, 0, -0.055), VecPosition(0.03, 0, -0.04)
+    }
+};
+static const VecPosition legAnchor[KS_LEG_LINKS] = {
+    VecPosition(0, 0, 0), VecPosition(0, 0, 0),
+    VecPosition(-0.01, 0, 0.04), VecPosition(-0.01, 0, 0.045),
+    VecPosition(0, 0, 0), VecPosition(-0.03, 0, 0.04)
+};
+static const VecPosition legAxis[2][KS_LEG_LINKS] = {
+    {
+        VecPosition(0, M_SQRT1_2, -M_SQRT1_2), VecPosition(1, 0, 0),
+        VecPosition(0, -1, 0), VecPosition(0, -1, 0),
+        VecPosition(0, -1, 0), VecPosition(1, 0, 0)
+    },
+    {
+        VecPosition(0, -M_SQRT1_2, M_SQRT1_2), VecPosition(1, 0, 0),
+        VecPosition(0, -1, 0), VecPosition(0, -1, 0),
+        VecPosition(0, -1, 0), VecPosition(1, 0, 0)
+    }
+};
+
+static double normalizeRad(double angle) {
+    while (angle > M_PI) {
+        angle -= 2 * M_PI;
+    }
+    while (angle < -M_PI) {
+        angle += 2 * M_PI;
+    }
+    return angle;
+}
+
+/*
+ * Splits a message into its top level expressions, each flattened to its
+ * words: "(init (unum 2)(teamname a))(syn)" gives {init unum 2 teamname a}
+ * and {syn}.
+ */
+static vector<vector<string> > splitExpressions(const string &message) {
+    vector<vector<string> > expressions;
+    int depth = 0;
+    string word;
+    for (size_t i = 0; i < message.size(); i++) {
+        char c = message[i];
+        if (c == '(' || c == ')' || c == ' ' || c == '\t' || c == '\n' || c == '\0') {
+            if (!word.empty() && depth > 0) {
+                expressions.back().push_back(word);
+            }
+            word = "";
+            if (c == '(') {
+                if (depth == 0) {
+                    expressions.push_back(vector<string>());
+                }
+                depth++;
+            } else if (c == ')' && depth > 0) {
+                depth--;
+            }
+        } else {
+            word += c;
+        }
+    }
+    return expressions;
+}
+
+KinSim::KinSim(double halfTime, double autoKickOffTime) :
+    time(0),
+    gameTime(0),
+    cycle(0),
+    playMode(KS_BEFORE_KICK_OFF),
+    playModeStartTime(0),
+    halfTime(halfTime),
+    autoKickOffTime(autoKickOffTime),
+    fKilled(false),
+    ball(0, 0, KS_BALL_RADIUS),
+    ballVel(0, 0, 0),
+    fBallTouched(false) {
+    score[SIDE_LEFT] = 0;
+    score[SIDE_RIGHT] = 0;
+}
+
+KinSim::~KinSim() {
+    for (size_t id = 0; id < players.size(); id++) {
+        delete players[id];
+    }
+}
+
+int KinSim::addPlayer() {
+    KinSimPlayer* player = new KinSimPlayer();
+    player->fInitialized = false;
+    player->side = SIDE_LEFT;
+    player->uNum = 0;
+    player->bodyType = 0;
+    player->x = 0;
+    player->y = 0;
+    player->z = 0;
+    player->yaw = 0;
+    player->yawRate = 0;
+    for (int j = 0; j < HJ_NUM; j++) {
+        player->jointAngle[j] = 0;
+        player->jointSpeed[j] = 0;
+    }
+    player->fFeetKnown = false;
+
+    for (size_t id = 0; id < players.size(); id++) {
+        if (players[id] == NULL) {
+            players[id] = player;
+            return id;
+        }
+    }
+    players.push_back(player);
+    return players.size() - 1;
+}
+
+void KinSim::removePlayer(int id) {
+    if (hasPlayer(id)) {
+        delete players[id];
+        players[id] = NULL;
+    }
+}
+
+bool KinSim::hasPlayer(int id) const {
+    return id >= 0 && id < (int)players.size() && players[id] != NULL;
+}
+
+void KinSim::act(int id, const string &message) {
+    if (!hasPlayer(id)) {
+        return;
+    }
+    KinSimPlayer &player = *players[id];
+
+    vector<vector<string> > expressions = splitExpressions(message);
+    for (size_t e = 0; e < expressions.size(); e++) {
+        const vector<string> &words = expressions[e];
+        if (words.empty()) {
+            continue;
+        }
+        const string &name = words[0];
+
+        bool fEffector = false;
+        for (int j = 0; j < HJ_NUM && !fEffector; j++) {
+            if (name == effectorNames[j]) {
+                if (words.size() > 1) {
+                    player.jointSpeed[j] = atof(words[1].c_str());
+                }
+                fEffector = true;
+            }
+        }
+        if (fEffector || name == "syn") {
+            continue;
+        }
+
+        if (name == "scene") {
+            // (scene rsg/agent/nao/nao_hetero.rsg 4)
+            if (words.size() > 2) {
+                player.bodyType = atoi(words[2].c_str());
+            }
+        } else if (name == "init") {
+            initPlayer(player, message);
+        } else if (name == "beam" && words.size() > 3) {
+            if (playMode == KS_BEFORE_KICK_OFF || playMode == KS_GOAL_LEFT ||
+                    playMode == KS_GOAL_RIGHT) {
+                beam(player, atof(words[1].c_str()), atof(words[2].c_str()),
+                     atof(words[3].c_str()));
+            }
+        } else if (name == "say" && words.size() > 1) {
+            player.sayMessage = words[1];
+        } else {
+            cerr << "(KinSim) ignoring unknown effector: " << name << endl;
+        }
+    }
+}
+
+void KinSim::initPlayer(KinSimPlayer &player, const string &message) {
+    if (player.fInitialized) {
+        return;
+    }
+
+    int uNum = 0;
+    string teamName;
+    vector<vector<string> > expressions = splitExpressions(message);
+    for (size_t e = 0; e < expressions.size(); e++) {
+        const vector<string> &words = expressions[e];
+        if (words.empty() || words[0] != "init") {
+            continue;
+        }
+        for (size_t i = 1; i + 1 < words.size(); i++) {
+            if (words[i] == "unum") {
+                uNum = atoi(words[i + 1].c_str());
+            } else if (words[i] == "teamname") {
+                teamName = words[i + 1];
+            }
+        }
+    }
+
+    // The first team to connect plays on the left
+    int side;
+    if (teamNames[SIDE_LEFT].empty() || teamNames[SIDE_LEFT] == teamName) {
+        side = SIDE_LEFT;
+    } else if (teamNames[SIDE_RIGHT].empty() || teamNames[SIDE_RIGHT] == teamName) {
+        side = SIDE_RIGHT;
+    } else {
+        cerr << "(KinSim) no room for a third team: " << teamName << endl;
+        return;
+    }
+
+    bool taken[TEAMMATE_NUM + 1] = { false };
+    for (size_t id = 0; id < players.size(); id++) {
+        if (players[id] != NULL && players[id]->fInitialized && players[id]->side == side) {
+            taken[players[id]->uNum] = true;
+        }
+    }
+    if (uNum < 0 || uNum > TEAMMATE_NUM || taken[uNum]) {
+        cerr << "(KinSim) uniform number " << uNum << " not available for " << teamName << endl;
+        uNum = 0;
+    }
+    if (uNum == 0) {
+        for (int u = 1; u <= TEAMMATE_NUM && uNum == 0; u++) {
+            if (!taken[u]) {
+                uNum = u;
+            }
+        }
+        if (uNum == 0) {
+            cerr << "(KinSim) team " << teamName << " is full" << endl;
+            return;
+        }
+    }
+
+    teamNames[side] = teamName;
+    player.side = side;
+    player.uNum = uNum;
+    player.fInitialized = true;
+
+    // Wait on the sideline of the own half, facing the field
+    player.x = side == SIDE_LEFT ? -uNum : uNum;
+    player.y = -HALF_FIELD_Y;
+    player.yaw = M_PI / 2;
+    player.fFeetKnown = false;
+    moveTorso(player);
+}
+
+void KinSim::beam(KinSimPlayer &player, double beamX, double beamY, double beamAngle) {
+    if (!player.fInitialized) {
+        return;
+    }
+    if (player.side == SIDE_LEFT) {
+        player.x = beamX;
+        player.y = beamY;
+        player.yaw = normalizeRad(beamAngle * M_PI / 180);
+    } else {
+        player.x = -beamX;
+        player.y = -beamY;
+        player.yaw = normalizeRad(beamAngle * M_PI / 180 + M_PI);
+    }
+    for (int leg = 0; leg < 2; leg++) {
+        player.footGlobal[leg] = toGlobal(player, player.footLocal[leg]);
+        player.lastFootGlobal[leg] = player.footGlobal[leg];
+    }
+}
+
+void KinSim::command(const string &message) {
+    vector<vector<string> > expressions = splitExpressions(message);
+    for (size_t e = 0; e < expressions.size(); e++) {
+        const vector<string> &words = expressions[e];
+        if (words.empty()) {
+            continue;
+        }
+        const string &name = words[0];
+
+        if (name == "playMode" && words.size() > 1) {
+            bool fKnown = false;
+            for (int m = 0; m < KS_NUM_PLAY_MODES; m++) {
+                if (words[1] == playModeNames[m]) {
+                    setPlayMode((KinSimPlayMode)m);
+                    fKnown = true;
+                }
+            }
+            if (!fKnown) {
+                cerr << "(KinSim) unsupported play mode: " << words[1] << endl;
+            }
+        } else if (name == "kickOff" && words.size() > 1) {
+            setPlayMode(words[1] == "Right" ? KS_KICK_OFF_RIGHT : KS_KICK_OFF_LEFT);
+        } else if (name == "ball") {
+            // (ball (pos x y z) (vel x y z))
+            for (size_t i = 1; i + 3 < words.size(); i++) {
+                VecPosition v(atof(words[i + 1].c_str()), atof(words[i + 2].c_str()),
+                              atof(words[i + 3].c_str()));
+                if (words[i] == "pos") {
+                    ball = v;
+                } else if (words[i] == "vel") {
+                    ballVel = v;
+                }
+            }
+        } else if (name == "agent") {
+            // (agent (unum 1) (team Left) (pos x y z)) or with (move x y z rot)
+            int uNum = 0;
+            int side = SIDE_LEFT;
+            for (size_t i = 1; i + 1 < words.size(); i++) {
+                if (words[i] == "unum") {
+                    uNum = atoi(words[i + 1].c_str());
+                } else if (words[i] == "team") {
+                    side = words[i + 1] == "Right" ? SIDE_RIGHT : SIDE_LEFT;
+                }
+            }
+            for (size_t id = 0; id < players.size(); id++) {
+                KinSimPlayer* player = players[id];
+                if (player == NULL || !player->fInitialized || player->uNum != uNum ||
+                        player->side != side) {
+                    continue;
+                }
+                for (size_t i = 1; i + 3 < words.size(); i++) {
+                    if (words[i] == "pos" || words[i] == "move") {
+                        player->x = atof(words[i + 1].c_str());
+                        player->y = atof(words[i + 2].c_str());
+                        if (words[i] == "move" && i + 4 < words.size()) {
+                            player->yaw = normalizeRad(atof(words[i + 4].c_str()) * M_PI / 180);
+                        }
+                    }
+                }
+                for (int leg = 0; leg < 2; leg++) {
+                    player->footGlobal[leg] = toGlobal(*player, player->footLocal[leg]);
+                    player->lastFootGlobal[leg] = player->footGlobal[leg];
+                }
+            }
+        } else if (name == "killsim") {
+            fKilled = true;
+        } else {
+            cerr << "(KinSim) ignoring unknown command: " << name << endl;
+        }
+    }
+}
+
+void KinSim::setPlayMode(KinSimPlayMode mode) {
+    if (mode == KS_BEFORE_KICK_OFF || mode == KS_KICK_OFF_LEFT || mode == KS_KICK_OFF_RIGHT) {
+        ball = VecPosition(0, 0, KS_BALL_RADIUS);
+        ballVel = VecPosition(0, 0, 0);
+    }
+    playMode = mode;
+    playModeStartTime = time;
+    fBallTouched = false;
+}
+
+void KinSim::step() {
+    time += KINSIM_STEP;
+    cycle++;
+    if (playMode != KS_BEFORE_KICK_OFF && playMode != KS_GAME_OVER) {
+        gameTime += KINSIM_STEP;
+    }
+
+    heard.clear();
+    for (size_t id = 0; id < players.size(); id++) {
+        KinSimPlayer* player = players[id];
+        if (player == NULL) {
+            continue;
+        }
+        moveJoints(*player);
+        if (player->fInitialized) {
+            moveTorso(*player);
+            if (!player->sayMessage.empty()) {
+                Heard h;
+                h.speaker = id;
+                h.pos = VecPosition(player->x, player->y, player->z);
+                h.message = player->sayMessage;
+                heard.push_back(h);
+            }
+        }
+        player->sayMessage = "";
+    }
+
+    moveBall();
+    collide();
+    refereeBall();
+    refereeTime();
+}
+
+void KinSim::moveJoints(KinSimPlayer &player) {
+    for (int j = 0; j < HJ_NUM; j++) {
+        double angle = player.jointAngle[j] + player.jointSpeed[j] * KINSIM_STEP * 180 / M_PI;
+        player.jointAngle[j] = max(jointMin[j], min(jointMax[j], angle));
+    }
+}
+
+/*
+ * Moves the torso so that the foot carrying the robot (both, when they are
+ * level) stays where it was on the field, and puts the lowest sole on the
+ * ground.
+ */
+void KinSim::moveTorso(KinSimPlayer &player) {
+    VecPosition footLocal[2];
+    double footYaw[2];
+    for (int leg = 0; leg < 2; leg++) {
+        computeFoot(player, leg, footLocal[leg], footYaw[leg]);
+    }
+    double lowest = min(footLocal[0].getZ(), footLocal[1].getZ());
+
+    if (player.fFeetKnown) {
+        double newX = 0;
+        double newY = 0;
+        double newYaw = 0;
+        int stanceFeet = 0;
+        for (int leg = 0; leg < 2; leg++) {
+            if (footLocal[leg].getZ() > lowest + KS_DOUBLE_SUPPORT_Z) {
+                continue;
+            }
+            VecPosition planted = toGlobal(player, player.footLocal[leg]);
+            double yaw = normalizeRad(player.yaw + player.footYaw[leg] - footYaw[leg]);
+            newX += planted.getX() - cos(yaw) * footLocal[leg].getX() + sin(yaw) * footLocal[leg].getY();
+            newY += planted.getY() - sin(yaw) * footLocal[leg].getX() - cos(yaw) * footLocal[leg].getY();
+            // Average yaw changes rather than headings so that -pi and pi agree
+            newYaw += normalizeRad(yaw - player.yaw);
+            stanceFeet++;
+        }
+        double lastYaw = player.yaw;
+        player.x = newX / stanceFeet;
+        player.y = newY / stanceFeet;
+        player.yaw = normalizeRad(player.yaw + newYaw / stanceFeet);
+        player.yawRate = normalizeRad(player.yaw - lastYaw) / KINSIM_STEP;
+    }
+    player.z = -lowest;
+
+    for (int leg = 0; leg < 2; leg++) {
+        player.footLocal[leg] = footLocal[leg];
+        player.footYaw[leg] = footYaw[leg];
+        player.lastFootGlobal[leg] = player.fFeetKnown ? player.footGlobal[leg] :
+                                     toGlobal(player, footLocal[leg]);
+        player.footGlobal[leg] = toGlobal(player, footLocal[leg]);
+    }
+    player.fFeetKnown = true;
+
+    // Keep everybody near the field
+    player.x = max(-HALF_FIELD_X - 1, min(HALF_FIELD_X + 1, player.x));
+    player.y = max(-HALF_FIELD_Y - 1, min(HALF_FIELD_Y + 1, player.y));
+}
+
+void KinSim::moveBall() {
+    ball += ballVel * KINSIM_STEP;
+    ballVel.setX(ballVel.getX() * KS_BALL_DECAY);
+    ballVel.setY(ballVel.getY() * KS_BALL_DECAY);
+
+    if (ball.getZ() > KS_BALL_RADIUS) {
+        ballVel.setZ(ballVel.getZ() - KS_GRAVITY * KINSIM_STEP);
+    } else {
+        ball.setZ(KS_BALL_RADIUS);
+        ballVel.setZ(ballVel.getZ() < 0 ? -ballVel.getZ() * 0.5 : ballVel.getZ());
+        if (ballVel.getZ() < KS_GRAVITY * KINSIM_STEP) {
+            ballVel.setZ(0);
+        }
+    }
+}
+
+/*
+ * Feet kick the ball with their own speed, torsos push it and each other
+ * out of the way.
+ */
+void KinSim::collide() {
+    for (size_t id = 0; id < players.size(); id++) {
+        KinSimPlayer* player = players[id];
+        if (player == NULL || !player->fInitialized) {
+            continue;
+        }
+
+        for (int leg = 0; leg < 2; leg++) {
+            VecPosition toBall = ball - player->footGlobal[leg];
+            toBall.setZ(0);
+            double dist = toBall.getMagnitude();
+            if (dist >= KS_BALL_RADIUS + KS_FOOT_RADIUS || dist == 0 ||
+                    ball.getZ() > 2 * KS_BALL_RADIUS + player->footGlobal[leg].getZ()) {
+                continue;
+            }
+            VecPosition normal = toBall / dist;
+            VecPosition footVel = (player->footGlobal[leg] - player->lastFootGlobal[leg]) / KINSIM_STEP;
+            double footSpeed = footVel.dotProduct(normal);
+            double ballSpeed = ballVel.dotProduct(normal);
+            double kickSpeed = (1 + KS_KICK_RESTITUTION) * footSpeed;
+            if (kickSpeed > ballSpeed) {
+                ballVel += normal * (kickSpeed - ballSpeed);
+            }
+            ball += normal * (KS_BALL_RADIUS + KS_FOOT_RADIUS - dist);
+            fBallTouched = true;
+        }
+
+        VecPosition toBall = ball - VecPosition(player->x, player->y, ball.getZ());
+        double dist = toBall.getMagnitude();
+        if (dist < KS_BALL_RADIUS + KS_TORSO_RADIUS && dist > 0) {
+            VecPosition normal = toBall / dist;
+            ball += normal * (KS_BALL_RADIUS + KS_TORSO_RADIUS - dist);
+            double ballSpeed = ballVel.dotProduct(normal);
+            if (ballSpeed < 0) {
+                ballVel -= normal * ballSpeed;
+            }
+            fBallTouched = true;
+        }
+
+        for (size_t other = id + 1; other < players.size(); other++) {
+            KinSimPlayer* player2 = players[other];
+            if (player2 == NULL || !player2->fInitialized) {
+                continue;
+            }
+            VecPosition apart(player2->x - player->x, player2->y - player->y, 0);
+            double gap = apart.getMagnitude();
+            if (gap >= 2 * KS_TORSO_RADIUS || gap == 0) {
+                continue;
+            }
+            VecPosition push = apart * ((2 * KS_TORSO_RADIUS - gap) / gap / 2);
+            player->x -= push.getX();
+            player->y -= push.getY();
+            player2->x += push.getX();
+            player2->y += push.getY();
+        }
+    }
+
+    if (fBallTouched && (playMode == KS_KICK_OFF_LEFT || playMode == KS_KICK_OFF_RIGHT)) {
+        setPlayMode(KS_PLAY_ON);
+    }
+}
+
+/*
+ * Goals, and the ball put back on the field where it went out instead of
+ * a kick in.
+ */
+void KinSim::refereeBall() {
+    if (playMode == KS_PLAY_ON && fabs(ball.getX()) > HALF_FIELD_X &&
+            fabs(ball.getY()) < HALF_GOAL_Y && ball.getZ() < GOAL_Z) {
+        int scorer = ball.getX() > 0 ? SIDE_LEFT : SIDE_RIGHT;
+        score[scorer]++;
+        setPlayMode(scorer == SIDE_LEFT ? KS_GOAL_LEFT : KS_GOAL_RIGHT);
+    }
+
+    if (fabs(ball.getX()) > HALF_FIELD_X || fabs(ball.getY()) > HALF_FIELD_Y) {
+        ball.setX(max(-HALF_FIELD_X, min(HALF_FIELD_X, ball.getX())));
+        ball.setY(max(-HALF_FIELD_Y, min(HALF_FIELD_Y, ball.getY())));
+        ballVel = VecPosition(0, 0, 0);
+    }
+}
+
+void KinSim::refereeTime() {
+    double modeTime = time - playModeStartTime;
+
+    if (halfTime > 0 && gameTime >= halfTime && playMode != KS_GAME_OVER) {
+        setPlayMode(KS_GAME_OVER);
+    } else if (playMode == KS_GOAL_LEFT && modeTime >= KS_GOAL_PAUSE) {
+        setPlayMode(KS_KICK_OFF_RIGHT);
+    } else if (playMode == KS_GOAL_RIGHT && modeTime >= KS_GOAL_PAUSE) {
+        setPlayMode(KS_KICK_OFF_LEFT);
+    } else if ((playMode == KS_KICK_OFF_LEFT || playMode == KS_KICK_OFF_RIGHT) &&
+               modeTime >= KS_KICK_OFF_TIME) {
+        setPlayMode(KS_PLAY_ON);
+    } else if (playMode == KS_BEFORE_KICK_OFF && autoKickOffTime > 0 &&
+               modeTime >= autoKickOffTime) {
+        setPlayMode(KS_KICK_OFF_LEFT);
+    }
+}
+
+/*
+ * Sole of a foot relative to the torso and the foot's yaw, chaining the
+ * joints the same way as BodyModel::refreshComponent().
+ */
+void KinSim::computeFoot(const KinSimPlayer &player, int leg, VecPosition &pos, double &yaw) const {
+    int firstJoint = leg == 0 ? HJ_LL1 : HJ_RL1;
+    HCTMatrix m;
+    for (int link = 0; link < KS_LEG_LINKS; link++) {
+        m.multiply(HCTMatrix(HCT_TRANSLATE, legTranslation[leg][link] + legAnchor[link]));
+        m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, legAxis[leg][link],
+                             player.jointAngle[firstJoint + link]));
+        m.multiply(HCTMatrix(HCT_TRANSLATE, -legAnchor[link]));
+    }
+    pos = m.transform(VecPosition(0, 0, -KS_FOOT_HALF_HEIGHT));
+    VecPosition forward = m.transform(VecPosition(1, 0, 0)) - m.transform(VecPosition(0, 0, 0));
+    yaw = atan2(forward.getY(), forward.getX());
+}
+
+VecPosition KinSim::toGlobal(const KinSimPlayer &player, const VecPosition &local) const {
+    double c = cos(player.yaw);
+    double s = sin(player.yaw);
+    return VecPosition(player.x + c * local.getX() - s * local.getY(),
+                       player.y + s * local.getX() + c * local.getY(),
+                       player.z + local.getZ());
+}
+
+HCTMatrix KinSim::getWorldToCamera(const KinSimPlayer &player) const {
+    HCTMatrix m(HCT_TRANSLATE, VecPosition(player.x, player.y, player.z));
+    m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, VecPosition(0, 0, 1), player.yaw * 180 / M_PI));
+    m.multiply(HCTMatrix(HCT_TRANSLATE, VecPosition(0, 0, 0.09)));
+    m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, VecPosition(0, 0, 1), player.jointAngle[HJ_H1]));
+    m.multiply(HCTMatrix(HCT_TRANSLATE, VecPosition(0, 0, 0.065)));
+    m.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, VecPosition(0, -1, 0), player.jointAngle[HJ_H2]));
+    return m.getInverse();
+}
+
+bool KinSim::seePolar(const HCTMatrix &worldToCamera, const VecPosition &global, string &polar) const {
+    VecPosition local = worldToCamera.transform(global);
+    double flat = sqrt(local.getX() * local.getX() + local.getY() * local.getY());
+    double theta = atan2(local.getY(), local.getX()) * 180 / M_PI;
+    double phi = atan2(local.getZ(), flat) * 180 / M_PI;
+    if (fabs(theta) > KS_VIEW_ANGLE || fabs(phi) > KS_VIEW_ANGLE) {
+        return false;
+    }
+    stringstream ss;
+    ss << fixed << setprecision(2);
+    ss << "(pol " << local.getMagnitude() << " " << theta << " " << phi << ")";
+    polar = ss.str();
+    return true;
+}
+
+/*
+ * Positions as the server sends them with its ground truth patch, in the
+ * field coordinates of the player's team.
+ */
+string KinSim::groundTruth(const KinSimPlayer &player) const {
+    double flip = player.side == SIDE_LEFT ? 1 : -1;
+    double cameraYaw = player.yaw * 180 / M_PI + player.jointAngle[HJ_H1] +
+                       (player.side == SIDE_LEFT ? 0 : 180);
+    stringstream ss;
+    ss << fixed << setprecision(2);
+    ss << "(mypos " << flip * player.x << " " << flip * player.y << " " << player.z + KS_CAMERA_Z << ")";
+    ss << "(myorien " << VecPosition::normalizeAngle(cameraYaw) << ")";
+    ss << "(ballpos " << flip * ball.getX() << " " << flip * ball.getY() << " " << ball.getZ() << ")";
+    return ss.str();
+}
+
+string KinSim::perceive(int id) const {
+    if (!hasPlayer(id)) {
+        return "";
+    }
+    const KinSimPlayer &player = *players[id];
+
+    stringstream ss;
+    ss << fixed << setprecision(2);
+    ss << "(time (now " << time << "))";
+
+    ss << "(GS ";
+    if (player.fInitialized) {
+        ss << "(unum " << player.uNum << ") (team " << (player.side == SIDE_LEFT ? "left" : "right") << ") ";
+    }
+    ss << "(t " << gameTime << ") (pm " << playModeNames[playMode] << ")";
+    ss << " (sl " << score[SIDE_LEFT] << ") (sr " << score[SIDE_RIGHT] << "))";
+
+    ss << "(GYR (n torso) (rt 0.00 0.00 " << player.yawRate * 180 / M_PI << "))";
+    ss << "(ACC (n torso) (a 0.00 0.00 " << KS_GRAVITY << "))";
+
+    for (int j = 0; j < HJ_NUM; j++) {
+        // Only the toed body type has toes
+        if ((j == HJ_LL7 || j == HJ_RL7) && player.bodyType != 4) {
+            continue;
+        }
+        ss << "(HJ (n " << jointNames[j] << ") (ax " << player.jointAngle[j] << "))";
+    }
+
+    if (!player.fInitialized) {
+        return ss.str();
+    }
+
+    double lowest = min(player.footLocal[0].getZ(), player.footLocal[1].getZ());
+    int feetDown = 0;
+    for (int leg = 0; leg < 2; leg++) {
+        if (player.footLocal[leg].getZ() <= lowest + KS_DOUBLE_SUPPORT_Z) {
+            feetDown++;
+        }
+    }
+    for (int leg = 0; leg < 2; leg++) {
+        if (player.footLocal[leg].getZ() <= lowest + KS_DOUBLE_SUPPORT_Z) {
+            ss << "(FRP (n " << (leg == 0 ? "lf" : "rf") << ") (c 0.00 0.00 -0.01) (f 0.00 0.00 "
+               << KS_WEIGHT / feetDown << "))";
+        }
+    }
+
+    if (cycle % KINSIM_VISION_CYCLES == 0) {
+        HCTMatrix worldToCamera = getWorldToCamera(player);
+        string polar;
+        ss << "(See";
+        for (int i = 0; i < KS_NUM_LANDMARKS; i++) {
+            if (seePolar(worldToCamera, landmarks[i], polar)) {
+                ss << " (" << landmarkNames[i] << " " << polar << ")";
+            }
+        }
+        if (seePolar(worldToCamera, ball, polar)) {
+            ss << " (B " << polar << ")";
+        }
+        for (size_t other = 0; other < players.size(); other++) {
+            const KinSimPlayer* player2 = players[other];
+            if (player2 == NULL || !player2->fInitialized || (int)other == id) {
+                continue;
+            }
+            string parts;
+            VecPosition head = toGlobal(*player2, VecPosition(0, 0, KS_CAMERA_Z));
+            if (seePolar(worldToCamera, head, polar)) {
+                parts += " (head " + polar + ")";
+            }
+            if (seePolar(worldToCamera, player2->footGlobal[0], polar)) {
+                parts += " (lfoot " + polar + ")";
+            }
+            if (seePolar(worldToCamera, player2->footGlobal[1], polar)) {
+                parts += " (rfoot " + polar + ")";
+            }
+            if (!parts.empty()) {
+                ss << " (P (team " << teamNames[player2->side] << ") (id " << player2->uNum << ")"
+                   << parts << ")";
+            }
+        }
+        ss << " " << groundTruth(player) << ")";
+    }
+
+    for (size_t i = 0; i < heard.size(); i++) {
+        const KinSimPlayer* speaker = players[heard[i].speaker];
+        if (speaker == NULL) {
+            continue;
+        }
+        ss << "(hear " << teamNames[speaker->side] << " " << time << " ";
+        if (heard[i].speaker == id) {
+            ss << "self";
+        } else {
+            double direction = atan2(heard[i].pos.getY() - player.y, heard[i].pos.getX() - player.x) -
+                               player.yaw;
+            ss << VecPosition::normalizeAngle(direction * 180 / M_PI - player.jointAngle[HJ_H1]);
+        }
+        ss << " " << heard[i].message << ")";
+    }
+
+    return ss.str();
+}
@@ -0,0 +1,134 @@
+#ifndef KINSIM_H
+#define KINSIM_H
+
+#include <string>
+#include <vector>
+#include "../headers/headers.h"
+#include "../math/vecposition.h"
+#include "../math/hctmatrix.h"
+
+using namespace std;
+
+// Length of a simulation cycle in seconds, as in rcssserver3d
+#define KINSIM_STEP 0.02
+// Vision is sent every this many cycles
+#define KINSIM_VISION_CYCLES 3
+
+enum KinSimPlayMode {
+    KS_BEFORE_KICK_OFF,
+    KS_KICK_OFF_LEFT,
+    KS_KICK_OFF_RIGHT,
+    KS_PLAY_ON,
+    KS_GOAL_LEFT,
+    KS_GOAL_RIGHT,
+    KS_GAME_OVER,
+    KS_NUM_PLAY_MODES
+};
+
+/*
+ * A connected agent.  Its torso is a point mass kept upright, joints move
+ * at exactly the commanded speeds, and the torso is moved by keeping the
+ * lowest foot planted on the ground.
+ */
+struct KinSimPlayer {
+    bool fInitialized;   // has sent (init ...)
+    int side;            // SIDE_LEFT or SIDE_RIGHT
+    int uNum;
+    int bodyType;
+
+    // Torso in field coordinates of the left team, yaw in radians
+    double x, y, z, yaw;
+    double yawRate;
+
+    double jointAngle[HJ_NUM];   // degrees
+    double jointSpeed[HJ_NUM];   // radians per second, as commanded
+
+    // Feet relative to the torso last cycle, for moving the torso
+    VecPosition footLocal[2];
+    double footYaw[2];
+    bool fFeetKnown;
+    // Feet on the field this and last cycle, for kicking
+    VecPosition footGlobal[2];
+    VecPosition lastFootGlobal[2];
+
+    string sayMessage;
+};
+
+class KinSim {
+public:
+    KinSim(double halfTime, double autoKickOffTime);
+    ~KinSim();
+
+    // Adds a player for a new connection and returns its id
+    int addPlayer();
+    void removePlayer(int id);
+    bool hasPlayer(int id) const;
+
+    // Applies the effector commands in a message from player id
+    void act(int id, const string &message);
+    // Applies training command parser commands, such as
+    // (playMode PlayOn) or (ball (pos 0 0 0.042) (vel 0 0 0))
+    void command(const string &message);
+
+    // Advances the world by one cycle
+    void step();
+
+    // Perceptor message for player id for the current cycle
+    string perceive(int id) const;
+
+    bool isKilled() const {
+        return fKilled;
+    }
+    double getTime() const {
+        return time;
+    }
+
+private:
+    // Owns the players, so not copyable
+    KinSim(const KinSim&);
+    KinSim& operator=(const KinSim&);
+
+    vector<KinSimPlayer*> players;
+    string teamNames[2];
+    int score[2];
+
+    double time;
+    double gameTime;
+    int cycle;
+    KinSimPlayMode playMode;
+    double playModeStartTime;
+    double halfTime;
+    double autoKickOffTime;
+    bool fKilled;
+
+    VecPosition ball;
+    VecPosition ballVel;
+    bool fBallTouched;
+
+    // Say messages of last cycle, heard this cycle
+    struct Heard {
+        int speaker;
+        VecPosition pos;
+        string message;
+    };
+    vector<Heard> heard;
+
+    void initPlayer(KinSimPlayer &player, const string &message);
+    void beam(KinSimPlayer &player, double beamX, double beamY, double beamAngle);
+    void setPlayMode(KinSimPlayMode mode);
+
+    void moveJoints(KinSimPlayer &player);
+    void moveTorso(KinSimPlayer &player);
+    void moveBall();
+    void collide();
+    void refereeBall();
+    void refereeTime();
+
+    void computeFoot(const KinSimPlayer &player, int leg, VecPosition &pos, double &yaw) const;
+    VecPosition toGlobal(const KinSimPlayer &player, const VecPosition &local) const;
+    HCTMatrix getWorldToCamera(const KinSimPlayer &player) const;
+    bool seePolar(const HCTMatrix &worldToCamera, const VecPosition &global, string &polar) const;
+    string groundTruth(const KinSimPlayer &player) const;
+};
+
+#endif
@@ -0,0 +1,300 @@
+/*
+ * kinsim: a kinematic stand-in for rcssserver3d, fast enough to run many
+ * optimization evaluations at once.
+ *
+ * Agents connect to the agent port and talk the server's protocol: length
+ * prefixed S-expressions, effector commands in and time, GS, GYR, ACC, HJ,
+ * FRP, See and hear perceptors out.  The monitor port takes the training
+ * commands the optimization agents send, such as (playMode PlayOn) or
+ * (ball (pos x y z) (vel x y z)), and sends nothing back.  See KinSim for
+ * what is (and is not) simulated.
+ *
+ * By default the simulation runs in agent sync mode: a cycle is stepped as
+ * soon as every agent has answered the last one with (syn), so it runs as
+ * fast as the agents think.  --realtime steps every 20 ms instead.
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "kinsim.h"
+
+using namespace std;
+
+struct Client {
+    int fd;
+    bool fAgent;
+    int playerID;
+    string buffer;
+    // Has answered the last perceptor message, for agent sync mode
+    bool fSynced;
+};
+
+// Options
+int agentPort = 3100;
+int monitorPort = 3200;
+double halfTime = 0;
+double autoKickOffTime = 0;
+bool fRealTime = false;
+
+static bool gLoop = true;
+
+extern "C" void handler(int sig) {
+    gLoop = false;
+}
+
+double now() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+int listenOn(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw string("Could not create a socket: ") + strerror(errno);
+    }
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+        close(fd);
+        throw string("Could not listen on port ") + strerror(errno);
+    }
+    return fd;
+}
+
+bool sendMessage(int fd, const string &msg) {
+    unsigned int len = htonl(msg.size());
+    string prefixed = string((const char*)&len, sizeof(len)) + msg;
+    size_t sent = 0;
+    while (sent < prefixed.size()) {
+        ssize_t n = write(fd, prefixed.data() + sent, prefixed.size() - sent);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+/*
+ * Reads what arrived from a client and moves every complete message to
+ * messages.  Returns false when the client is gone.
+ */
+bool receiveMessages(Client &client, vector<string> &messages) {
+    char buf[16384];
+    ssize_t n = read(client.fd, buf, sizeof(buf));
+    if (n < 0 && errno == EINTR) {
+        return true;
+    }
+    if (n <= 0) {
+        return false;
+    }
+    client.buffer.append(buf, n);
+
+    while (client.buffer.size() >= 4) {
+        unsigned int len;
+        memcpy(&len, client.buffer.data(), sizeof(len));
+        len = ntohl(len);
+        if (client.buffer.size() < 4 + len) {
+            break;
+        }
+        messages.push_back(client.buffer.substr(4, len));
+        client.buffer.erase(0, 4 + len);
+    }
+    return true;
+}
+
+void acceptClient(int listenFD, bool fAgent, KinSim &sim, vector<Client> &clients) {
+    int fd = accept(listenFD, NULL, NULL);
+    if (fd < 0) {
+        return;
+    }
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+    Client client;
+    client.fd = fd;
+    client.fAgent = fAgent;
+    client.playerID = fAgent ? sim.addPlayer() : -1;
+    // Joins the sync with the next perceptor message
+    client.fSynced = true;
+    clients.push_back(client);
+}
+
+void printHelp() {
+    cout << "usage: kinsim [options]\n";
+    cout << " --agent-port <port>\tport agents connect to (default: 3100)\n";
+    cout << " --server-port <port>\tmonitor port for training commands (default: 3200)\n";
+    cout << " --halftime <seconds>\tgame time until GameOver, 0 for none (default: 0)\n";
+    cout << " --autokickoff <seconds>\tkick off this long after BeforeKickOff starts, 0 for never (default: 0)\n";
+    cout << " --realtime\tstep every 20 ms instead of waiting for every agent's (syn)\n";
+}
+
+void readOptions(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--help") {
+            printHelp();
+            exit(0);
+        } else if (option == "--realtime") {
+            fRealTime = true;
+            continue;
+        } else if (i == argc - 1) {
+            printHelp();
+            exit(1);
+        }
+        string value = argv[++i];
+        if (option == "--agent-port") {
+            agentPort = atoi(value.c_str());
+        } else if (option == "--server-port") {
+            monitorPort = atoi(value.c_str());
+        } else if (option == "--halftime") {
+            halfTime = atof(value.c_str());
+        } else if (option == "--autokickoff") {
+            autoKickOffTime = atof(value.c_str());
+        } else {
+            printHelp();
+            exit(1);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    signal(SIGINT, handler);
+    signal(SIGTERM, handler);
+    signal(SIGPIPE, SIG_IGN);
+
+    readOptions(argc, argv);
+
+    int agentListenFD, monitorListenFD;
+    try {
+        agentListenFD = listenOn(agentPort);
+        monitorListenFD = listenOn(monitorPort);
+    }
+    catch (string s) {
+        cerr << s << endl;
+        return 1;
+    }
+    cerr << "kinsim: agents on port " << agentPort << ", monitor on port " << monitorPort << endl;
+
+    KinSim sim(halfTime, autoKickOffTime);
+    vector<Client> clients;
+    double nextStep = now() + KINSIM_STEP;
+
+    while (gLoop && !sim.isKilled()) {
+        bool fAllSynced = true;
+        int numAgents = 0;
+        for (size_t i = 0; i < clients.size(); i++) {
+            if (clients[i].fAgent) {
+                numAgents++;
+                fAllSynced = fAllSynced && clients[i].fSynced;
+            }
+        }
+
+        // Step, and send everybody what they perceive
+        bool fStep = fRealTime ? now() >= nextStep : numAgents > 0 && fAllSynced;
+        if (fStep) {
+            sim.step();
+            nextStep += KINSIM_STEP;
+            if (nextStep < now()) {
+                nextStep = now() + KINSIM_STEP;
+            }
+            for (size_t i = 0; i < clients.size(); i++) {
+                if (clients[i].fAgent) {
+                    sendMessage(clients[i].fd, sim.perceive(clients[i].playerID));
+                    clients[i].fSynced = false;
+                }
+            }
+        }
+
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(agentListenFD, &readfds);
+        FD_SET(monitorListenFD, &readfds);
+        int maxFD = max(agentListenFD, monitorListenFD);
+        for (size_t i = 0; i < clients.size(); i++) {
+            FD_SET(clients[i].fd, &readfds);
+            maxFD = max(maxFD, clients[i].fd);
+        }
+        struct timeval timeout;
+        struct timeval* timeoutPtr = NULL;
+        if (fRealTime) {
+            double wait = max(0.0, nextStep - now());
+            timeout.tv_sec = (long)wait;
+            timeout.tv_usec = (long)((wait - timeout.tv_sec) * 1e6);
+            timeoutPtr = &timeout;
+        }
+        if (select(maxFD + 1, &readfds, NULL, NULL, timeoutPtr) < 0) {
+            if (errno != EINTR) {
+                cerr << "select failed: " << strerror(errno) << endl;
+                break;
+            }
+            continue;
+        }
+
+        if (FD_ISSET(agentListenFD, &readfds)) {
+            acceptClient(agentListenFD, true, sim, clients);
+        }
+        if (FD_ISSET(monitorListenFD, &readfds)) {
+            acceptClient(monitorListenFD, false, sim, clients);
+        }
+
+        for (size_t i = 0; i < clients.size(); i++) {
+            Client &client = clients[i];
+            if (!FD_ISSET(client.fd, &readfds)) {
+                continue;
+            }
+            vector<string> messages;
+            bool fConnected = receiveMessages(client, messages);
+            for (size_t m = 0; m < messages.size(); m++) {
+                if (client.fAgent) {
+                    sim.act(client.playerID, messages[m]);
+                    if (messages[m].find("(syn)") != string::npos) {
+                        client.fSynced = true;
+                    }
+                } else {
+                    sim.command(messages[m]);
+                }
+            }
+            if (!fConnected) {
+                close(client.fd);
+                sim.removePlayer(client.playerID);
+                client.fd = -1;
+            }
+        }
+        for (size_t i = clients.size(); i-- > 0; ) {
+            if (clients[i].fd < 0) {
+                clients.erase(clients.begin() + i);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < clients.size(); i++) {
+        close(clients[i].fd);
+    }
+    close(agentListenFD);
+    close(monitorListenFD);
+    return 0;
+}
@@ -7,11 +7,14 @@
 //#include <rcssnet/udpsocket.hpp>
 #include <rcssnet/exception.hpp>
 #include <netinet/in.h>
+#include <sys/stat.h>
+#include <vector>
 #include "behaviors/behavior.h"
 #include "behaviors/naobehavior.h"
 #include "optimization/optimizationbehaviors.h"
 #include "behaviors/pkbehaviors.h"
 #include "behaviors/gazebobehavior.h"
+#include <common/ParamRegistry.h>
 
 using namespace rcss::net;
 using namespace std;
@@ -36,6 +39,10 @@ static bool gLoop = true;
 // (should probably make this not global and store this value in a better way)
 int agentBodyType = 0;
 
+// Global variable for running motion on its own thread, separate from
+// perception and strategy (exported like agentBodyType)
+bool useMotionThread = false;
+
 // SIGINT handler prototype
 extern "C" void handler(int sig)
 {
@@ -61,12 +68,16 @@ void PrintHelp()
     cout << " --team <TeamName>\tName of Team." << endl;
     cout << " --unum <UNum>\tUniform Number of Player." << endl;
     cout << " --paramsfile <filename>\tname of a parameters file to be loaded" << endl;
+    cout << " --paramswatch <filename>\tlike --paramsfile, reloads all parameters and restarts the behavior whenever this file changes" << endl;
     cout << " --pkgoalie\tgoalie for penalty kick shootout" << endl;
     cout << " --pkshooter\tshooter for penalty kick shootout" << endl;
     cout << " --gazebo\tagent for Gazebo RoboCup 3D simulation plugin" << endl;
     cout << " --optimize <agent-type>\toptimization agent type" << endl;
+    cout << " --experimentstats <filename>\tfile to append the running fitness statistics of an optimization to" << endl;
     cout << " --mhost=<IP>\tIP of the monitor for sending draw commands" << endl;
     cout << " --mport <port>\tport of the monitor for training command parser" << endl;
+    cout << " --motionthread\trun motion on its own high priority thread" << endl;
+    cout << " --recordmessages <filename>\tfile to write every message received from the server to, one per line" << endl;
 
     cout << "\n";
 }
@@ -77,11 +88,11 @@ void PrintHelp()
  * with a set of parameters as key value pairs from strings to
  * floats.  The parameter name should be separated from its value
  * with a tab and parameters should be separated from each other
- * with a single newline.  Parameters will be loaded into the
- * namedParams map.
+ * with a single newline.  Parameters will be loaded into params,
+ * later files overriding earlier ones.  Returns false if the file can't
+ * be opened.
  */
-map<string, string> namedParams;
-void LoadParams(const string& inputsFile) {
+bool LoadParams(const string& inputsFile, ParamRegistry& params) {
     istream *input;
     ifstream infile;
     istringstream inString;
@@ -90,7 +101,7 @@ void LoadParams(const string& inputsFile) {
 
     if(!infile) {
         cerr << "Could not open parameter file " << inputsFile << endl;
-        exit(1);
+        return false;
     }
 
     input = &(infile);
@@ -121,18 +132,91 @@ void LoadParams(const string& inputsFile) {
         if(value.empty()) {
             continue;
         }
-        namedParams[key] = value;
+        params.set(key, value);
     }
 
     infile.close();
+    return true;
+}
+
+
+// Parameter files in the order they were given, all loaded again when the
+// file given with --paramswatch changes
+vector<string> paramsFiles;
+string paramsWatchFile("");
+struct stat paramsWatchStat;
+bool fParamsWatchMissing = false;
+
+bool StatParamsWatchFile(struct stat& st) {
+    if (stat(paramsWatchFile.c_str(), &st) != 0) {
+        // Only once while it is missing, as it is between the unlink and
+        // the write of a replace that isn't a rename
+        if (!fParamsWatchMissing) {
+            cerr << "Could not stat watched parameter file " << paramsWatchFile << endl;
+            fParamsWatchMissing = true;
+        }
+        return false;
+    }
+    fParamsWatchMissing = false;
+    return true;
+}
+
+/*
+ * Loads all parameter files again if the file given with --paramswatch
+ * was replaced or modified since it was last loaded, and hands them to
+ * behavior.  The files are loaded into a scratch registry and checked
+ * there, so if one can't be read, a declared parameter is missing or the
+ * skills don't compile with them, the agent keeps running on the old
+ * parameters until the file changes again.  Writers should write a
+ * temporary file and rename it over the watched one so that it is never
+ * read half written.
+ */
+void ReloadParamsIfChanged(Behavior* behavior) {
+    if (paramsWatchFile.empty()) {
+        return;
+    }
+
+    struct stat st;
+    if (!StatParamsWatchFile(st) ||
+            (st.st_ino == paramsWatchStat.st_ino &&
+             st.st_mtim.tv_sec == paramsWatchStat.st_mtim.tv_sec &&
+             st.st_mtim.tv_nsec == paramsWatchStat.st_mtim.tv_nsec)) {
+        return;
+    }
+    paramsWatchStat = st;
+
+    // A copy keeps the handles of every Param
+    ParamRegistry params(getParams());
+    params.clearValues();
+    for (size_t i = 0; i < paramsFiles.size(); i++) {
+        if (!LoadParams(paramsFiles[i], params)) {
+            cerr << "Keeping the old parameters" << endl;
+            return;
+        }
+    }
+    try {
+        params.checkDeclared();
+    }
+    catch (std::string& what) {
+        cerr << what << "; keeping the old parameters" << endl;
+        return;
+    }
+
+    if (behavior->reloadParameters(params)) {
+        cerr << "Reloaded parameters from " << paramsWatchFile << endl;
+    }
 }
 
 
 string teamName;
 int uNum;
 string outputFile(""); // For optimization
+string statsFile(""); // Running fitness statistics of an optimization
 string agentType("naoagent");
 string rsg("rsg/agent/nao/nao.rsg");
+// Server messages are written here when given, such as for replaying them
+// through the parser benchmark in tests/
+ofstream recordFile;
 void ReadOptions(int argc, char* argv[])
 {
 
@@ -203,7 +287,26 @@ void ReadOptions(int argc, char* argv[])
                 exit(0);
             }
             string inputsFile = argv[i+1];
-            LoadParams(inputsFile);
+            if (!LoadParams(inputsFile, getParams())) {
+                exit(1);
+            }
+            paramsFiles.push_back(inputsFile);
+        }
+        else if(strcmp(argv[i], "--paramswatch") == 0) {
+            if(i == argc - 1) {
+                PrintHelp();
+                exit(0);
+            }
+            // Stat before loading so that a change made while loading
+            // is picked up
+            paramsWatchFile = argv[i+1];
+            if (!StatParamsWatchFile(paramsWatchStat)) {
+                exit(1);
+            }
+            if (!LoadParams(paramsWatchFile, getParams())) {
+                exit(1);
+            }
+            paramsFiles.push_back(paramsWatchFile);
         }
         else if (strcmp(argv[i], "--experimentout") == 0) {
             if(i == argc - 1) {
@@ -212,6 +315,13 @@ void ReadOptions(int argc, char* argv[])
             }
             outputFile = argv[i+1];
         }
+        else if (strcmp(argv[i], "--experimentstats") == 0) {
+            if(i == argc - 1) {
+                PrintHelp();
+                exit(0);
+            }
+            statsFile = argv[i+1];
+        }
         else if (strcmp(argv[i], "--optimize") == 0) {
             if(i == argc - 1) {
                 PrintHelp();
@@ -243,6 +353,20 @@ void ReadOptions(int argc, char* argv[])
 	else if (strcmp(argv[i], "--gazebo") == 0) {
             agentType = "gazebo";
         }
+        else if (strcmp(argv[i], "--motionthread") == 0) {
+            useMotionThread = true;
+        }
+        else if (strcmp(argv[i], "--recordmessages") == 0) {
+            if(i == argc - 1) {
+                PrintHelp();
+                exit(0);
+            }
+            recordFile.open(argv[i+1]);
+            if (!recordFile) {
+                cerr << "Could not open " << argv[i+1] << " to record messages to" << endl;
+                exit(1);
+            }
+        }
     } // for-loop
 }
 
@@ -476,39 +600,41 @@ void Run()
 {
     Behavior *behavior;
     if (agentType == "naoagent") {
-        behavior = new NaoBehavior(teamName, uNum, namedParams, rsg);
+        behavior = new NaoBehavior(teamName, uNum, getParams(), rsg);
     }
     else if (agentType == "pkgoalie") {
-        behavior = new PKGoalieBehavior(teamName, uNum, namedParams, rsg);
+        behavior = new PKGoalieBehavior(teamName, uNum, getParams(), rsg);
     }
     else if (agentType == "pkshooter") {
-        behavior = new PKShooterBehavior(teamName, uNum, namedParams, rsg);
+        behavior = new PKShooterBehavior(teamName, uNum, getParams(), rsg);
     }
     else if (agentType == "gazebo") {
       agentBodyType = GAZEBO_AGENT_TYPE;
-        behavior = new GazeboBehavior(teamName, uNum, namedParams, rsg);
+        behavior = new GazeboBehavior(teamName, uNum, getParams(), rsg);
     }
     else if (agentType == "fixedKickAgent") {
         cerr << "creating OptimizationBehaviorFixedKick" << endl;
         behavior = new OptimizationBehaviorFixedKick(  teamName,
                 uNum,
-                namedParams,
+                getParams(),
                 rsg,
-                outputFile);
+                outputFile,
+                statsFile);
     }
     else if (agentType == "walkForwardAgent") {
         cerr << "creating OptimizationBehaviorWalkForward" << endl;
         behavior = new OptimizationBehaviorWalkForward(  teamName,
                 uNum,
-                namedParams,
+                getParams(),
                 rsg,
-                outputFile);
+                outputFile,
+                statsFile);
     }
     else if (agentType == "StandAgent") {
            cerr << "creating OptimizationBehaviorStand" << endl;
            behavior = new OptimizationBehaviorStand(  teamName,
                    uNum,
-                   namedParams,
+                   getParams(),
                    rsg,
                    outputFile);
        }
@@ -522,6 +648,9 @@ void Run()
     while (gLoop)
     {
         GetMessage(msg);
+        if (recordFile.is_open()) {
+            recordFile << msg << "\n";
+        }
         string msgToServer = behavior->Think(msg);
         // To support agent sync mode
         msgToServer.append("(syn)");
@@ -529,6 +658,9 @@ void Run()
         if (mPort != -1) {
             PutMonMessage(behavior->getMonMessage());
         }
+
+        // New parameters take effect without reconnecting to the server
+        ReloadParamsIfChanged(behavior);
     }
 }
 
@@ -544,6 +676,10 @@ main(int argc, char* argv[])
         PrintGreeting();
         ReadOptions(argc,argv);
 
+        // Fail now rather than in the middle of a game if a parameter the
+        // code needs is not in any of the parameter files
+        getParams().checkDeclared();
+
         if (! Init())
         {
             return 1;
@@ -0,0 +1,284 @@
+#ifndef AFFINE3F_H
+#define AFFINE3F_H
+
+#include "vecposition.h"
+#include "hctmatrix.h"
+
+#include <cmath>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+/*
+ * Single precision counterparts of VecPosition and HCTMatrix for the hot
+ * kinematics paths, such as refreshing the body model's transforms every
+ * cycle.  Every operation is inline and works on four floats at once, with
+ * SSE where the compiler has it.  Storage is plain floats read with
+ * unaligned loads, so these can live anywhere, including inside classes
+ * allocated with new.
+ *
+ * Convert from and to VecPosition and HCTMatrix at the boundaries; results
+ * carry float precision, about 1e-7 relative.  The lane helpers in
+ * affine3f_detail serve other batched float math too, such as scoring
+ * kick targets.
+ */
+
+namespace affine3f_detail {
+
+#ifdef __SSE__
+typedef __m128 Lanes;
+
+inline Lanes load(const float *f) {
+    return _mm_loadu_ps(f);
+}
+inline void store(float *f, Lanes a) {
+    _mm_storeu_ps(f, a);
+}
+inline Lanes splat(float x) {
+    return _mm_set1_ps(x);
+}
+inline Lanes add(Lanes a, Lanes b) {
+    return _mm_add_ps(a, b);
+}
+inline Lanes sub(Lanes a, Lanes b) {
+    return _mm_sub_ps(a, b);
+}
+inline Lanes mul(Lanes a, Lanes b) {
+    return _mm_mul_ps(a, b);
+}
+inline Lanes sqrt(Lanes a) {
+    return _mm_sqrt_ps(a);
+}
+inline Lanes abs(Lanes a) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+}
+// v in the lanes where a < b, 0 in the others
+inline Lanes ifLess(Lanes a, Lanes b, Lanes v) {
+    return _mm_and_ps(_mm_cmplt_ps(a, b), v);
+}
+#else
+struct Lanes {
+    float f[4];
+};
+
+inline Lanes load(const float *f) {
+    Lanes a = {{f[0], f[1], f[2], f[3]}};
+    return a;
+}
+inline void store(float *f, const Lanes &a) {
+    f[0] = a.f[0];
+    f[1] = a.f[1];
+    f[2] = a.f[2];
+    f[3] = a.f[3];
+}
+inline Lanes splat(float x) {
+    Lanes a = {{x, x, x, x}};
+    return a;
+}
+inline Lanes add(const Lanes &a, const Lanes &b) {
+    Lanes r = {{a.f[0] + b.f[0], a.f[1] + b.f[1], a.f[2] + b.f[2], a.f[3] + b.f[3]}};
+    return r;
+}
+inline Lanes sub(const Lanes &a, const Lanes &b) {
+    Lanes r = {{a.f[0] - b.f[0], a.f[1] - b.f[1], a.f[2] - b.f[2], a.f[3] - b.f[3]}};
+    return r;
+}
+inline Lanes mul(const Lanes &a, const Lanes &b) {
+    Lanes r = {{a.f[0] * b.f[0], a.f[1] * b.f[1], a.f[2] * b.f[2], a.f[3] * b.f[3]}};
+    return r;
+}
+inline Lanes sqrt(const Lanes &a) {
+    Lanes r = {{std::sqrt(a.f[0]), std::sqrt(a.f[1]), std::sqrt(a.f[2]), std::sqrt(a.f[3])}};
+    return r;
+}
+inline Lanes abs(const Lanes &a) {
+    Lanes r = {{std::fabs(a.f[0]), std::fabs(a.f[1]), std::fabs(a.f[2]), std::fabs(a.f[3])}};
+    return r;
+}
+inline Lanes ifLess(const Lanes &a, const Lanes &b, const Lanes &v) {
+    Lanes r;
+    for (int i = 0; i < 4; i++) {
+        r.f[i] = a.f[i] < b.f[i] ? v.f[i] : 0;
+    }
+    return r;
+}
+#endif
+
+}
+
+
+// A point or direction in x, y and z, with a fourth lane that is always 0
+struct Vec3f {
+
+    float v[4];
+
+    Vec3f() {
+        v[0] = v[1] = v[2] = v[3] = 0;
+    }
+    Vec3f(float x, float y, float z) {
+        v[0] = x;
+        v[1] = y;
+        v[2] = z;
+        v[3] = 0;
+    }
+    explicit Vec3f(const VecPosition &p) {
+        v[0] = p.getX();
+        v[1] = p.getY();
+        v[2] = p.getZ();
+        v[3] = 0;
+    }
+
+    float getX() const {
+        return v[0];
+    }
+    float getY() const {
+        return v[1];
+    }
+    float getZ() const {
+        return v[2];
+    }
+
+    VecPosition toVecPosition() const {
+        return VecPosition(v[0], v[1], v[2]);
+    }
+
+    inline Vec3f operator + (const Vec3f &p) const {
+        Vec3f r;
+        affine3f_detail::store(r.v, affine3f_detail::add(affine3f_detail::load(v), affine3f_detail::load(p.v)));
+        return r;
+    }
+    inline Vec3f operator - (const Vec3f &p) const {
+        Vec3f r;
+        affine3f_detail::store(r.v, affine3f_detail::sub(affine3f_detail::load(v), affine3f_detail::load(p.v)));
+        return r;
+    }
+    inline Vec3f operator - () const {
+        return Vec3f() - *this;
+    }
+    inline Vec3f operator * (float d) const {
+        Vec3f r;
+        affine3f_detail::store(r.v, affine3f_detail::mul(affine3f_detail::load(v), affine3f_detail::splat(d)));
+        return r;
+    }
+    inline float dotProduct(const Vec3f &p) const {
+        return v[0] * p.v[0] + v[1] * p.v[1] + v[2] * p.v[2];
+    }
+};
+
+
+// A rigid transform: a 4x4 homogeneous matrix whose last row is (0 0 0 1),
+// stored by column
+class Affine3f {
+
+private:
+
+    float col[4][4];
+
+public:
+
+    // The identity
+    Affine3f() {
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < 4; ++i) {
+                col[j][i] = (i == j) ? 1 : 0;
+            }
+        }
+    }
+
+    explicit Affine3f(const HCTMatrix &m) {
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < 4; ++i) {
+                col[j][i] = m.getCell(i, j);
+            }
+        }
+    }
+
+    HCTMatrix toHCTMatrix() const {
+        HCTMatrix m;
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < 4; ++i) {
+                m.setCell(i, j, col[j][i]);
+            }
+        }
+        return m;
+    }
+
+    inline float getCell(int i, int j) const {
+        return col[j][i];
+    }
+
+    static inline Affine3f translation(const Vec3f &v) {
+        Affine3f m;
+        m.col[3][0] = v.v[0];
+        m.col[3][1] = v.v[1];
+        m.col[3][2] = v.v[2];
+        return m;
+    }
+
+    // Right handed rotation of theta degrees about a unit axis, as
+    // HCTMatrix(HCT_GENERALIZED_ROTATE, axis, theta)
+    static inline Affine3f rotation(const Vec3f &axis, double theta) {
+        double sd, cd;
+        sinCosDeg(theta, sd, cd);
+        float s = sd;
+        float c = cd;
+        float t = 1 - c;
+        float X = axis.v[0];
+        float Y = axis.v[1];
+        float Z = axis.v[2];
+
+        Affine3f m;
+        m.col[0][0] = (t * X * X) + c;
+        m.col[0][1] = (t * X * Y) + (s * Z);
+        m.col[0][2] = (t * X * Z) - (s * Y);
+
+        m.col[1][0] = (t * X * Y) - (s * Z);
+        m.col[1][1] = (t * Y * Y) + c;
+        m.col[1][2] = (t * Y * Z) + (s * X);
+
+        m.col[2][0] = (t * X * Z) + (s * Y);
+        m.col[2][1] = (t * Y * Z) - (s * X);
+        m.col[2][2] = (t * Z * Z) + c;
+        return m;
+    }
+
+    // this = this * m, as HCTMatrix::multiply
+    inline void multiply(const Affine3f &m) {
+        using namespace affine3f_detail;
+        Lanes c0 = load(col[0]);
+        Lanes c1 = load(col[1]);
+        Lanes c2 = load(col[2]);
+        Lanes c3 = load(col[3]);
+        Lanes r[4];
+        for (int j = 0; j < 4; ++j) {
+            const float *b = m.col[j];
+            r[j] = mul(c0, splat(b[0]));
+            r[j] = add(r[j], mul(c1, splat(b[1])));
+            r[j] = add(r[j], mul(c2, splat(b[2])));
+            r[j] = add(r[j], mul(c3, splat(b[3])));
+        }
+        // Stored last so that m may be this
+        for (int j = 0; j < 4; ++j) {
+            store(col[j], r[j]);
+        }
+    }
+
+    inline Vec3f transform(const Vec3f &p) const {
+        using namespace affine3f_detail;
+        Lanes r = load(col[3]);
+        r = add(r, mul(load(col[0]), splat(p.v[0])));
+        r = add(r, mul(load(col[1]), splat(p.v[1])));
+        r = add(r, mul(load(col[2]), splat(p.v[2])));
+        Vec3f result;
+        store(result.v, r);
+        result.v[3] = 0;
+        return result;
+    }
+
+    inline VecPosition transform(const VecPosition &p) const {
+        return transform(Vec3f(p)).toVecPosition();
+    }
+};
+
+#endif // AFFINE3F_H
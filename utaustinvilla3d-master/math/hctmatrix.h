@@ -75,8 +75,8 @@ public:
 
     inline void createRotateX(const double &theta) {
 
-        double cos = cosDeg(-theta);
-        double sin = sinDeg(-theta);
+        double sin, cos;
+        sinCosDeg(-theta, sin, cos);
 
         setCell(0, 0, 1.0);
         setCell(0, 1, 0);
@@ -98,8 +98,8 @@ public:
 
     inline void createRotateY(const double &theta) {
 
-        double cos = cosDeg(-theta);
-        double sin = sinDeg(-theta);
+        double sin, cos;
+        sinCosDeg(-theta, sin, cos);
 
         setCell(0, 0, cos);
         setCell(0, 1, 0);
@@ -121,8 +121,8 @@ public:
 
     inline void createRotateZ(const double &theta) {
 
-        double cos = cosDeg(-theta);
-        double sin = sinDeg(-theta);
+        double sin, cos;
+        sinCosDeg(-theta, sin, cos);
 
         setCell(0, 0, cos);
         setCell(0, 1, -sin);
@@ -148,9 +148,9 @@ public:
         double Y = axis.getY();
         double Z = axis.getZ();
 
-        double c = cosDeg(theta);
+        double s, c;
+        sinCosDeg(theta, s, c);
         double t = 1 - c;
-        double s = sinDeg(theta);
 
         //First row
         setCell(0, 0, (t * X * X) + c);
@@ -318,6 +318,19 @@ public:
         return result;
     }
 
+    // Transforms n points from in to out, which may be the same array
+    inline void transform(const VecPosition *in, VecPosition *out, int n) const {
+        const double m00 = cell[0][0], m01 = cell[0][1], m02 = cell[0][2], m03 = cell[0][3];
+        const double m10 = cell[1][0], m11 = cell[1][1], m12 = cell[1][2], m13 = cell[1][3];
+        const double m20 = cell[2][0], m21 = cell[2][1], m22 = cell[2][2], m23 = cell[2][3];
+        for (int i = 0; i < n; i++) {
+            const double px = in[i].getX(), py = in[i].getY(), pz = in[i].getZ();
+            out[i].setVecPosition(m00 * px + m01 * py + m02 * pz + m03,
+                                  m10 * px + m11 * py + m12 * pz + m13,
+                                  m20 * px + m21 * py + m22 * pz + m23);
+        }
+    }
+
     inline bool isIdentity() {
         bool result = true;
         for (int i = 0; i < 4; i++) {
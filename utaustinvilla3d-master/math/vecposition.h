@@ -32,6 +32,14 @@ inline double sinDeg( double x )
     return ( sin( Deg2Rad( x ) ) );
 }
 
+// Both at once, which the compiler turns into a single sincos call
+inline void sinCosDeg( double x, double &s, double &c )
+{
+    double rad = Deg2Rad( x );
+    s = sin( rad );
+    c = cos( rad );
+}
+
 inline double tanDeg( double x )
 {
     return ( tan( Deg2Rad( x ) ) );
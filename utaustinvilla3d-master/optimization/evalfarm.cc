@@ -0,0 +1,584 @@
+/*
+ * evalfarm: evaluates parameter files on several rcssserver3d + agentspark
+ * pairs at once.
+ *
+ * Names of parameter files are read from stdin, one per line, as they
+ * come, and for each a line "<file>\t<fitness>" (or "<file>\tfailed") is
+ * printed to stdout as soon as it is evaluated, so results arrive out of
+ * order.  Every worker owns a server and an agent on free ports.  The agent
+ * runs with --paramswatch, so after the first evaluation new parameters are
+ * handed over by renaming them onto the watched file, without restarting
+ * anything, and the fitness comes back through a named pipe given as the
+ * agent's --experimentout.  A pair that doesn't deliver a fitness in time
+ * or that dies is killed and started again, and its evaluation is retried.
+ *
+ * Run it from the directory agentspark is normally started in (the skill
+ * files are read relative to it), like sample_start-optimization.sh.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct Job {
+    string paramsFile;
+    int attempts;
+};
+
+enum WorkerState {
+    WORKER_DOWN,        // no server or agent running
+    WORKER_STARTING,    // server started, waiting for it to accept connections
+    WORKER_EVALUATING,  // agent running a task, waiting for its fitness
+    WORKER_IDLE         // agent done, ready for the next parameters
+};
+
+struct Worker {
+    int id;
+    string dir;
+    string watchFile;
+    string fitnessPipe;
+    int pipeFD;
+    string pipeBuffer;
+
+    WorkerState state;
+    pid_t serverPID;
+    pid_t agentPID;
+    int agentPort;
+    int monitorPort;
+    double deadline;
+
+    bool fHasJob;
+    Job job;
+};
+
+// Options
+int numWorkers = 1;
+string agentType = "fixedKickAgent";
+int agentBodyType = 0;
+double evalTimeout = 300;
+double startTimeout = 30;
+int maxRetries = 2;
+string serverBinary = "rcssserver3d";
+string agentBinary = "./agentspark";
+string workDir = "";
+
+static bool gLoop = true;
+
+extern "C" void handler(int sig) {
+    gLoop = false;
+}
+
+double now() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/*
+ * A port nobody is listening on right now.  Someone else could still take
+ * it before the server binds it, which shows up as a failed start and is
+ * retried with new ports.
+ */
+int getFreePort() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    int port = -1;
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+            getsockname(fd, (struct sockaddr*)&addr, &len) == 0) {
+        port = ntohs(addr.sin_port);
+    }
+    close(fd);
+    return port;
+}
+
+bool isAcceptingConnections(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    bool fConnected = connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+    close(fd);
+    return fConnected;
+}
+
+/*
+ * Starts args[0] in its own process group, so that it can be killed along
+ * with anything it starts, with its output appended to logFile
+ */
+pid_t launch(const vector<string>& args, const string& logFile) {
+    pid_t pid = fork();
+    if (pid != 0) {
+        if (pid < 0) {
+            cerr << "Could not fork: " << strerror(errno) << endl;
+        }
+        return pid;
+    }
+
+    setpgid(0, 0);
+    int logFD = open(logFile.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (logFD >= 0) {
+        dup2(logFD, STDOUT_FILENO);
+        dup2(logFD, STDERR_FILENO);
+        close(logFD);
+    }
+    int nullFD = open("/dev/null", O_RDONLY);
+    if (nullFD >= 0) {
+        dup2(nullFD, STDIN_FILENO);
+        close(nullFD);
+    }
+
+    vector<char*> argv;
+    for (size_t i = 0; i < args.size(); i++) {
+        argv.push_back(const_cast<char*>(args[i].c_str()));
+    }
+    argv.push_back(NULL);
+    execvp(argv[0], &argv[0]);
+    cerr << "Could not run " << args[0] << ": " << strerror(errno) << endl;
+    _exit(127);
+}
+
+bool hasExited(pid_t pid) {
+    if (pid <= 0) {
+        return true;
+    }
+    return waitpid(pid, NULL, WNOHANG) != 0;
+}
+
+/*
+ * Interrupts the process group of pid like kill.sh does, and kills it if
+ * it hasn't exited after a couple of seconds
+ */
+void stop(pid_t pid) {
+    if (pid <= 0) {
+        return;
+    }
+    kill(-pid, SIGINT);
+    for (int i = 0; i < 20; i++) {
+        if (waitpid(pid, NULL, WNOHANG) != 0) {
+            return;
+        }
+        usleep(100000);
+    }
+    kill(-pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+/*
+ * Copies the parameters to the file the agent watches.  The copy is
+ * renamed into place so the agent never loads a partial file.
+ */
+bool writeWatchFile(const Worker& worker, const string& paramsFile) {
+    ifstream in(paramsFile.c_str(), ios::binary);
+    if (!in) {
+        cerr << "Could not open parameter file " << paramsFile << endl;
+        return false;
+    }
+    string tmpFile = worker.watchFile + ".tmp";
+    ofstream out(tmpFile.c_str(), ios::binary | ios::trunc);
+    out << in.rdbuf();
+    out.close();
+    if (!out || rename(tmpFile.c_str(), worker.watchFile.c_str()) != 0) {
+        cerr << "Could not write " << worker.watchFile << endl;
+        return false;
+    }
+    return true;
+}
+
+void stopWorker(Worker& worker) {
+    stop(worker.agentPID);
+    stop(worker.serverPID);
+    worker.agentPID = -1;
+    worker.serverPID = -1;
+
+    // Throw away whatever the agent wrote before it died so that it isn't
+    // read as the fitness of the next job.  The pipe is non-blocking and
+    // we hold its write end, so reading stops with EAGAIN once it is empty.
+    char buffer[256];
+    while (read(worker.pipeFD, buffer, sizeof(buffer)) > 0) {
+    }
+    worker.pipeBuffer = "";
+    worker.state = WORKER_DOWN;
+}
+
+void startServer(Worker& worker) {
+    worker.agentPort = getFreePort();
+    worker.monitorPort = getFreePort();
+    while (worker.monitorPort == worker.agentPort) {
+        worker.monitorPort = getFreePort();
+    }
+
+    ostringstream agentPort, monitorPort;
+    agentPort << worker.agentPort;
+    monitorPort << worker.monitorPort;
+
+    vector<string> args;
+    args.push_back(serverBinary);
+    args.push_back("--agent-port");
+    args.push_back(agentPort.str());
+    args.push_back("--server-port");
+    args.push_back(monitorPort.str());
+    worker.serverPID = launch(args, worker.dir + "/server.log");
+    worker.state = WORKER_STARTING;
+    worker.deadline = now() + startTimeout;
+}
+
+void startAgent(Worker& worker) {
+    ostringstream type, agentPort, monitorPort;
+    type << agentBodyType;
+    agentPort << worker.agentPort;
+    monitorPort << worker.monitorPort;
+
+    vector<string> args;
+    args.push_back(agentBinary);
+    args.push_back("--unum");
+    args.push_back("2");
+    args.push_back("--type");
+    args.push_back(type.str());
+    args.push_back("--paramsfile");
+    args.push_back("paramfiles/defaultParams.txt");
+    args.push_back("--paramsfile");
+    args.push_back("paramfiles/defaultParams_t" + type.str() + ".txt");
+    args.push_back("--paramswatch");
+    args.push_back(worker.watchFile);
+    args.push_back("--experimentout");
+    args.push_back(worker.fitnessPipe);
+    args.push_back("--optimize");
+    args.push_back(agentType);
+    args.push_back("--port");
+    args.push_back(agentPort.str());
+    args.push_back("--mport");
+    args.push_back(monitorPort.str());
+    worker.agentPID = launch(args, worker.dir + "/agent.log");
+    worker.state = WORKER_EVALUATING;
+    worker.deadline = now() + evalTimeout;
+}
+
+void initWorker(Worker& worker, int id) {
+    ostringstream dir;
+    dir << workDir << "/worker" << id;
+    worker.id = id;
+    worker.dir = dir.str();
+    worker.watchFile = worker.dir + "/params.txt";
+    worker.fitnessPipe = worker.dir + "/fitness";
+    worker.state = WORKER_DOWN;
+    worker.serverPID = -1;
+    worker.agentPID = -1;
+    worker.fHasJob = false;
+
+    if (mkdir(worker.dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw "Could not create " + worker.dir;
+    }
+    unlink(worker.fitnessPipe.c_str());
+    if (mkfifo(worker.fitnessPipe.c_str(), 0644) != 0) {
+        throw "Could not create " + worker.fitnessPipe;
+    }
+    // Open for reading without waiting for a writer, then keep a write end
+    // open ourselves so that the agent closing its end is not end of file
+    worker.pipeFD = open(worker.fitnessPipe.c_str(), O_RDONLY | O_NONBLOCK);
+    if (worker.pipeFD < 0 || open(worker.fitnessPipe.c_str(), O_WRONLY | O_NONBLOCK) < 0) {
+        throw "Could not open " + worker.fitnessPipe;
+    }
+}
+
+void finishJob(Worker& worker, const string& result) {
+    cout << worker.job.paramsFile << "\t" << result << endl;
+    worker.fHasJob = false;
+}
+
+/*
+ * Gives the evaluation of the worker another try on a fresh server and
+ * agent, or reports it failed
+ */
+void failWorker(Worker& worker, const string& reason, deque<Job>& jobs) {
+    cerr << "worker " << worker.id << ": " << reason;
+    stopWorker(worker);
+    if (!worker.fHasJob) {
+        cerr << endl;
+        return;
+    }
+    worker.job.attempts++;
+    if (worker.job.attempts > maxRetries) {
+        cerr << ", giving up on " << worker.job.paramsFile << endl;
+        finishJob(worker, "failed");
+    } else {
+        cerr << ", retrying " << worker.job.paramsFile << endl;
+        jobs.push_front(worker.job);
+        worker.fHasJob = false;
+    }
+}
+
+/*
+ * Reads what the agent wrote to the fitness pipe, true once a whole line
+ * is in
+ */
+bool readFitness(Worker& worker, string& fitness) {
+    char buffer[256];
+    int numRead;
+    while ((numRead = read(worker.pipeFD, buffer, sizeof(buffer))) > 0) {
+        worker.pipeBuffer.append(buffer, numRead);
+    }
+    size_t end = worker.pipeBuffer.find('\n');
+    if (end == string::npos) {
+        return false;
+    }
+    fitness = worker.pipeBuffer.substr(0, end);
+    worker.pipeBuffer.erase(0, end + 1);
+    return true;
+}
+
+/*
+ * Moves a worker along: starts it, hands it a job, and checks on it
+ */
+void updateWorker(Worker& worker, deque<Job>& jobs) {
+    if (!worker.fHasJob && !jobs.empty() && worker.state != WORKER_EVALUATING) {
+        worker.job = jobs.front();
+        jobs.pop_front();
+        worker.fHasJob = true;
+    }
+
+    switch (worker.state) {
+    case WORKER_DOWN:
+        if (worker.fHasJob) {
+            startServer(worker);
+        }
+        break;
+    case WORKER_STARTING:
+        if (hasExited(worker.serverPID)) {
+            worker.serverPID = -1;
+            failWorker(worker, "server exited while starting", jobs);
+        } else if (isAcceptingConnections(worker.monitorPort)) {
+            if (writeWatchFile(worker, worker.job.paramsFile)) {
+                startAgent(worker);
+            } else {
+                finishJob(worker, "failed");
+                stopWorker(worker);
+            }
+        } else if (now() > worker.deadline) {
+            failWorker(worker, "server did not start", jobs);
+        }
+        break;
+    case WORKER_IDLE:
+        if (hasExited(worker.agentPID) || hasExited(worker.serverPID)) {
+            // Started again when there is something to evaluate
+            cerr << "worker " << worker.id << ": exited while idle" << endl;
+            stopWorker(worker);
+        } else if (worker.fHasJob) {
+            if (writeWatchFile(worker, worker.job.paramsFile)) {
+                worker.state = WORKER_EVALUATING;
+                worker.deadline = now() + evalTimeout;
+            } else {
+                finishJob(worker, "failed");
+            }
+        }
+        break;
+    case WORKER_EVALUATING: {
+        string fitness;
+        if (readFitness(worker, fitness)) {
+            finishJob(worker, fitness);
+            worker.state = WORKER_IDLE;
+            if (!jobs.empty()) {
+                updateWorker(worker, jobs);
+            }
+        } else if (hasExited(worker.agentPID)) {
+            worker.agentPID = -1;
+            failWorker(worker, "agent exited", jobs);
+        } else if (hasExited(worker.serverPID)) {
+            worker.serverPID = -1;
+            failWorker(worker, "server exited", jobs);
+        } else if (now() > worker.deadline) {
+            failWorker(worker, "timed out", jobs);
+        }
+        break;
+    }
+    }
+}
+
+void printHelp() {
+    cout << "usage: evalfarm [options] < parameter file names\n";
+    cout << " --workers <n>\tnumber of server and agent pairs (default: 1)\n";
+    cout << " --optimize <agent-type>\toptimization agent type (default: fixedKickAgent)\n";
+    cout << " --type <type number>\theterogeneous model type number (default: 0)\n";
+    cout << " --timeout <seconds>\tlongest an evaluation may take (default: 300)\n";
+    cout << " --starttimeout <seconds>\tlongest a server may take to start (default: 30)\n";
+    cout << " --retries <n>\ttimes to retry a failed evaluation (default: 2)\n";
+    cout << " --server <binary>\tsimulator to run (default: rcssserver3d)\n";
+    cout << " --agent <binary>\tagent to run (default: ./agentspark)\n";
+    cout << " --workdir <dir>\twhere to keep parameter files, pipes and logs (default: a new directory in /tmp)\n";
+}
+
+void readOptions(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--help" || i == argc - 1) {
+            printHelp();
+            exit(option == "--help" ? 0 : 1);
+        }
+        string value = argv[++i];
+        if (option == "--workers") {
+            numWorkers = atoi(value.c_str());
+        } else if (option == "--optimize") {
+            agentType = value;
+        } else if (option == "--type") {
+            agentBodyType = atoi(value.c_str());
+        } else if (option == "--timeout") {
+            evalTimeout = atof(value.c_str());
+        } else if (option == "--starttimeout") {
+            startTimeout = atof(value.c_str());
+        } else if (option == "--retries") {
+            maxRetries = atoi(value.c_str());
+        } else if (option == "--server") {
+            serverBinary = value;
+        } else if (option == "--agent") {
+            agentBinary = value;
+        } else if (option == "--workdir") {
+            workDir = value;
+        } else {
+            printHelp();
+            exit(1);
+        }
+    }
+    if (numWorkers < 1) {
+        printHelp();
+        exit(1);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    signal(SIGINT, handler);
+    signal(SIGTERM, handler);
+    signal(SIGPIPE, SIG_IGN);
+
+    readOptions(argc, argv);
+
+    // Same as the start scripts
+    string libraryPath = "./libs";
+    if (getenv("LD_LIBRARY_PATH") != NULL) {
+        libraryPath += string(":") + getenv("LD_LIBRARY_PATH");
+    }
+    setenv("LD_LIBRARY_PATH", libraryPath.c_str(), 1);
+
+    vector<Worker> workers(numWorkers);
+    try {
+        if (workDir.empty()) {
+            char dir[] = "/tmp/evalfarm.XXXXXX";
+            if (mkdtemp(dir) == NULL) {
+                throw string("Could not create a work directory");
+            }
+            workDir = dir;
+        } else if (mkdir(workDir.c_str(), 0755) != 0 && errno != EEXIST) {
+            throw "Could not create " + workDir;
+        }
+        for (int i = 0; i < numWorkers; i++) {
+            initWorker(workers[i], i);
+        }
+    }
+    catch (string s) {
+        cerr << s << endl;
+        return 1;
+    }
+    cerr << "evalfarm: " << numWorkers << " workers in " << workDir << endl;
+
+    deque<Job> jobs;
+    string input;
+    bool fInputOpen = true;
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+
+    while (gLoop) {
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        int maxFD = -1;
+        if (fInputOpen) {
+            FD_SET(STDIN_FILENO, &readfds);
+            maxFD = STDIN_FILENO;
+        }
+        for (int i = 0; i < numWorkers; i++) {
+            if (workers[i].state == WORKER_EVALUATING) {
+                FD_SET(workers[i].pipeFD, &readfds);
+                if (workers[i].pipeFD > maxFD) {
+                    maxFD = workers[i].pipeFD;
+                }
+            }
+        }
+
+        // Wake up now and then to check on servers starting, timeouts and
+        // processes that died
+        struct timeval tv = {0, 200000};
+        if (select(maxFD + 1, &readfds, NULL, NULL, &tv) < 0 && errno != EINTR) {
+            cerr << "select failed: " << strerror(errno) << endl;
+            break;
+        }
+
+        if (fInputOpen && FD_ISSET(STDIN_FILENO, &readfds)) {
+            char buffer[4096];
+            int numRead = read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (numRead > 0) {
+                input.append(buffer, numRead);
+            } else if (numRead == 0 || errno != EAGAIN) {
+                fInputOpen = false;
+                if (!input.empty()) {
+                    input += "\n";
+                }
+            }
+            size_t end;
+            while ((end = input.find('\n')) != string::npos) {
+                Job job;
+                job.paramsFile = input.substr(0, end);
+                job.attempts = 0;
+                input.erase(0, end + 1);
+                if (!job.paramsFile.empty()) {
+                    jobs.push_back(job);
+                }
+            }
+        }
+
+        bool fBusy = !jobs.empty();
+        for (int i = 0; i < numWorkers; i++) {
+            updateWorker(workers[i], jobs);
+            if (workers[i].fHasJob) {
+                fBusy = true;
+            }
+        }
+        if (!fInputOpen && !fBusy) {
+            break;
+        }
+    }
+
+    for (int i = 0; i < numWorkers; i++) {
+        stopWorker(workers[i]);
+    }
+    return 0;
+}
@@ -1,6 +1,76 @@
 #include "optimizationbehaviors.h"
 #include <fstream>
 
+FitnessRace::FitnessRace(const string& statsFile_) :
+		statsFile(statsFile_) {
+	reset();
+}
+
+void FitnessRace::reset() {
+	trials = 0;
+	sum = 0;
+	sumSquares = 0;
+}
+
+void FitnessRace::addTrial(double fitness) {
+	trials++;
+	sum += fitness;
+	sumSquares += fitness * fitness;
+
+	if (!statsFile.empty()) {
+		fstream file;
+		file.open(statsFile.c_str(), ios::out | ios::app);
+		file << trials << " " << getMean() << " " << getStdDev() << endl;
+		file.close();
+	}
+}
+
+/* Appends every line of text to the stats file, after "# " */
+void FitnessRace::addComment(const string& text) {
+	if (statsFile.empty()) {
+		return;
+	}
+	fstream file;
+	file.open(statsFile.c_str(), ios::out | ios::app);
+	istringstream lines(text);
+	string line;
+	while (getline(lines, line)) {
+		file << "# " << line << endl;
+	}
+	file.close();
+}
+
+double FitnessRace::getMean() const {
+	return trials > 0 ? sum / trials : 0;
+}
+
+/* Sample standard deviation of the trials */
+double FitnessRace::getStdDev() const {
+	if (trials < 2) {
+		return 0;
+	}
+	double variance = (sumSquares - sum * sum / trials) / (trials - 1);
+	return variance > 0 ? sqrt(variance) : 0;
+}
+
+static const Param raceThreshold("optim_race_threshold", false);
+static const Param raceMinTrials("optim_race_min_trials", false);
+static const Param raceConfidence("optim_race_confidence", false);
+
+bool FitnessRace::isLost() const {
+	const ParamRegistry& params = getParams();
+	if (!params.has(raceThreshold.getID())) {
+		return false;
+	}
+	double minTrials = params.has(raceMinTrials.getID()) ? raceMinTrials : 3.0;
+	if (trials < max(1.0, minTrials)) {
+		return false;
+	}
+	double confidence = params.has(raceConfidence.getID()) ? raceConfidence : 1.645;
+	double bound = getMean() + confidence * getStdDev() / sqrt((double) trials);
+	return bound < raceThreshold;
+}
+
 /*
  *
  *
@@ -10,18 +80,36 @@
  */
 OptimizationBehaviorFixedKick::OptimizationBehaviorFixedKick(
 		const std::string teamName, int uNum,
-		const map<string, string>& namedParams_, const string& rsg_,
-		const string& outputFile_) :
-		NaoBehavior(teamName, uNum, namedParams_, rsg_), outputFile(
-				outputFile_), kick(0), INIT_WAIT_TIME(3.0) {
+		const ParamRegistry& params_, const string& rsg_,
+		const string& outputFile_, const string& statsFile_) :
+		NaoBehavior(teamName, uNum, params_, rsg_), outputFile(
+				outputFile_), kick(0), totalFitness(0.0), failedLastBeamCheck(
+				false), written(false), race(statsFile_), INIT_WAIT_TIME(3.0) {
 	initKick();
 }
 
+/*
+ * Starts the kicks over with the parameters reloaded by
+ * --paramswatch, a new fitness is written when they are done
+ */
+bool OptimizationBehaviorFixedKick::reloadParameters(const ParamRegistry& newParams) {
+	if (!NaoBehavior::reloadParameters(newParams)) {
+		return false;
+	}
+	kick = 0;
+	totalFitness = 0.0;
+	failedLastBeamCheck = false;
+	written = false;
+	race.reset();
+	initKick();
+	return true;
+}
+
 void OptimizationBehaviorFixedKick::beam(double& beamX, double& beamY,
 		double& beamAngle) {
-	beamX = atof(namedParams.find("kick_xoffset")->second.c_str());
-	beamY = atof(namedParams.find("kick_yoffset")->second.c_str());
-	beamAngle = atof(namedParams.find("kick_angle")->second.c_str());
+	beamX = params.get("kick_xoffset");
+	beamY = params.get("kick_yoffset");
+	beamAngle = params.get("kick_angle");
 }
 
 SkillType OptimizationBehaviorFixedKick::selectSkill() {
@@ -45,8 +133,11 @@ SkillType OptimizationBehaviorFixedKick::selectSkill() {
 }
 
 void OptimizationBehaviorFixedKick::updateFitness() {
-	static double totalFitness = 0.0;
-	if (kick == 10) {
+	if (kick == 10 || race.isLost()) {
+		if (kick < 10 && !written) {
+			cout << "Stopping after " << kick << " kicks, mean fitness "
+					<< race.getMean() << " can't reach the race threshold" << endl;
+		}
 		writeFitnessToOutputFile(totalFitness / (double(kick)));
 		return;
 	}
@@ -59,7 +150,6 @@ void OptimizationBehaviorFixedKick::updateFitness() {
 		return;
 	}
 
-	static bool failedLastBeamCheck = false;
 	if (!beamChecked) {
 		cout << "Checking whether beam was successful\n";
 		beamChecked = true;
@@ -83,13 +173,12 @@ void OptimizationBehaviorFixedKick::updateFitness() {
 			LOG(meTruth);
 			LOG(meDesired);
 			if (failedLastBeamCheck) {
-				kick++;
-				totalFitness -= 100;
 				failedLastBeamCheck = false;
+				endKick(-100);
 			} else {
 				failedLastBeamCheck = true;
+				initKick();
 			}
-			initKick();
 			return;
 		}
 		failedLastBeamCheck = false;
@@ -115,9 +204,7 @@ void OptimizationBehaviorFixedKick::updateFitness() {
 	}
 
 	if (worldModel->isFallen()) {
-		totalFitness += -1;
-		kick++;
-		initKick();
+		endKick(-1);
 		return;
 	}
 
@@ -144,13 +231,19 @@ void OptimizationBehaviorFixedKick::updateFitness() {
 		cout << "Final position = " << ballTruth.getX() << ", "
 				<< ballTruth.getY() << endl;
 
-		totalFitness += fitness;
-		kick++;
-		initKick();
+		endKick(fitness);
 		return;
 	}
 }
 
+/* Records the fitness of the kick just done and starts the next one */
+void OptimizationBehaviorFixedKick::endKick(double fitness) {
+	totalFitness += fitness;
+	kick++;
+	race.addTrial(fitness);
+	initKick();
+}
+
 void OptimizationBehaviorFixedKick::initKick() {
 	hasKicked = false;
 	beamChecked = false;
@@ -171,7 +264,6 @@ void OptimizationBehaviorFixedKick::initKick() {
 }
 
 void OptimizationBehaviorFixedKick::writeFitnessToOutputFile(double fitness) {
-	static bool written = false;
 	if (!written) {
 		LOG(fitness);
 		LOG(kick);
@@ -180,6 +272,9 @@ void OptimizationBehaviorFixedKick::writeFitnessToOutputFile(double fitness) {
 		file << fitness << endl;
 		file.close();
 		written = true;
+		ostringstream visionStats;
+		parser->printVisionStats(visionStats);
+		race.addComment(visionStats.str());
 		//string msg = "(killsim)";
 		//setMonMessage(msg);
 	}
@@ -232,13 +327,17 @@ void writeToOutputFile(const string &filename, const string &output) {
  */
 OptimizationBehaviorWalkForward::OptimizationBehaviorWalkForward(
 		const std::string teamName, int uNum,
-		const map<string, string>& namedParams_, const string& rsg_,
-		const string& outputFile_) :
-		NaoBehavior(teamName, uNum, namedParams_, rsg_), outputFile(outputFile_) {
+		const ParamRegistry& params_, const string& rsg_,
+		const string& outputFile_, const string& statsFile_) :
+		NaoBehavior(teamName, uNum, params_, rsg_), outputFile(outputFile_),
+		race(statsFile_) {
 
 	INIT_WAIT = 1;
 	run = 0;
 	totalWalkDist = 0;
+	runStartWalkDist = 0;
+	failedLastBeamCheck = false;
+	written = false;
 	expectedPerTarget = 3;
 	DIST_TO_WALK = 3.5;
 	START_POSITION_X_1 = -HALF_FIELD_X + 7;
@@ -258,6 +357,25 @@ OptimizationBehaviorWalkForward::OptimizationBehaviorWalkForward(
 
 	init();
 }
+
+/*
+ * Starts the runs over with the parameters reloaded by --paramswatch,
+ * a new fitness is written when they are done
+ */
+bool OptimizationBehaviorWalkForward::reloadParameters(const ParamRegistry& newParams) {
+	if (!NaoBehavior::reloadParameters(newParams)) {
+		return false;
+	}
+	run = 0;
+	totalWalkDist = 0;
+	runStartWalkDist = 0;
+	failedLastBeamCheck = false;
+	written = false;
+	race.reset();
+	init();
+	return true;
+}
+
 VecPosition OptimizationBehaviorWalkForward::getTarget() {
 	VecPosition target;
 	srand(time(0));
@@ -358,6 +476,17 @@ void OptimizationBehaviorWalkForward::init() {
 	setMonMessage(msg);
 }
 
+/*
+ * Records what was walked during the run just done, as a trial for
+ * racing, and starts the next run
+ */
+void OptimizationBehaviorWalkForward::endRun() {
+	race.addTrial(totalWalkDist - runStartWalkDist);
+	runStartWalkDist = totalWalkDist;
+	run++;
+	init();
+}
+
 void OptimizationBehaviorWalkForward::beam(double& beamX, double& beamY,
 		double& beamAngle) {
 	if (run != 10) {
@@ -417,17 +546,23 @@ SkillType OptimizationBehaviorWalkForward::selectSkill() {
 }
 
 void OptimizationBehaviorWalkForward::updateFitness() {
-	static bool written = false;
 //	cout<<flip<<endl;
 //	cout<<getTarget()<<endl;
-	if (run == 11) {
+	if (run == 11 || race.isLost()) {
 		if (!written) {
+			if (run < 11) {
+				cout << "Stopping after " << run << " runs, mean fitness "
+						<< race.getMean() << " can't reach the race threshold" << endl;
+			}
 			double fitness = totalWalkDist / (double) run;
 			fstream file;
 			file.open(outputFile.c_str(), ios::out);
 			file << fitness << endl;
 			file.close();
 			written = true;
+			ostringstream visionStats;
+			parser->printVisionStats(visionStats);
+			race.addComment(visionStats.str());
 		}
 		return;
 	}
@@ -443,7 +578,6 @@ void OptimizationBehaviorWalkForward::updateFitness() {
 	}
 
 	if (!beamChecked) {
-		static bool failedLastBeamCheck = false;
 		if (!checkBeam()) {
 			// Beam failed so reinitialize everything
 			if (failedLastBeamCheck) {
@@ -451,10 +585,11 @@ void OptimizationBehaviorWalkForward::updateFitness() {
 				//if we failed the beam twice in a row (perhaps the agent can't stand) so give a bad score and
 				// move on
 				totalWalkDist -= 100;
-				run++;
+				endRun();
+			} else {
+				init();
 			}
 			failedLastBeamCheck = true;
-			init();
 			return;
 		} else {
 			failedLastBeamCheck = false;
@@ -499,8 +634,7 @@ void OptimizationBehaviorWalkForward::updateFitness() {
 				totalWalkDist -= hasFallen * COST_OF_FALL;
 				cout << "Run " << run << " distance walked: "
 						<< totalWalkDist / (run + 1) << endl;
-				run++;
-				init();
+				endRun();
 			}
 		} else if (run % 5 == 1) {
 			if (me.getX() >= -3.464 && me.getX() < 3.4) {
@@ -518,8 +652,7 @@ void OptimizationBehaviorWalkForward::updateFitness() {
 			}
 			if (currentTime - startTime >= INIT_WAIT + 15.0) {
 				totalWalkDist -= hasFallen * COST_OF_FALL;
-				run++;
-				init();
+				endRun();
 			}
 		} else if (run % 5 == 2) {
 			if (me.getX() <= -2.838 && me.getX() > -8.9) {
@@ -537,8 +670,7 @@ void OptimizationBehaviorWalkForward::updateFitness() {
 			}
 			if (currentTime - startTime >= INIT_WAIT + 15.0) {
 				totalWalkDist -= hasFallen * COST_OF_FALL;
-				run++;
-				init();
+				endRun();
 			}
 
 		} else {
@@ -561,8 +693,7 @@ void OptimizationBehaviorWalkForward::updateFitness() {
 				totalWalkDist -= hasFallen * COST_OF_FALL;
 				cout << "Run " << run << " distance walked: "
 						<< totalWalkDist / (run + 1) << endl;
-				run++;
-				init();
+				endRun();
 			}
 		}
 	} else {
@@ -572,8 +703,7 @@ void OptimizationBehaviorWalkForward::updateFitness() {
 			flip = false;
 		if (currentTime - startTime >= INIT_WAIT + 15.0) {
 			totalWalkDist += hasFallen *- COST_OF_FALL;
-			run++;
-			init();
+			endRun();
 		}
 	}
 
@@ -642,12 +772,13 @@ void OptimizationBehaviorWalkForward::updateFitness() {
  */
 
 OptimizationBehaviorStand::OptimizationBehaviorStand(const std::string teamName,
-		int uNum, const map<string, string>& namedParams_, const string& rsg_,
+		int uNum, const ParamRegistry& params_, const string& rsg_,
 		const string& outputFile_) :
-		NaoBehavior(teamName, uNum, namedParams_, rsg_), outputFile(outputFile_) {
+		NaoBehavior(teamName, uNum, params_, rsg_), outputFile(outputFile_) {
 	totalcost = 0;
 	cost = 0;
 	done = false;
+	written = false;
 	INIT_WAIT = 2;
 	run = 0;
 // Use ground truth localization for behavior
@@ -655,6 +786,23 @@ OptimizationBehaviorStand::OptimizationBehaviorStand(const std::string teamName,
 	initStand();
 }
 
+/*
+ * Starts the runs over with the parameters reloaded by --paramswatch,
+ * a new fitness is written when they are done
+ */
+bool OptimizationBehaviorStand::reloadParameters(const ParamRegistry& newParams) {
+	if (!NaoBehavior::reloadParameters(newParams)) {
+		return false;
+	}
+	totalcost = 0;
+	cost = 0;
+	done = false;
+	written = false;
+	run = 0;
+	initStand();
+	return true;
+}
+
 void OptimizationBehaviorStand::initStand() {
 	beamChecked = false;
 	timeStart = worldModel->getTime();
@@ -732,7 +880,6 @@ void OptimizationBehaviorStand::updateFitness() {
 }
 
 void OptimizationBehaviorStand::writeFitnessToOutputFile(double fitness) {
-	static bool written = false;
 	if (!written) {
 		LOG(fitness);
 		fstream file;
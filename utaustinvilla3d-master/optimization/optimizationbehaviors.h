@@ -5,6 +5,38 @@
 
 bool isBallMoving(const WorldModel *worldModel);
 
+/*
+ * Racing for optimization tasks made of several trials.  Keeps running
+ * statistics of the trial fitnesses and tells when the candidate can't be
+ * expected to reach optim_race_threshold anymore: after at least
+ * optim_race_min_trials trials, when the upper confidence bound of the mean
+ * (optim_race_confidence standard errors above it) is below the threshold.
+ * The remaining trials are then skipped.  Racing is off when
+ * optim_race_threshold isn't set.  If a stats file is given, a line
+ * "<trials> <mean> <standard deviation>" is appended to it after every
+ * trial, and addComment() appends other lines starting with "#".
+ */
+class FitnessRace {
+	const string statsFile;
+	int trials;
+	double sum;
+	double sumSquares;
+
+public:
+	FitnessRace(const string& statsFile_);
+
+	void reset();
+	void addTrial(double fitness);
+	void addComment(const string& text);
+	bool isLost() const;
+
+	int getTrials() const {
+		return trials;
+	}
+	double getMean() const;
+	double getStdDev() const;
+};
+
 class OptimizationBehaviorFixedKick: public NaoBehavior {
 	const string outputFile;
 
@@ -16,22 +48,28 @@ class OptimizationBehaviorFixedKick: public NaoBehavior {
 	bool fallen;
 
 	int kick;
+	double totalFitness;
+	bool failedLastBeamCheck;
+	bool written;
+	FitnessRace race;
 
 	double INIT_WAIT_TIME;
 
 	VecPosition ballInitPos;
 	void initKick();
+	void endKick(double fitness);
 	void writeFitnessToOutputFile(double fitness);
 
 public:
 
 	OptimizationBehaviorFixedKick(const std::string teamName, int uNum,
-			const map<string, string>& namedParams_, const string& rsg_,
-			const string& outputFile_);
+			const ParamRegistry& params_, const string& rsg_,
+			const string& outputFile_, const string& statsFile_);
 
 	virtual void beam(double& beamX, double& beamY, double& beamAngle);
 	virtual SkillType selectSkill();
 	virtual void updateFitness();
+	virtual bool reloadParameters(const ParamRegistry& newParams);
 
 };
 
@@ -41,6 +79,8 @@ class OptimizationBehaviorWalkForward: public NaoBehavior {
 	int run;
 	double startTime;
 	bool beamChecked;
+	bool failedLastBeamCheck;
+	bool written;
 	bool hasFallen;
 	int falls;
 	double INIT_WAIT;
@@ -62,23 +102,27 @@ class OptimizationBehaviorWalkForward: public NaoBehavior {
 	bool standing;
 	double expectedPerTarget;
 	double totalWalkDist;
+	double runStartWalkDist;
+	FitnessRace race;
 	double targetStartTime;
 	int currentTarget;
 	VecPosition start;
 	VecPosition oldTarget;
 	void init();
+	void endRun();
 	VecPosition getTarget();
 	bool checkBeam();
 
 public:
 
 	OptimizationBehaviorWalkForward(const std::string teamName, int uNum,
-			const map<string, string>& namedParams_, const string& rsg_,
-			const string& outputFile_);
+			const ParamRegistry& params_, const string& rsg_,
+			const string& outputFile_, const string& statsFile_);
 
 	virtual void beam(double& beamX, double& beamY, double& beamAngle);
 	virtual SkillType selectSkill();
 	virtual void updateFitness();
+	virtual bool reloadParameters(const ParamRegistry& newParams);
 
 };
 
@@ -89,6 +133,7 @@ class OptimizationBehaviorStand: public NaoBehavior {
 	double totalcost;
 	double cost;
 	bool done;
+	bool written;
 	int run;
 	double INIT_WAIT;
 	double currentTime;
@@ -98,11 +143,12 @@ class OptimizationBehaviorStand: public NaoBehavior {
 
 public:
 	OptimizationBehaviorStand(const std::string teamName, int uNum,
-			const map<string, string>& namedParams_, const string& rsg_,
+			const ParamRegistry& params_, const string& rsg_,
 			const string& outputFile_);
 	virtual void beam(double& beamX, double& beamY, double& beamAngle);
 	virtual SkillType selectSkill();
 	virtual void updateFitness();
+	virtual bool reloadParameters(const ParamRegistry& newParams);
 };
 
 #endif
@@ -4,6 +4,10 @@
 
 #include "../math/vecposition.h"
 
+// Most sightings a single See message can hold: the landmarks, the ball,
+// the field lines and five body parts plus a position for every player
+#define MAX_VISION_OBJECTS 256
+
 struct VisionObject {
 
     VisionObject( double r, double theta, double phi, int id_ ) {
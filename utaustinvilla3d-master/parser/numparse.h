@@ -0,0 +1,109 @@
+#ifndef NUMPARSE_H
+#define NUMPARSE_H
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+/*
+ * Number parsing for perceptor values, straight from the characters of a
+ * token in the message (which need not be null terminated).
+ *
+ * The server writes numbers as short decimals such as -12.34, so the fast
+ * path reads the digits into an integer mantissa and divides once by an
+ * exact power of ten.  While the mantissa has at most 15 digits and the
+ * power is at most 10^22 both are exact doubles, and the one division
+ * rounds to the same double strtod returns.  Anything else (exponents, hex,
+ * nan, inf, long mantissas, leading spaces) falls back to strtod on a copy
+ * of the token, which reads '.' as the decimal point since the agent never
+ * changes its locale from "C".
+ */
+
+// Longest token parsed from a copy on the stack when falling back
+#define MAX_NUMBER_LENGTH 63
+
+inline double parseDoubleSlow(const char *str, size_t length) {
+    if (length > MAX_NUMBER_LENGTH) {
+        return strtod(std::string(str, length).c_str(), NULL);
+    }
+    char copy[MAX_NUMBER_LENGTH + 1];
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    return strtod(copy, NULL);
+}
+
+inline double parseDouble(const char *str, size_t length) {
+    static const double powersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *p = str;
+    const char *end = str + length;
+    bool fNegative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        fNegative = *p == '-';
+        ++p;
+    }
+
+    unsigned long long mantissa = 0;
+    int numDigits = 0;
+    int fractionDigits = 0;
+    bool fAnyDigits = false;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        mantissa = mantissa * 10 + (*p - '0');
+        numDigits += (mantissa != 0);
+        fAnyDigits = true;
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+            mantissa = mantissa * 10 + (*p - '0');
+            numDigits += (mantissa != 0);
+            fractionDigits++;
+            fAnyDigits = true;
+        }
+    }
+
+    // strtod decides what to make of whatever is left of the token
+    if (!fAnyDigits || p != end || numDigits > 15 || fractionDigits > 22) {
+        return parseDoubleSlow(str, length);
+    }
+
+    double value = (double)mantissa / powersOf10[fractionDigits];
+    return fNegative ? -value : value;
+}
+
+inline int parseIntSlow(const char *str, size_t length) {
+    if (length > MAX_NUMBER_LENGTH) {
+        return atoi(std::string(str, length).c_str());
+    }
+    char copy[MAX_NUMBER_LENGTH + 1];
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    return atoi(copy);
+}
+
+inline int parseInt(const char *str, size_t length) {
+    const char *p = str;
+    const char *end = str + length;
+    bool fNegative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        fNegative = *p == '-';
+        ++p;
+    }
+    if (p == end || *p < '0' || *p > '9') {
+        return parseIntSlow(str, length);
+    }
+
+    // Like atoi, stops at the first character that isn't a digit
+    int value = 0;
+    for (int numDigits = 0; p < end && *p >= '0' && *p <= '9'; ++p, ++numDigits) {
+        if (numDigits == 9) {
+            return parseIntSlow(str, length);
+        }
+        value = value * 10 + (*p - '0');
+    }
+    return fNegative ? -value : value;
+}
+
+#endif // NUMPARSE_H
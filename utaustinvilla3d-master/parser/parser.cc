@@ -7,6 +7,8 @@
 #include "../worldmodel/worldmodel.h"
 #include "../bodymodel/bodymodel.h"
 #include "VisionObject.h"
+#include "vocabulary.h"
+#include "numparse.h"
 #include "../particlefilter/PFLocalization.h"
 #include "../kalman/BallKF.h"
 #include "../kalman/PlayerKF.h"
@@ -31,7 +33,7 @@ using boost::shared_ptr;
 ///////////////////////////
 
 Parser::Parser(WorldModel *worldModel, BodyModel *bodyModel, const string &teamName,
-               PFLocalization* particleFilter, FrameInfoBlock* vision_frame_info, FrameInfoBlock* frame_info, JointBlock* joint_block, SensorBlock* sensor_block) {
+               PFLocalization* particleFilter, FrameInfoBlock* vision_frame_info, FrameInfoBlock* frame_info, JointBlock* joint_block, SensorBlock* sensor_block, int targets) {
     sensor_block_= sensor_block;
     joint_angles_block_ = joint_block;
     frame_info_ = frame_info;
@@ -47,87 +49,85 @@ Parser::Parser(WorldModel *worldModel, BodyModel *bodyModel, const string &teamN
 
     this->teamName = teamName;
     this->fProcessedVision = false;
+    this->targets = targets;
+    this->numVisionObjs = 0;
 }
 
 Parser::~Parser() {
 
 }
 
-vector<string> Parser::tokenise(const string &s) {
+vector<Token> Parser::tokenise(const Token &s) {
 
-    int length = s.length();
-    string currentString = "";
-    bool currentValid = false;
+    int length = s.length;
+    const char *chars = s.str;
 
-    vector<string> v;
+    vector<Token> v;
 
+    // Tokens point into the message rather than copying it
+    int start = 0;
     for(int i = 0; i < length; ++i) {
 
-        char c = s.at(i);
-        if(c != '(' && c != ')' && c != ' ') {
-            currentString.append(1, c);
-        }
-        else {
-
-            if(currentString.length() > 0) {
-                v.push_back(currentString);
-                currentString = "";
+        char c = chars[i];
+        if(c == '(' || c == ')' || c == ' ') {
+            if(i > start) {
+                v.push_back(Token(chars + start, i - start));
             }
+            start = i + 1;
         }
     }
 
     return v;
 }
 
-vector<string> Parser::tokeniseCommaDelim(const string &s) {
+vector<Token> Parser::tokeniseCommaDelim(const Token &s) {
 
-    int length = s.length();
-    string currentString = "";
-    bool currentValid = false;
+    int length = s.length;
+    const char *chars = s.str;
 
-    vector<string> v;
+    vector<Token> v;
 
+    // Tokens point into the message rather than copying it
+    int start = 0;
     for(int i = 0; i < length; ++i) {
 
-        char c = s.at(i);
-        if(c != '(' && c != ')' && c != ',') {
-            currentString.append(1, c);
-        }
-        else {
-
-            if(currentString.length() > 0) {
-                v.push_back(currentString);
-                currentString = "";
+        char c = chars[i];
+        if(c == '(' || c == ')' || c == ',') {
+            if(i > start) {
+                v.push_back(Token(chars + start, i - start));
             }
+            start = i + 1;
         }
     }
 
     return v;
 }
 
-bool Parser::parseTime(const string &str) {
+bool Parser::parseTime(const Token &str) {
 
     bool valid = false;
     double time = 0;
-    this->fProcessedVision = false;
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     for(size_t i = 0; i < tokens.size() - 1; ++i) {
-        if(!(tokens[i].compare("now"))) {
-            time = atof(tokens[i + 1].c_str());
+        if(tokens[i].is("now")) {
+            time = parseDouble(tokens[i + 1]);
             valid = true;
         }
     }
 
-    if(valid) {
+    if(valid && (targets & PARSE_MODELS)) {
+        this->fProcessedVision = false;
         worldModel->setTime(time);
         worldModel->incrementCycle();
+    }
+    if(valid && (targets & PARSE_MEMORY_BLOCKS)) {
         frame_info_->seconds_since_start = time;
     }
 
     return valid;
 }
 
-bool Parser::parseGameState(const string &str) {
+bool Parser::parseGameState(const Token &str) {
 
     bool gameTimeValid = false;
     bool playModeValid = false;
@@ -137,100 +137,28 @@ bool Parser::parseGameState(const string &str) {
     bool scoreRightValid = false;
 
     double gameTime = 0;
-    string playModeStr = "";
+    Token playModeStr;
 
     int playMode = -1;
     int scoreLeft = -1;
     int scoreRight = -1;
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     for(size_t i = 0; i < tokens.size() - 1; ++i) {
 
-        if(!(tokens[i].compare("t"))) {
-            gameTime = atof(tokens[i + 1].c_str());
+        if(tokens[i].is("t")) {
+            gameTime = parseDouble(tokens[i + 1]);
             gameTimeValid = true;
             ++i;
         }
-        else if(!(tokens[i].compare("pm"))) {
+        else if(tokens[i].is("pm")) {
 
             playModeStr = tokens[i + 1];
 
 
-            if(!(playModeStr.compare("BeforeKickOff"))) {
-                playMode = PM_BEFORE_KICK_OFF;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("KickOff_Left"))) {
-                playMode = PM_KICK_OFF_LEFT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("KickOff_Right"))) {
-                playMode = PM_KICK_OFF_RIGHT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("PlayOn"))) {
-                playMode = PM_PLAY_ON;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("KickIn_Left"))) {
-                playMode = PM_KICK_IN_LEFT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("KickIn_Right"))) {
-                playMode = PM_KICK_IN_RIGHT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("Goal_Left"))) {
-                playMode = PM_GOAL_LEFT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("Goal_Right"))) {
-                playMode = PM_GOAL_RIGHT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("GameOver"))) {
-                playMode = PM_GAME_OVER;
-                playModeValid = true;
-            }
-            //Extra
-            else if(!(playModeStr.compare("corner_kick_left"))) {
-                playMode = PM_CORNER_KICK_LEFT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("corner_kick_right"))) {
-                playMode = PM_CORNER_KICK_RIGHT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("goal_kick_left"))) {
-                playMode = PM_GOAL_KICK_LEFT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("goal_kick_right"))) {
-                playMode = PM_GOAL_KICK_RIGHT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("offside_left"))) {
-                playMode = PM_OFFSIDE_LEFT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("offside_right"))) {
-                playMode = PM_OFFSIDE_RIGHT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("free_kick_left"))) {
-                playMode = PM_FREE_KICK_LEFT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("free_kick_right"))) {
-                playMode = PM_FREE_KICK_RIGHT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("direct_free_kick_left"))) {
-                playMode = PM_DIRECT_FREE_KICK_LEFT;
-                playModeValid = true;
-            }
-            else if(!(playModeStr.compare("direct_free_kick_right"))) {
-                playMode = PM_DIRECT_FREE_KICK_RIGHT;
+            int row = playModeHash.lookup(playModeStr.str, playModeStr.length);
+            if(row >= 0) {
+                playMode = playModeNames[row].playMode;
                 playModeValid = true;
             }
             else {
@@ -239,33 +167,33 @@ bool Parser::parseGameState(const string &str) {
             }
             ++i;
         }
-        else if(!(tokens[i].compare("unum"))) {
+        else if(tokens[i].is("unum")) {
 
-            uNum = atoi(tokens[i + 1].c_str());
+            uNum = parseInt(tokens[i + 1]);
             if(1 <= uNum && uNum <= 11) {
                 uNumValid = true;
             }
             ++i;
         }
-        else if(!(tokens[i].compare("team"))) {
+        else if(tokens[i].is("team")) {
 
-            if(!(tokens[i + 1].compare("left"))) {
+            if(tokens[i + 1].is("left")) {
                 side = SIDE_LEFT;
                 sideValid = true;
             }
-            else if(!(tokens[i + 1].compare("right"))) {
+            else if(tokens[i + 1].is("right")) {
                 side = SIDE_RIGHT;
                 sideValid = true;
             }
             ++i;
         }
-        else if(!(tokens[i].compare("sl"))) {
-            scoreLeft = atoi(tokens[i + 1].c_str());
+        else if(tokens[i].is("sl")) {
+            scoreLeft = parseInt(tokens[i + 1]);
             scoreLeftValid = true;
             ++i;
         }
-        else if(!(tokens[i].compare("sr"))) {
-            scoreRight = atoi(tokens[i + 1].c_str());
+        else if(tokens[i].is("sr")) {
+            scoreRight = parseInt(tokens[i + 1]);
             scoreRightValid = true;
             ++i;
         }
@@ -305,28 +233,29 @@ bool Parser::parseGameState(const string &str) {
     return valid;
 }
 
-bool Parser::parseGyro(const string &str) {
+bool Parser::parseGyro(const Token &str) {
     bool valid = false;
 
     double rateX = 0.0, rateY = 0.0, rateZ = 0.0;
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     for(size_t i = 0; i < tokens.size(); ++i) {
-        if(!tokens[i].compare("rt")) {
+        if(tokens[i].is("rt")) {
             if(i + 3 < tokens.size()) {
 
-                rateX = atof(tokens[i + 1].c_str());
-                rateY = atof(tokens[i + 2].c_str());
-                rateZ = atof(tokens[i + 3].c_str());
+                rateX = parseDouble(tokens[i + 1]);
+                rateY = parseDouble(tokens[i + 2]);
+                rateZ = parseDouble(tokens[i + 3]);
                 valid = true;
             }
         }
 
     }
 
-    if(valid) {
+    if(valid && (targets & PARSE_MODELS)) {
         bodyModel->setGyroRates(rateX, rateY, rateZ);
-
+    }
+    if(valid && (targets & PARSE_MEMORY_BLOCKS)) {
         sensor_block_->values_[gyroX] = rateY;
         sensor_block_->values_[gyroY] = rateX;
         sensor_block_->values_[gyroZ] = rateZ;
@@ -335,26 +264,26 @@ bool Parser::parseGyro(const string &str) {
     return valid;
 }
 
-bool Parser::parseAccelerometer(const string &str) {
+bool Parser::parseAccelerometer(const Token &str) {
     bool valid = false;
 
     double rateX = 0.0, rateY = 0.0, rateZ = 0.0;
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     for(size_t i = 0; i < tokens.size(); ++i) {
-        if(!tokens[i].compare("a")) {
+        if(tokens[i].is("a")) {
             if(i + 3 < tokens.size()) {
 
-                rateX = atof(tokens[i + 1].c_str());
-                rateY = atof(tokens[i + 2].c_str());
-                rateZ = atof(tokens[i + 3].c_str());
+                rateX = parseDouble(tokens[i + 1]);
+                rateY = parseDouble(tokens[i + 2]);
+                rateZ = parseDouble(tokens[i + 3]);
                 valid = true;
             }
         }
 
     }
 
-    if(valid) {
+    if(valid && (targets & PARSE_MODELS)) {
 
         // Sometimes spurious (very high or NaN) readings come through. Clip them.
         double spuriousThreshold = 20.0;
@@ -383,6 +312,8 @@ bool Parser::parseAccelerometer(const string &str) {
 
 
         bodyModel->setAccelRates(correctedRateX, correctedRateY, correctedRateZ);
+    }
+    if(valid && (targets & PARSE_MEMORY_BLOCKS)) {
         sensor_block_->values_[accelY] = rateX;
         sensor_block_->values_[accelX] = rateY;
         sensor_block_->values_[accelZ] = rateZ;
@@ -392,7 +323,7 @@ bool Parser::parseAccelerometer(const string &str) {
 }
 
 //to handle -- do when needed.
-bool Parser::parseHear(const string &str) {
+bool Parser::parseHear(const Token &str) {
     bool valid = false;
 
     double hearTime;
@@ -400,7 +331,7 @@ bool Parser::parseHear(const string &str) {
     double angle;
     string message;
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     valid = tokens.size() == 5;
 
     if (!valid) {
@@ -410,21 +341,21 @@ bool Parser::parseHear(const string &str) {
     unsigned int i = 1;
 
     if (tokens.size() == 5) {
-        string team = tokens[i++];
-        if (team.compare(teamName)) {
-            worldModel->setOpponentTeamName(team);
+        Token team = tokens[i++];
+        if (!team.is(teamName)) {
+            worldModel->setOpponentTeamName(team.toString());
             return true;
         }
     }
 
-    hearTime = atof(tokens[i++].c_str());
-    if(!(tokens[i].compare("self"))) {
+    hearTime = parseDouble(tokens[i++]);
+    if(tokens[i].is("self")) {
         self = true;
         angle = 0;
     }
     else {
         self = false;
-        angle = atof(tokens[i].c_str());
+        angle = parseDouble(tokens[i]);
     }
 
     i++;
@@ -434,7 +365,7 @@ bool Parser::parseHear(const string &str) {
         return false;
     }
 
-    message = tokens[i];
+    message = tokens[i].toString();
 
     double timeBallLastSeen;
     bool fallen;
@@ -488,11 +419,11 @@ bool Parser::parseHear(const string &str) {
     return valid;
 }
 
-bool Parser::parseHingeJoint(const string &str) {
+bool Parser::parseHingeJoint(const Token &str) {
 
     bool valid;
 
-    string name;
+    Token name;
     double angle = 0.0;
 
     bool validName = false;
@@ -501,141 +432,27 @@ bool Parser::parseHingeJoint(const string &str) {
     int hingeJointIndexBM = -1;
     int hingeJointIndexWE = -1;
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     for(size_t i = 0; i < tokens.size(); ++i) {
 
-        if(!tokens[i].compare("n")) {
+        if(tokens[i].is("n")) {
             if(i + 1 < tokens.size()) {
 
                 name = tokens[i + 1];
 
-                if(!(name.compare("hj1"))) {
-                    hingeJointIndexBM = HJ_H1;
-                    hingeJointIndexWE = HeadYaw; // HJ_H1;
-                    validName = true;
-                }
-                else if(!(name.compare("hj2"))) {
-                    hingeJointIndexBM = HJ_H2;
-                    hingeJointIndexWE = HeadPitch; //HJ_H2;
-                    validName = true;
-                }
-                else if(!(name.compare("laj1"))) {
-                    hingeJointIndexBM = HJ_LA1;
-                    hingeJointIndexWE = LShoulderPitch; ///HJ_LA1;
-                    validName = true;
-                }
-                else if(!(name.compare("laj2"))) {
-                    hingeJointIndexBM = HJ_LA2;
-                    hingeJointIndexWE = LShoulderRoll; //HJ_LA2;
-                    validName = true;
-                }
-                else if(!(name.compare("laj3"))) {
-                    hingeJointIndexBM = HJ_LA3;
-                    hingeJointIndexWE = LElbowYaw; //HJ_LA3;
-                    validName = true;
-                }
-                else if(!(name.compare("laj4"))) {
-                    hingeJointIndexBM = HJ_LA4;
-                    hingeJointIndexWE = LElbowRoll; //HJ_LA4;
-                    validName = true;
-                }
-                else if(!(name.compare("raj1"))) {
-                    hingeJointIndexBM = HJ_RA1;
-                    hingeJointIndexWE = RShoulderPitch; //HJ_RA1;
-                    validName = true;
-                }
-                else if(!(name.compare("raj2"))) {
-                    hingeJointIndexBM = HJ_RA2;
-                    hingeJointIndexWE = RShoulderRoll; //HJ_RA2;
-                    validName = true;
-                }
-                else if(!(name.compare("raj3"))) {
-                    hingeJointIndexBM = HJ_RA3;
-                    hingeJointIndexWE = RElbowYaw; //HJ_RA3;
-                    validName = true;
-                }
-                else if(!(name.compare("raj4"))) {
-                    hingeJointIndexBM = HJ_RA4;
-                    hingeJointIndexWE = RElbowRoll; //HJ_RA4;
-                    validName = true;
-                }
-                else if(!(name.compare("llj1"))) {
-                    hingeJointIndexBM = HJ_LL1;
-                    hingeJointIndexWE = LHipYawPitch; //HJ_LL1;
-                    validName = true;
-                }
-                else if(!(name.compare("llj2"))) {
-                    hingeJointIndexBM = HJ_LL2;
-                    hingeJointIndexWE = LHipRoll; //HJ_LL2;
-                    validName = true;
-                }
-                else if(!(name.compare("llj3"))) {
-                    hingeJointIndexBM = HJ_LL3;
-                    hingeJointIndexWE = LHipPitch; //HJ_LL3;
-                    validName = true;
-                }
-                else if(!(name.compare("llj4"))) {
-                    hingeJointIndexBM = HJ_LL4;
-                    hingeJointIndexWE = LKneePitch; //HJ_LL4;
-                    validName = true;
-                }
-                else if(!(name.compare("llj5"))) {
-                    hingeJointIndexBM = HJ_LL5;
-                    hingeJointIndexWE = LAnklePitch; //HJ_LL5;
-                    validName = true;
-                }
-                else if(!(name.compare("llj6"))) {
-                    hingeJointIndexBM = HJ_LL6;
-                    hingeJointIndexWE = LAnkleRoll; //HJ_LL6;
-                    validName = true;
-                }
-                else if(!(name.compare("llj7"))) {
-                    hingeJointIndexBM = HJ_LL7;
-                    hingeJointIndexWE = LToePitch; //HJ_LL7;
-                    validName = true;
-                }
-                else if(!(name.compare("rlj1"))) {
-                    hingeJointIndexBM = HJ_RL1;
-                    hingeJointIndexWE = RHipYawPitch; //HJ_RL1;
-                    validName = true;
-                }
-                else if(!(name.compare("rlj2"))) {
-                    hingeJointIndexBM = HJ_RL2;
-                    hingeJointIndexWE = RHipRoll; //HJ_RL2;
-                    validName = true;
-                }
-                else if(!(name.compare("rlj3"))) {
-                    hingeJointIndexBM = HJ_RL3;
-                    hingeJointIndexWE = RHipPitch; //HJ_RL3;
-                    validName = true;
-                }
-                else if(!(name.compare("rlj4"))) {
-                    hingeJointIndexBM = HJ_RL4;
-                    hingeJointIndexWE = RKneePitch; //HJ_RL4;
-                    validName = true;
-                }
-                else if(!(name.compare("rlj5"))) {
-                    hingeJointIndexBM = HJ_RL5;
-                    hingeJointIndexWE = RAnklePitch; //HJ_RL5;
-                    validName = true;
-                }
-                else if(!(name.compare("rlj6"))) {
-                    hingeJointIndexBM = HJ_RL6;
-                    hingeJointIndexWE = RAnkleRoll; //HJ_RL6;
-                    validName = true;
-                }
-                else if(!(name.compare("rlj7"))) {
-                    hingeJointIndexBM = HJ_RL7;
-                    hingeJointIndexWE = RToePitch; //HJ_RL7;
+                int row = hingeJointHash.lookup(name.str, name.length);
+                if(row >= 0) {
+                    hingeJointIndexBM = hingeJointNames[row].indexBM;
+                    hingeJointIndexWE = hingeJointNames[row].indexWE;
                     validName = true;
                 }
             }
         }
 
-        if(!tokens[i].compare("ax")) {
+        if(tokens[i].is("ax")) {
             if(i + 1 < tokens.size()) {
 
-                angle = atof(tokens[i + 1].c_str());
+                angle = parseDouble(tokens[i + 1]);
                 validAngle = true;
             }
         }
@@ -644,9 +461,11 @@ bool Parser::parseHingeJoint(const string &str) {
 
     valid = validName && validAngle;
 
-    if(valid) {
+    if(valid && (targets & PARSE_MODELS)) {
         //    cout << "HJ: " << name << " " << angle << "\n";
         bodyModel->setJointAngle(hingeJointIndexBM, angle);
+    }
+    if(valid && (targets & PARSE_MEMORY_BLOCKS)) {
         joint_angles_block_->values_[hingeJointIndexWE]=DEG_T_RAD*angle;
     }
     //  else{
@@ -656,30 +475,30 @@ bool Parser::parseHingeJoint(const string &str) {
     return valid;
 }
 
-bool Parser::parseSee(const string &str) {
+bool Parser::parseSee(const Token &str) {
 
     bool valid = true;
-    visionObjs.clear();
+    numVisionObjs = 0;
 
-    vector<string> strSegments = segment(str, true);
+    vector<Token> strSegments = segment(str, true);
 
     for(size_t i = 0; i < strSegments.size(); ++i) {
 
         //Goalpost
         if(strSegments[i].at(1) == 'G') {
-            valid = parseGoalPost(strSegments[i], visionObjs) && valid;
+            valid = parseGoalPost(strSegments[i]) && valid;
         }
         //Flags
         else if(strSegments[i].at(1) == 'F') {
-            valid = parseFlag(strSegments[i], visionObjs) && valid;
+            valid = parseFlag(strSegments[i]) && valid;
         }
         //Ball
         else if(strSegments[i].at(1) == 'B') {
-            valid = parseBall(strSegments[i], visionObjs) && valid;
+            valid = parseBall(strSegments[i]) && valid;
         }
         //Player
         else if(strSegments[i].at(1)== 'P') {
-            valid = parsePlayer(strSegments[i], visionObjs) && valid;
+            valid = parsePlayer(strSegments[i]) && valid;
         }
 #ifdef GROUND_TRUTH_SERVER
         // MyPos and MyOrien
@@ -697,7 +516,7 @@ bool Parser::parseSee(const string &str) {
         // Line
         else if(strSegments[i].at(1) == 'L' ) {
             worldModel->setLastLineSightingTime(worldModel->getTime());
-            valid = parseLine(strSegments[i], visionObjs) && valid;
+            valid = parseLine(strSegments[i]) && valid;
         }
         else {
             valid = false;
@@ -711,17 +530,25 @@ bool Parser::parseSee(const string &str) {
     return valid;
 }
 
-bool Parser::parseLine(const string &str, vector< boost::shared_ptr<VisionObject> >& visionObjs) {
+void Parser::addVisionObject(const VisionObject &obj) {
+    if (numVisionObjs == MAX_VISION_OBJECTS) {
+        cerr << "Too many vision objects, ignoring sighting of " << obj.id << "\n";
+        return;
+    }
+    visionObjs[numVisionObjs++] = obj;
+}
+
+bool Parser::parseLine(const Token &str) {
 
     bool valid = false;
 
-    string name;
+    Token name;
     double r, theta, phi, r2, theta2, phi2;
 
     int lineIndex = -1;
 
     //Check for nan values
-    if (str.find("nan") != string::npos) {
+    if (str.contains("nan")) {
         //cerr << "Bad line value: " << str << "\n";
         // Return as valid even though we haven't parsed line as
         // we don't want to mark the whole see message as invalid and
@@ -729,24 +556,24 @@ bool Parser::parseLine(const string &str, vector< boost::shared_ptr<VisionObject
         return true;
     }
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     valid = (tokens.size() == 9);
 
     if(valid) {
         name = tokens[0];
-        valid = !(tokens[1].compare("pol")) && valid;
+        valid = tokens[1].is("pol") && valid;
 
-        r = atof(tokens[2].c_str());
-        theta = atof(tokens[3].c_str());
-        phi = atof(tokens[4].c_str());
+        r = parseDouble(tokens[2]);
+        theta = parseDouble(tokens[3]);
+        phi = parseDouble(tokens[4]);
 
-        valid = !(tokens[5].compare("pol")) && valid;
+        valid = tokens[5].is("pol") && valid;
 
-        r2 = atof(tokens[6].c_str());
-        theta2 = atof(tokens[7].c_str());
-        phi2 = atof(tokens[8].c_str());
+        r2 = parseDouble(tokens[6]);
+        theta2 = parseDouble(tokens[7]);
+        phi2 = parseDouble(tokens[8]);
 
-        if(!(name.compare("L"))) {
+        if(name.is("L")) {
             lineIndex = LINE;
         } else {
             valid = false;
@@ -754,43 +581,34 @@ bool Parser::parseLine(const string &str, vector< boost::shared_ptr<VisionObject
     }
 
     if(valid) {
-        boost::shared_ptr<VisionObject> obj( new VisionObject(r, theta, phi, r2, theta2, phi2, lineIndex ) );
-        visionObjs.push_back( obj );
+        addVisionObject( VisionObject(r, theta, phi, r2, theta2, phi2, lineIndex ) );
     }
     return valid;
 }
 
-bool Parser::parseGoalPost(const string &str, vector< boost::shared_ptr<VisionObject> >& visionObjs) {
+bool Parser::parseGoalPost(const Token &str) {
 
     bool valid = false;
 
-    string name;
+    Token name;
     double r, theta, phi;
 
     int goalPostIndex = -1;
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     valid = (tokens.size() == 5);
 
     if(valid) {
         name = tokens[0];
-        valid = !(tokens[1].compare("pol")) && valid;
+        valid = tokens[1].is("pol") && valid;
 
-        r = atof(tokens[2].c_str());
-        theta = atof(tokens[3].c_str());
-        phi = atof(tokens[4].c_str());
+        r = parseDouble(tokens[2]);
+        theta = parseDouble(tokens[3]);
+        phi = parseDouble(tokens[4]);
 
-        if(!(name.compare("G1L"))) {
-            goalPostIndex = GOALPOST_1_L;
-        }
-        else if(!(name.compare("G1R"))) {
-            goalPostIndex = GOALPOST_1_R;
-        }
-        else if(!(name.compare("G2L"))) {
-            goalPostIndex = GOALPOST_2_L;
-        }
-        else if(!(name.compare("G2R"))) {
-            goalPostIndex = GOALPOST_2_R;
+        int row = goalPostHash.lookup(name.str, name.length);
+        if(row >= 0) {
+            goalPostIndex = goalPostNames[row].index;
         }
         else {
             valid = false;
@@ -798,42 +616,33 @@ bool Parser::parseGoalPost(const string &str, vector< boost::shared_ptr<VisionOb
     }
 
     if(valid) {
-        boost::shared_ptr<VisionObject> obj( new VisionObject(r, theta, phi, goalPostIndex ) );
-        visionObjs.push_back( obj );
+        addVisionObject( VisionObject(r, theta, phi, goalPostIndex ) );
     }
     return valid;
 }
 
-bool Parser::parseFlag(const string &str, vector< boost::shared_ptr<VisionObject> >& visionObjs) {
+bool Parser::parseFlag(const Token &str) {
     bool valid = false;
 
-    string name;
+    Token name;
     double r, theta, phi;
 
     int flagIndex = -1;
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     valid = (tokens.size() == 5);
 
     if(valid) {
         name = tokens[0];
-        valid = !(tokens[1].compare("pol")) && valid;
+        valid = tokens[1].is("pol") && valid;
 
-        r = atof(tokens[2].c_str());
-        theta = atof(tokens[3].c_str());
-        phi = atof(tokens[4].c_str());
+        r = parseDouble(tokens[2]);
+        theta = parseDouble(tokens[3]);
+        phi = parseDouble(tokens[4]);
 
-        if(!(name.compare("F1L"))) {
-            flagIndex = FLAG_1_L;
-        }
-        else if(!(name.compare("F1R"))) {
-            flagIndex = FLAG_1_R;
-        }
-        else if(!(name.compare("F2L"))) {
-            flagIndex = FLAG_2_L;
-        }
-        else if(!(name.compare("F2R"))) {
-            flagIndex = FLAG_2_R;
+        int row = flagHash.lookup(name.str, name.length);
+        if(row >= 0) {
+            flagIndex = flagNames[row].index;
         }
         else {
             valid = false;
@@ -841,45 +650,43 @@ bool Parser::parseFlag(const string &str, vector< boost::shared_ptr<VisionObject
     }
 
     if(valid) {
-        boost::shared_ptr<VisionObject> obj( new VisionObject(r, theta, phi, flagIndex) );
-        visionObjs.push_back( obj );
+        addVisionObject( VisionObject(r, theta, phi, flagIndex) );
     }
     return valid;
 }
 
-bool Parser::parseBall(const string &str, vector< boost::shared_ptr<VisionObject> >& visionObjs) {
+bool Parser::parseBall(const Token &str) {
     bool valid = false;
-    string name;
+    Token name;
     double r, theta, phi;
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     valid = (tokens.size() == 5);
 
     if(valid) {
         name = tokens[0];
-        valid = !(tokens[1].compare("pol")) && valid;
+        valid = tokens[1].is("pol") && valid;
 
-        r = atof(tokens[2].c_str());
-        theta = atof(tokens[3].c_str());
-        phi = atof(tokens[4].c_str());
+        r = parseDouble(tokens[2]);
+        theta = parseDouble(tokens[3]);
+        phi = parseDouble(tokens[4]);
     }
 
     if(valid) {
-        boost::shared_ptr<VisionObject> obj( new VisionObject(r, theta, phi, WO_BALL) );
-        visionObjs.push_back( obj );
+        addVisionObject( VisionObject(r, theta, phi, WO_BALL) );
     }
 
     return valid;
 }
 
-bool Parser::parsePlayer(const string &str, vector< boost::shared_ptr<VisionObject> >& visionObjs) {
+bool Parser::parsePlayer(const Token &str) {
     double headAnglePan = bodyModel->getJointAngle(EFF_H1);
     double headAngleTilt = bodyModel->getJointAngle(EFF_H2);
     //  VecPosition headAnglePolarCorrection = VecPosition(0, headAnglePan, headAngleTilt);
 
     bool valid = true;
 
-    string playerTeamName;
+    Token playerTeamName;
     bool playerTeamNameValid = false;
 
     int uNum = 0;
@@ -888,93 +695,51 @@ bool Parser::parsePlayer(const string &str, vector< boost::shared_ptr<VisionObje
     double x = 0, y = 0, z = 0;
     bool coordinatesValid = false;
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     int numBodyParts = 0;
     bool notMe = false;
-    bool isHead = false;
-    bool isArmL = false;
-    bool isArmR = false;
-    bool isFootL = false;
-    bool isFootR = false;
+    int bodyPart = -1;
     for(size_t i = 0; i < tokens.size(); ++i) {
-        if(!(tokens[i].compare("P"))) {
+        int bodyPartRow;
+        if(tokens[i].is("P")) {
             //Nothing
         }
-        else if(!(tokens[i].compare("rlowerarm") && tokens[i].compare("llowerarm") &&
-                  tokens[i].compare("rfoot") && tokens[i].compare("lfoot") &&
-                  tokens[i].compare("head"))) {
-            isHead = !tokens[i].compare("head");
-            isArmL = !tokens[i].compare("llowerarm");
-            isArmR = !tokens[i].compare("rlowerarm");
-            isFootL = !tokens[i].compare("lfoot");
-            isFootR = !tokens[i].compare("rfoot");
-
+        else if((bodyPartRow = bodyPartHash.lookup(tokens[i].str, tokens[i].length)) >= 0) {
+            bodyPart = bodyPartRow;
             numBodyParts++;
         }
-        else if(!(tokens[i].compare("team")) && i < tokens.size() - 1) {
+        else if(tokens[i].is("team") && i < tokens.size() - 1) {
 
             playerTeamName = tokens[i + 1];
             ++i;
-            if(playerTeamName.compare(teamName)) {
-                worldModel->setOpponentTeamName(playerTeamName);
+            if(!playerTeamName.is(teamName)) {
+                worldModel->setOpponentTeamName(playerTeamName.toString());
             }
             playerTeamNameValid = true;
         }
-        else if(!(tokens[i].compare("id")) && i < tokens.size() - 1) {
-            uNum = atoi(tokens[i + 1].c_str());
+        else if(tokens[i].is("id") && i < tokens.size() - 1) {
+            uNum = parseInt(tokens[i + 1]);
             ++i;
             uNumValid = true;
         }
-        else if(!(tokens[i].compare("pol")) &&  i < tokens.size() - 3) {
-            double r = atof(tokens[i + 1].c_str());
-            double theta = atof(tokens[i + 2].c_str());
-            double phi = atof(tokens[i + 3].c_str());
+        else if(tokens[i].is("pol") &&  i < tokens.size() - 3) {
+            double r = parseDouble(tokens[i + 1]);
+            double theta = parseDouble(tokens[i + 2]);
+            double phi = parseDouble(tokens[i + 3]);
             i += 3;
-            if (playerTeamName.compare(teamName) || worldModel->getUNum() != uNum) {
+            if (!playerTeamName.is(teamName) || worldModel->getUNum() != uNum) {
                 VecPosition posCartesian = (VecPosition(r, theta, phi)).getCartesianFromPolar();
                 x += posCartesian.getX();
                 y += posCartesian.getY();
                 z += posCartesian.getZ();
                 notMe = true;
                 int objectIndex = -1;
-                if (isHead) {
-                    if(!playerTeamName.compare(teamName)) {
-                        objectIndex = ( WO_TEAMMATE_HEAD1 - 1 ) + uNum;
-                    }
-                    else {
-                        objectIndex = ( WO_OPPONENT_HEAD1 - 1 ) + uNum;
-                    }
-                }
-                else if (isArmL) {
-                    if(!playerTeamName.compare(teamName)) {
-                        objectIndex = ( WO_TEAMMATE_ARM_L1 - 1 ) + uNum;
+                if (bodyPart >= 0) {
+                    if(playerTeamName.is(teamName)) {
+                        objectIndex = ( bodyPartNames[bodyPart].teammate1 - 1 ) + uNum;
                     }
                     else {
-                        objectIndex = ( WO_OPPONENT_ARM_L1 - 1 ) + uNum;
-                    }
-                }
-                else if (isArmR) {
-                    if(!playerTeamName.compare(teamName)) {
-                        objectIndex = ( WO_TEAMMATE_ARM_R1 - 1 ) + uNum;
-                    }
-                    else {
-                        objectIndex = ( WO_OPPONENT_ARM_R1 - 1 ) + uNum;
-                    }
-                }
-                else if (isFootL) {
-                    if(!playerTeamName.compare(teamName)) {
-                        objectIndex = ( WO_TEAMMATE_FOOT_L1 - 1 ) + uNum;
-                    }
-                    else {
-                        objectIndex = ( WO_OPPONENT_FOOT_L1 - 1 ) + uNum;
-                    }
-                }
-                else if (isFootR) {
-                    if(!playerTeamName.compare(teamName)) {
-                        objectIndex = ( WO_TEAMMATE_FOOT_R1 - 1 ) + uNum;
-                    }
-                    else {
-                        objectIndex = ( WO_OPPONENT_FOOT_R1 - 1 ) + uNum;
+                        objectIndex = ( bodyPartNames[bodyPart].opponent1 - 1 ) + uNum;
                     }
                 }
                 else {
@@ -982,8 +747,7 @@ bool Parser::parsePlayer(const string &str, vector< boost::shared_ptr<VisionObje
                     valid = false;
                 }
                 if (objectIndex != -1) {
-                    boost::shared_ptr<VisionObject> obj( new VisionObject(r, theta, phi, objectIndex ) );
-                    visionObjs.push_back( obj );
+                    addVisionObject( VisionObject(r, theta, phi, objectIndex ) );
                 }
             }
             coordinatesValid = true;
@@ -1017,26 +781,24 @@ bool Parser::parsePlayer(const string &str, vector< boost::shared_ptr<VisionObje
         double theta = avgPos.getTheta();
         double phi = avgPos.getPhi();
 
-        if(!playerTeamName.compare(teamName)) {
+        if(playerTeamName.is(teamName)) {
             int playerIndex = ( WO_TEAMMATE1 - 1 ) + uNum;
-            boost::shared_ptr<VisionObject> obj( new VisionObject(r, theta, phi, playerIndex ) );
-            visionObjs.push_back( obj );
+            addVisionObject( VisionObject(r, theta, phi, playerIndex ) );
         }
         else {
             int playerIndex = ( WO_OPPONENT1 - 1 ) + uNum;
-            boost::shared_ptr<VisionObject> obj( new VisionObject(r, theta, phi, playerIndex ) );
-            visionObjs.push_back( obj );
+            addVisionObject( VisionObject(r, theta, phi, playerIndex ) );
         }
     }
 
     return valid;
 }
 
-bool Parser::parseFRP(const string &str) {
+bool Parser::parseFRP(const Token &str) {
 
     bool valid;
 
-    string name;
+    Token name;
     double centreX = 0.0, centreY = 0.0, centreZ = 0.0;
     double forceX = 0.0, forceY = 0.0, forceZ = 0.0;
 
@@ -1046,49 +808,49 @@ bool Parser::parseFRP(const string &str) {
 
     int FRPIndex = -1;
 
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
     for(size_t i = 0; i < tokens.size(); ++i) {
 
-        if(!tokens[i].compare("n")) {
+        if(tokens[i].is("n")) {
             if(i + 1 < tokens.size()) {
 
                 name = tokens[i + 1];
 
-                if(!(name.compare("lf"))) {
+                if(name.is("lf")) {
                     FRPIndex = FOOT_LEFT;
                     validName = true;
                 }
-                if(!(name.compare("rf"))) {
+                if(name.is("rf")) {
                     FRPIndex = FOOT_RIGHT;
                     validName = true;
                 }
-                if(!(name.compare("lf1"))) {
+                if(name.is("lf1")) {
                     FRPIndex = TOE_LEFT;
                     validName = true;
                 }
-                if(!(name.compare("rf1"))) {
+                if(name.is("rf1")) {
                     FRPIndex = TOE_RIGHT;
                     validName = true;
                 }
             }
         }
 
-        if(!tokens[i].compare("c")) {
+        if(tokens[i].is("c")) {
             if(i + 3 < tokens.size()) {
 
-                centreX = atof(tokens[i + 1].c_str());
-                centreY = atof(tokens[i + 2].c_str());
-                centreZ = atof(tokens[i + 3].c_str());
+                centreX = parseDouble(tokens[i + 1]);
+                centreY = parseDouble(tokens[i + 2]);
+                centreZ = parseDouble(tokens[i + 3]);
                 validCentre = true;
             }
         }
 
-        if(!tokens[i].compare("f")) {
+        if(tokens[i].is("f")) {
             if(i + 3 < tokens.size()) {
 
-                forceX = atof(tokens[i + 1].c_str());
-                forceY = atof(tokens[i + 2].c_str());
-                forceZ = atof(tokens[i + 3].c_str());
+                forceX = parseDouble(tokens[i + 1]);
+                forceY = parseDouble(tokens[i + 2]);
+                forceZ = parseDouble(tokens[i + 3]);
                 validForce = true;
             }
         }
@@ -1117,34 +879,34 @@ bool Parser::parseFRP(const string &str) {
 }
 
 #ifdef GROUND_TRUTH_SERVER
-bool Parser::parseMyPos(const string &str) {
+bool Parser::parseMyPos(const Token &str) {
     bool valid = false;
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
 
-    if(!tokens[0].compare("mypos") && tokens.size() >= 4 ) {
-        double x = atof(tokens[1].c_str());
-        double y = atof(tokens[2].c_str());
-        double z = atof(tokens[3].c_str());
+    if(tokens[0].is("mypos") && tokens.size() >= 4 ) {
+        double x = parseDouble(tokens[1]);
+        double y = parseDouble(tokens[2]);
+        double z = parseDouble(tokens[3]);
         worldModel->setMyPositionGroundTruth(VecPosition(x, y, z));
 
         // if sent the angle as well
         if( tokens.size() >=5 ) {
-            double angle = Rad2Deg( atof(tokens[4].c_str()) );
+            double angle = Rad2Deg( parseDouble(tokens[4]) );
             worldModel->setMyAngDegGroundTruth( angle );
         }
 
         // if sent ball position as well
         if( tokens.size() >=8 ) {
-            double bx = atof(tokens[5].c_str());
-            double by = atof(tokens[6].c_str());
-            double bz = atof(tokens[7].c_str());
+            double bx = parseDouble(tokens[5]);
+            double by = parseDouble(tokens[6]);
+            double bz = parseDouble(tokens[7]);
             VecPosition ballPos = VecPosition(bx, by, bz);
             worldModel->setBallGroundTruth(ballPos);
         }
 
         valid = true;
-    } else if (!tokens[0].compare("myorien") && tokens.size() == 2) {
-        double angle = atof(tokens[1].c_str());
+    } else if (tokens[0].is("myorien") && tokens.size() == 2) {
+        double angle = parseDouble(tokens[1]);
         worldModel->setMyAngDegGroundTruth( angle );
         valid = true;
     }
@@ -1152,14 +914,14 @@ bool Parser::parseMyPos(const string &str) {
     return valid;
 }
 
-bool Parser::parseBallPos(const string &str) {
+bool Parser::parseBallPos(const Token &str) {
     bool valid = false;
-    vector<string> tokens = tokenise(str);
+    vector<Token> tokens = tokenise(str);
 
-    if(!tokens[0].compare("ballpos") && tokens.size() == 4 ) {
-        double x = atof(tokens[1].c_str());
-        double y = atof(tokens[2].c_str());
-        double z = atof(tokens[3].c_str());
+    if(tokens[0].is("ballpos") && tokens.size() == 4 ) {
+        double x = parseDouble(tokens[1]);
+        double y = parseDouble(tokens[2]);
+        double z = parseDouble(tokens[3]);
         worldModel->setBallGroundTruth(VecPosition(x, y, z));
 
         valid = true;
@@ -1169,21 +931,19 @@ bool Parser::parseBallPos(const string &str) {
 }
 #endif
 
-vector<string> Parser::segment(const string &str, const bool &omitEnds) {
-    vector<string> v;
+vector<Token> Parser::segment(const Token &str, const bool &omitEnds) {
+    vector<Token> v;
 
     int ptr = 0;
-    int length = str.length();
+    int length = str.length;
 
     if(omitEnds) {
         ptr = 1;
-        length = str.length() - 1;
+        length = str.length - 1;
     }
 
     int bracCount = 0;
 
-    string currentString = "";
-
     do {
 
         while(ptr < length && str.at(ptr) != '(') {
@@ -1192,7 +952,8 @@ vector<string> Parser::segment(const string &str, const bool &omitEnds) {
 
         if(ptr < length) {
 
-            currentString = "";
+            // Segments point into the message rather than copying it
+            int start = ptr;
 
             do {
                 char c = str.at(ptr);
@@ -1204,14 +965,12 @@ vector<string> Parser::segment(const string &str, const bool &omitEnds) {
                     bracCount--;
                 }
 
-                currentString.append(1, c);
                 ptr++;
 
             } while(bracCount != 0 && ptr < length);
 
             if(bracCount == 0) {
-                v.push_back(currentString);
-                currentString = "";
+                v.push_back(Token(str.str + start, ptr - start));
             }
         }
     } while(ptr < length);
@@ -1221,11 +980,13 @@ vector<string> Parser::segment(const string &str, const bool &omitEnds) {
 
 bool Parser::parse(const string &input, bool &fParsedVision) {
     bool valid = true;
-    bodyModel->setFRPLeft(VecPosition(0, 0, 0), VecPosition(0, 0, 0));
-    bodyModel->setFRPRight(VecPosition(0, 0, 0), VecPosition(0, 0, 0));
-    bodyModel->setFRPLeft1(VecPosition(0, 0, 0), VecPosition(0, 0, 0));
-    bodyModel->setFRPRight1(VecPosition(0, 0, 0), VecPosition(0, 0, 0));
-    vector<string> inputSegments = segment(input, false);
+    if (targets & PARSE_MODELS) {
+        bodyModel->setFRPLeft(VecPosition(0, 0, 0), VecPosition(0, 0, 0));
+        bodyModel->setFRPRight(VecPosition(0, 0, 0), VecPosition(0, 0, 0));
+        bodyModel->setFRPLeft1(VecPosition(0, 0, 0), VecPosition(0, 0, 0));
+        bodyModel->setFRPRight1(VecPosition(0, 0, 0), VecPosition(0, 0, 0));
+    }
+    vector<Token> inputSegments = segment(Token(input), false);
 
 
     for(size_t i = 0; i < inputSegments.size(); ++i) {
@@ -1233,6 +994,13 @@ bool Parser::parse(const string &input, bool &fParsedVision) {
         if(inputSegments[i].at(1)== 't') {
             valid = parseTime(inputSegments[i]) && valid;
         }
+        // Only time, gyro, accelerometer and hinge joints feed the memory
+        // blocks, the rest is of no use to a motion only parser
+        else if(!(targets & PARSE_MODELS) &&
+                !(inputSegments[i].at(1) == 'G' && inputSegments[i].at(2) != 'S') &&
+                inputSegments[i].at(1) != 'H' && inputSegments[i].at(1) != 'A') {
+            continue;
+        }
         else if(inputSegments[i].at(1) == 'G') {
             //GameState
             if(inputSegments[i].at(2) == 'S') {
@@ -1280,13 +1048,9 @@ bool Parser::parse(const string &input, bool &fParsedVision) {
 
 void Parser::processVision() {
 
-    if (!worldModel->getSideSet()) {
+    if (!visionStats.count(worldModel->getSideSet())) {
         return;
     }
-    // Print vision info
-    vector< boost::shared_ptr<VisionObject> >::iterator begin( visionObjs.begin() );
-    vector< boost::shared_ptr<VisionObject> >::iterator end( visionObjs.end() );
-
     // Fix vision objects w.r.t. head pan and tilt
     //////////////////  double headAnglePan = bodyModel->getJointAngle(EFF_H1);
     ////////////////  double headAngleTilt = bodyModel->getJointAngle(EFF_H2);
@@ -1303,10 +1067,8 @@ void Parser::processVision() {
     }
 
 
-    begin = visionObjs.begin();
-    end = visionObjs.end();
-    for( ; begin != end; ++begin ) {
-        VisionObject& obj = **begin;
+    for( int i = 0; i < numVisionObjs; ++i ) {
+        VisionObject& obj = visionObjs[i];
         VecPosition objLocalCamera = obj.polar.getCartesianFromPolar();
         VecPosition objLocalOrigin = bodyModel->transformCameraToOrigin(objLocalCamera);
         obj.polar = objLocalOrigin.getPolarFromCartesian();
@@ -1324,10 +1086,8 @@ void Parser::processVision() {
         worldModel->getWorldObject( i )->currentlySeen = false;
     }
     worldModel->getWorldObject(LINE)->lines.clear();
-    begin = visionObjs.begin();
-    end = visionObjs.end();
-    for( ; begin != end; ++begin ) {
-        VisionObject& visObj = **begin;
+    for( int i = 0; i < numVisionObjs; ++i ) {
+        const VisionObject& visObj = visionObjs[i];
         WorldObject* pObj = worldModel->getWorldObject( visObj.id );
         pObj->currentlySeen = true;
         pObj->validPosition = true;
@@ -1551,6 +1311,14 @@ void Parser::processVision() {
 
 }
 
+void Parser::printVisionStats(ostream &out) const {
+    out << "Vision processing: " << visionStats << "\n";
+    out << "Particle filter landmark updates: " << particleFilter->landmarkStats << "\n";
+    out << "Particle filter line matching: " << particleFilter->lineStats << "\n";
+    out << "Ball Kalman filter measurement updates: " << worldModel->getBallKalmanFilter()->measurementStats << "\n";
+    out << "Opponent Kalman filter measurement updates: " << worldModel->getOpponentKalmanFilters()->measurementStats << "\n";
+}
+
 /* Process reported sightings of objects from teammates */
 void Parser::processSightings(bool fIgnoreVision) {
     if (!worldModel->getSideSet()) {
@@ -11,10 +11,12 @@
 class WorldModel;
 class BodyModel;
 class PFLocalization;
-class VisionObject;
 class VecPosition;
 
 #include "../headers/headers.h"
+#include "VisionObject.h"
+#include "stagestats.h"
+#include "token.h"
 
 // For UT Walk
 class FrameInfoBlock;
@@ -25,6 +27,18 @@ using namespace std;
 
 class Parser {
 
+public:
+
+    // What a parser instance writes the perceptors it parses into.  When
+    // motion runs on its own thread the motion thread's parser only fills
+    // the UT Walk memory blocks and the behavior thread's parser only
+    // updates the world and body models.
+    enum ParseTargets {
+        PARSE_MEMORY_BLOCKS = 1,
+        PARSE_MODELS = 2,
+        PARSE_ALL = PARSE_MEMORY_BLOCKS | PARSE_MODELS
+    };
+
 private:
 
     WorldModel *worldModel;
@@ -38,47 +52,64 @@ private:
 
     bool fProcessedVision;
 
+    int targets;
+
     // For UT Walk
     SensorBlock* sensor_block_;
     JointBlock* joint_angles_block_;
     FrameInfoBlock* frame_info_;
     FrameInfoBlock* vision_frame_info_;
 
-    vector< boost::shared_ptr<VisionObject> > visionObjs;
+    // Sightings of the last See message, stored by value and reused every
+    // cycle so that parsing vision allocates nothing
+    VisionObject visionObjs[MAX_VISION_OBJECTS];
+    int numVisionObjs;
+
+    // See messages processed, and skipped for not knowing our side yet
+    StageStats visionStats;
 
 protected:
 
-    vector<string> tokenise(const string &s);
-    vector<string> tokeniseCommaDelim(const string &s);
-    bool parseTime(const string &str);
-    bool parseGameState(const string &str);
-    bool parseGyro(const string &str);
-    bool parseAccelerometer(const string &str);
-    bool parseHear(const string &str);
-    bool parseHingeJoint(const string &str);
-    bool parseSee(const string &str);
-    bool parseLine(const string &str, vector< boost::shared_ptr<VisionObject> >& visionObjs);
-    bool parseGoalPost(const string &str, vector< boost::shared_ptr<VisionObject> >& visionObjs);
-    bool parseFlag(const string &str, vector< boost::shared_ptr<VisionObject> >& visionObjs);
-    bool parseBall(const string &str, vector< boost::shared_ptr<VisionObject> >& visionObjs);
-    bool parsePlayer(const string &str, vector< boost::shared_ptr<VisionObject> >& visionObjs);
-    bool parseFRP(const string &str);
-    bool parseMyPos(const string &str);
-    bool parseBallPos(const string &str);
-    vector<string> segment(const string &str, const bool &omitEnds);
+    // Perceptors and their words point into the message being parsed, so
+    // that nothing is copied out of it
+    vector<Token> tokenise(const Token &s);
+    vector<Token> tokeniseCommaDelim(const Token &s);
+    bool parseTime(const Token &str);
+    bool parseGameState(const Token &str);
+    bool parseGyro(const Token &str);
+    bool parseAccelerometer(const Token &str);
+    bool parseHear(const Token &str);
+    bool parseHingeJoint(const Token &str);
+    bool parseSee(const Token &str);
+    void addVisionObject(const VisionObject &obj);
+    bool parseLine(const Token &str);
+    bool parseGoalPost(const Token &str);
+    bool parseFlag(const Token &str);
+    bool parseBall(const Token &str);
+    bool parsePlayer(const Token &str);
+    bool parseFRP(const Token &str);
+    bool parseMyPos(const Token &str);
+    bool parseBallPos(const Token &str);
+    vector<Token> segment(const Token &str, const bool &omitEnds);
     void computeLocalCornerPositions( VecPosition& fieldXPlusYPlus,
                                       VecPosition& fieldXPlusYMinus,
                                       VecPosition& fieldXMinusYPlus,
                                       VecPosition& fieldXMinusYMinus );
 public:
 
-    Parser(WorldModel *worldModel, BodyModel *bodyModel, const string &teamName, PFLocalization* particleFilter, FrameInfoBlock* vision_frame_info, FrameInfoBlock* frame_info, JointBlock* joint_block, SensorBlock* sensor_block);
+    Parser(WorldModel *worldModel, BodyModel *bodyModel, const string &teamName, PFLocalization* particleFilter, FrameInfoBlock* vision_frame_info, FrameInfoBlock* frame_info, JointBlock* joint_block, SensorBlock* sensor_block, int targets = PARSE_ALL);
 
     ~Parser();
 
     bool parse(const string &input, bool &fParsedVision);
     void processVision();
     void processSightings(bool fIgnoreVision);
+    // How often See messages were processed and skipped so far
+    inline const StageStats& getVisionStats() const {
+        return visionStats;
+    }
+    // Prints how often each vision processing stage ran and was skipped
+    void printVisionStats(ostream &out) const;
 };
 
 #endif // PARSER_H
@@ -0,0 +1,104 @@
+#ifndef PERFECTHASH_H
+#define PERFECTHASH_H
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Maps the names of a fixed vocabulary, such as the hinge joint names
+ * perceptors report, to their row in a table.
+ *
+ * The hash is perfect: when the table is built a seed is searched for
+ * under which every name lands in its own slot, so a lookup is one hash
+ * and one string compare no matter how large the vocabulary is.  Names
+ * must be distinct; tables are built during static initialization, so the
+ * agent exits naming the culprit rather than searching forever.
+ */
+class PerfectHash {
+public:
+
+    /*
+     * Builds the hash for a table whose rows have a const char* name
+     * member.  The table must outlive the hash.
+     */
+    template<class Row>
+    PerfectHash(const Row *table, int numRows) {
+        for (int i = 0; i < numRows; ++i) {
+            names.push_back(table[i].name);
+            lengths.push_back(strlen(table[i].name));
+        }
+        build();
+    }
+
+    // Returns the row of name in the table, or -1 if it is not there
+    int lookup(const char *name, size_t length) const {
+        int row = slots[hash(name, length, seed) & mask];
+        if (row < 0 || lengths[row] != length || memcmp(names[row], name, length)) {
+            return -1;
+        }
+        return row;
+    }
+
+    int lookup(const std::string &name) const {
+        return lookup(name.data(), name.size());
+    }
+
+private:
+
+    std::vector<const char*> names;
+    std::vector<size_t> lengths;
+    std::vector<int> slots;
+    unsigned int mask;
+    unsigned int seed;
+
+    static unsigned int hash(const char *name, size_t length, unsigned int seed) {
+        // FNV-1a
+        unsigned int h = 2166136261u ^ seed;
+        for (size_t i = 0; i < length; ++i) {
+            h = (h ^ (unsigned char)name[i]) * 16777619u;
+        }
+        return h ^ (h >> 15);
+    }
+
+    // Slots per name past which the search for a seed is given up on
+    static const size_t MAX_LOAD_INVERSE = 64;
+
+    void build() {
+        for (size_t i = 0; i < names.size(); ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                if (lengths[i] == lengths[j] && !memcmp(names[i], names[j], lengths[i])) {
+                    std::cerr << "PerfectHash: name \"" << names[i] << "\" appears twice, in rows "
+                              << j << " and " << i << std::endl;
+                    exit(1);
+                }
+            }
+        }
+
+        size_t size = 1;
+        while (size < 2 * names.size()) {
+            size *= 2;
+        }
+        for (; size <= MAX_LOAD_INVERSE * names.size() || size <= 2; size *= 2) {
+            mask = size - 1;
+            for (seed = 0; seed < 1000; ++seed) {
+                slots.assign(size, -1);
+                bool fCollision = false;
+                for (size_t i = 0; i < names.size() && !fCollision; ++i) {
+                    int &slot = slots[hash(names[i], lengths[i], seed) & mask];
+                    fCollision = slot >= 0;
+                    slot = i;
+                }
+                if (!fCollision) {
+                    return;
+                }
+            }
+        }
+        std::cerr << "PerfectHash: found no seed for " << names.size() << " names" << std::endl;
+        exit(1);
+    }
+};
+
+#endif // PERFECTHASH_H
@@ -0,0 +1,30 @@
+#ifndef STAGESTATS_H
+#define STAGESTATS_H
+
+#include <ostream>
+
+// Counts how often a vision processing stage ran and how often it was
+// skipped because it had nothing new to work with.  Parser reports them
+// all through printVisionStats().
+struct StageStats {
+    long run;
+    long skipped;
+
+    StageStats() : run(0), skipped(0) {}
+
+    // Counts a run if fRun and a skip otherwise, and returns fRun
+    bool count(bool fRun) {
+        if (fRun) {
+            run++;
+        } else {
+            skipped++;
+        }
+        return fRun;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream &out, const StageStats &stats) {
+    return out << stats.run << " run, " << stats.skipped << " skipped";
+}
+
+#endif // STAGESTATS_H
@@ -0,0 +1,67 @@
+#ifndef TOKEN_H
+#define TOKEN_H
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+#include "numparse.h"
+
+/*
+ * A piece of a message from the server, such as a perceptor or one of its
+ * words, pointing into the message instead of copying it out.  The
+ * message must outlive it.
+ */
+struct Token {
+    const char *str;
+    size_t length;
+
+    Token() : str(""), length(0) {}
+    Token(const char *str_, size_t length_) : str(str_), length(length_) {}
+    explicit Token(const std::string &s) : str(s.data()), length(s.size()) {}
+
+    inline size_t size() const {
+        return length;
+    }
+
+    // Throws std::out_of_range past the end like std::string::at()
+    inline char at(size_t i) const {
+        if (i >= length) {
+            throw std::out_of_range("Token::at");
+        }
+        return str[i];
+    }
+
+    // Whether the token is exactly s.  The length is checked first so that
+    // s is never read past its end, even for a token holding a NUL.
+    inline bool is(const char *s) const {
+        return strlen(s) == length && memcmp(str, s, length) == 0;
+    }
+    inline bool is(const std::string &s) const {
+        return s.size() == length && memcmp(str, s.data(), length) == 0;
+    }
+
+    inline bool contains(const char *s) const {
+        return std::search(str, str + length, s, s + strlen(s)) != str + length;
+    }
+
+    inline std::string toString() const {
+        return std::string(str, length);
+    }
+};
+
+inline std::ostream& operator<<(std::ostream &out, const Token &token) {
+    return out.write(token.str, token.length);
+}
+
+inline double parseDouble(const Token &token) {
+    return parseDouble(token.str, token.length);
+}
+
+inline int parseInt(const Token &token) {
+    return parseInt(token.str, token.length);
+}
+
+#endif // TOKEN_H
@@ -0,0 +1,83 @@
+#include "vocabulary.h"
+#include "../headers/headers.h"
+#include "../worldmodel/WorldObject.h"
+
+// For UT Walk
+#include <common/RobotInfo.h>
+
+const PlayModeName playModeNames[] = {
+    {"BeforeKickOff", PM_BEFORE_KICK_OFF},
+    {"KickOff_Left", PM_KICK_OFF_LEFT},
+    {"KickOff_Right", PM_KICK_OFF_RIGHT},
+    {"PlayOn", PM_PLAY_ON},
+    {"KickIn_Left", PM_KICK_IN_LEFT},
+    {"KickIn_Right", PM_KICK_IN_RIGHT},
+    {"Goal_Left", PM_GOAL_LEFT},
+    {"Goal_Right", PM_GOAL_RIGHT},
+    {"GameOver", PM_GAME_OVER},
+    //Extra
+    {"corner_kick_left", PM_CORNER_KICK_LEFT},
+    {"corner_kick_right", PM_CORNER_KICK_RIGHT},
+    {"goal_kick_left", PM_GOAL_KICK_LEFT},
+    {"goal_kick_right", PM_GOAL_KICK_RIGHT},
+    {"offside_left", PM_OFFSIDE_LEFT},
+    {"offside_right", PM_OFFSIDE_RIGHT},
+    {"free_kick_left", PM_FREE_KICK_LEFT},
+    {"free_kick_right", PM_FREE_KICK_RIGHT},
+    {"direct_free_kick_left", PM_DIRECT_FREE_KICK_LEFT},
+    {"direct_free_kick_right", PM_DIRECT_FREE_KICK_RIGHT}
+};
+const PerfectHash playModeHash(playModeNames, sizeof(playModeNames) / sizeof(playModeNames[0]));
+
+const HingeJointName hingeJointNames[] = {
+    {"hj1", HJ_H1, HeadYaw},
+    {"hj2", HJ_H2, HeadPitch},
+    {"laj1", HJ_LA1, LShoulderPitch},
+    {"laj2", HJ_LA2, LShoulderRoll},
+    {"laj3", HJ_LA3, LElbowYaw},
+    {"laj4", HJ_LA4, LElbowRoll},
+    {"raj1", HJ_RA1, RShoulderPitch},
+    {"raj2", HJ_RA2, RShoulderRoll},
+    {"raj3", HJ_RA3, RElbowYaw},
+    {"raj4", HJ_RA4, RElbowRoll},
+    {"llj1", HJ_LL1, LHipYawPitch},
+    {"llj2", HJ_LL2, LHipRoll},
+    {"llj3", HJ_LL3, LHipPitch},
+    {"llj4", HJ_LL4, LKneePitch},
+    {"llj5", HJ_LL5, LAnklePitch},
+    {"llj6", HJ_LL6, LAnkleRoll},
+    {"llj7", HJ_LL7, LToePitch},
+    {"rlj1", HJ_RL1, RHipYawPitch},
+    {"rlj2", HJ_RL2, RHipRoll},
+    {"rlj3", HJ_RL3, RHipPitch},
+    {"rlj4", HJ_RL4, RKneePitch},
+    {"rlj5", HJ_RL5, RAnklePitch},
+    {"rlj6", HJ_RL6, RAnkleRoll},
+    {"rlj7", HJ_RL7, RToePitch}
+};
+const PerfectHash hingeJointHash(hingeJointNames, sizeof(hingeJointNames) / sizeof(hingeJointNames[0]));
+
+const LandmarkName goalPostNames[] = {
+    {"G1L", GOALPOST_1_L},
+    {"G1R", GOALPOST_1_R},
+    {"G2L", GOALPOST_2_L},
+    {"G2R", GOALPOST_2_R}
+};
+const PerfectHash goalPostHash(goalPostNames, sizeof(goalPostNames) / sizeof(goalPostNames[0]));
+
+const LandmarkName flagNames[] = {
+    {"F1L", FLAG_1_L},
+    {"F1R", FLAG_1_R},
+    {"F2L", FLAG_2_L},
+    {"F2R", FLAG_2_R}
+};
+const PerfectHash flagHash(flagNames, sizeof(flagNames) / sizeof(flagNames[0]));
+
+const BodyPartName bodyPartNames[] = {
+    {"head", WO_TEAMMATE_HEAD1, WO_OPPONENT_HEAD1},
+    {"llowerarm", WO_TEAMMATE_ARM_L1, WO_OPPONENT_ARM_L1},
+    {"rlowerarm", WO_TEAMMATE_ARM_R1, WO_OPPONENT_ARM_R1},
+    {"lfoot", WO_TEAMMATE_FOOT_L1, WO_OPPONENT_FOOT_L1},
+    {"rfoot", WO_TEAMMATE_FOOT_R1, WO_OPPONENT_FOOT_R1}
+};
+const PerfectHash bodyPartHash(bodyPartNames, sizeof(bodyPartNames) / sizeof(bodyPartNames[0]));
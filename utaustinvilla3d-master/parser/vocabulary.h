@@ -0,0 +1,51 @@
+#ifndef VOCABULARY_H
+#define VOCABULARY_H
+
+#include "perfecthash.h"
+
+/*
+ * Vocabularies of the names perceptors report, each looked up with a
+ * PerfectHash instead of comparing against every name in turn.  The row a
+ * hash returns indexes the table it was built from.
+ */
+
+struct PlayModeName {
+    const char *name;
+    int playMode;
+};
+
+// Hinge joint names with their body model and UT Walk joint indices
+struct HingeJointName {
+    const char *name;
+    int indexBM;
+    int indexWE;
+};
+
+struct LandmarkName {
+    const char *name;
+    int index;
+};
+
+// Body parts seen on players, with the world objects of uNum 1
+struct BodyPartName {
+    const char *name;
+    int teammate1;
+    int opponent1;
+};
+
+extern const PlayModeName playModeNames[];
+extern const PerfectHash playModeHash;
+
+extern const HingeJointName hingeJointNames[];
+extern const PerfectHash hingeJointHash;
+
+extern const LandmarkName goalPostNames[];
+extern const PerfectHash goalPostHash;
+
+extern const LandmarkName flagNames[];
+extern const PerfectHash flagHash;
+
+extern const BodyPartName bodyPartNames[];
+extern const PerfectHash bodyPartHash;
+
+#endif // VOCABULARY_H
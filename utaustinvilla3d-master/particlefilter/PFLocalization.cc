@@ -11,6 +11,8 @@ PFLocalization::PFLocalization(WorldModel* worldModel_, BodyModel* bodyModel_, M
     worldModel = worldModel_;
     bodyModel = bodyModel_;
     core = core_;
+    fLandmarksSeen = false;
+    fLinesSeen = false;
 
     partParams.draw = false;
     partParams.USE_ALT_LINE_LOC = false;
@@ -186,7 +188,7 @@ bool lineGreaterThan(SIM::Line2D a, SIM::Line2D b) {
 }
 
 void PFLocalization::fillMyObservedLines() {
-    vector<VisionObject> myLines = worldModel->getWorldObject(LINE)->lines;
+    vector<VisionObject> &myLines = worldModel->getWorldObject(LINE)->lines;
     vector<SIM::Line2D>shortLines;
     myObservedLines.clear();
     for (int i=0; i < (int) myLines.size(); i++) {
@@ -229,7 +231,9 @@ void PFLocalization::processFrame() {
     updateParticlesFromOdometry();
     fillMyObservedLines();
 
-    if( atleastOneObjSeen() || atLeastOneLineSeen()) {
+    fLandmarksSeen = atleastOneObjSeen();
+    fLinesSeen = atLeastOneLineSeen();
+    if( fLandmarksSeen || fLinesSeen ) {
         if (!worldModel->isFallen()) {
             // [patmac] this should really be based on the variance of particles
             worldModel->setLocalized(true);
@@ -252,7 +256,7 @@ void PFLocalization::processFrame() {
     worldModel->setMyConfidence( conf );
 
 
-    if( atleastOneObjSeen() || atLeastOneLineSeen()) {
+    if( fLandmarksSeen || fLinesSeen ) {
         if( processingIteration % partParams.RESAMPLE_FREQ == 0 ) {
             resampleParticles();
             bool useProbForRandWalk = false;
@@ -356,17 +360,16 @@ void PFLocalization::updateParticlesFromOdometry() {
     // compute accumulated displacement
     VecPosition estimatedPosDisp( 0, 0, 0 );
     double estimatedAngleDispDeg = 0;
-    const vector<SkillType>& executedSkills = worldModel->getExecutedSkills();
-    vector<SkillType>::const_iterator begin( executedSkills.begin() );
-    vector<SkillType>::const_iterator end( executedSkills.end() );
+    const RingBuffer<SkillType, MAX_EXECUTED_SKILLS>& executedSkills = worldModel->getExecutedSkills();
 
 //cerr << "skills executed: " << executedSkills.size() << endl;;
-    for( ; begin != end; ++begin ) {
-        // cerr << "Executed skill: " << EnumParser<SkillType>::getStringFromEnum(*begin)  << endl;
+    // Oldest first
+    for( int i = executedSkills.size() - 1; i >= 0; --i ) {
+        // cerr << "Executed skill: " << EnumParser<SkillType>::getStringFromEnum(executedSkills[i])  << endl;
 
         VecPosition currentDirection = getDirectionVector( Deg2Rad( estimatedAngleDispDeg ) );
         VecPosition lateralDirection = VecPosition(0, 0, 1.0).crossProduct(currentDirection);
-        SkillType skill = *begin;
+        SkillType skill = executedSkills[i];
 
         // if skill exists in table - get values, otherwise it is 0
         if( skillVectorDisplacement.find( skill ) != skillVectorDisplacement.end() ) {
@@ -436,6 +439,8 @@ void PFLocalization::updateParticlesFromObservations() {
     headAnglePan = bodyModel->getJointAngle(EFF_H1);
     headPanOffset = Deg2Rad((int)headAnglePan % 360);
     //cout << "headAnglePan: " << headAnglePan << endl;
+    landmarkStats.count(partParams.USE_LANDMARKS && fLandmarksSeen);
+    lineStats.count(partParams.USE_LINES && fLinesSeen);
     for (int i = 0; i < partParams.NUM_PARTICLES; i++) {
 
 #ifdef ALLOW_LOC_DEBUG
@@ -491,12 +496,12 @@ void PFLocalization::updateParticleFromObservations(Particle *part, int counter)
 
     double newLogProb = 0;
 
-    // observations of distinct landmarks
-    if (partParams.USE_LANDMARKS) {
+    // observations of distinct landmarks, which add nothing if none were seen
+    if (partParams.USE_LANDMARKS && fLandmarksSeen) {
         newLogProb += updateParticleFromLandmarks(part);
     }
 
-    if (partParams.USE_LINES) {
+    if (partParams.USE_LINES && fLinesSeen) {
         newLogProb += updateParticleFromLines(part, false);
     }
 
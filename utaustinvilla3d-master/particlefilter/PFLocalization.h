@@ -5,6 +5,7 @@
 #include "../worldmodel/worldmodel.h"
 #include "../bodymodel/bodymodel.h"
 #include "../headers/Field.h"
+#include "../parser/stagestats.h"
 
 #include <MotionCore.h>
 
@@ -177,6 +178,13 @@ public:
     void fillMyObservedLines();
     void resetMatchings();
 
+    // Whether landmarks and lines were seen this frame, so that particles
+    // are only weighed against observations there are
+    bool fLandmarksSeen;
+    bool fLinesSeen;
+    StageStats landmarkStats;
+    StageStats lineStats;
+
     // PFLocalization functions on particles
 
 
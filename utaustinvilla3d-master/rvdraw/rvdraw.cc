@@ -35,6 +35,7 @@ RVSender::RVSender()
 {
     socketCreated = false;
     sockfd = -1;
+    initArena();
 
     struct addrinfo hints, *servinfo, *p_ptr;
     int rv;
@@ -73,8 +74,6 @@ RVSender::RVSender()
     //freeaddrinfo(servinfo);
     side = -1;
     uNum = -1;
-    sideMap[SIDE_LEFT]  = "L";
-    sideMap[SIDE_RIGHT] = "R";
 }
 
 /**
@@ -87,14 +86,26 @@ RVSender::RVSender(int sockfd_, struct addrinfo p_)
     socketCreated = false;
     p = p_;
     sockfd = sockfd_;
+    initArena();
 }
 
 RVSender::~RVSender()
 {
+    flush();
     if (socketCreated)
         close(sockfd);
 }
 
+void RVSender::initArena()
+{
+    arenaUsed = 0;
+    numPackets = 0;
+    packetBudget = RV_DEFAULT_PACKET_BUDGET;
+    cyclePackets = 0;
+    droppedPackets = 0;
+    fWarnedDropped = false;
+}
+
 /*
 int RVSender::getSockFD()
  {
@@ -184,26 +195,29 @@ void RVSender::getColor(int uNum, int side, float &r, float &g, float &b) {
     }
 }
 
-string RVSender::getMyId() {
-    stringstream stream;
-    stream << sideMap[side] << '.' << std::setfill('0') <<
-           std::setw(2) << boost::lexical_cast<std::string>(uNum);
-    return stream.str();
+// The ids are built in idBuf, which keeps its capacity between draw commands
+const string* RVSender::getMyId() {
+    char id[16];
+    snprintf(id, sizeof(id), "%s.%02d", side == SIDE_LEFT ? "L" : "R", uNum);
+    idBuf = id;
+    return &idBuf;
 }
 
-string RVSender::getDrawingId(const string* name) {
-    stringstream stream;
-    stream << getMyId() << '.' << *name;
-    return stream.str();
+const string* RVSender::getDrawingId(const string& name) {
+    getMyId();
+    idBuf += '.';
+    idBuf += name;
+    return &idBuf;
 }
 
-string RVSender::getUniqueId(long unique) {
-    stringstream stream;
-    stream << '_' << unique << '.' << getMyId();
-    return stream.str();
+const string* RVSender::getUniqueId(long unique) {
+    char id[32];
+    snprintf(id, sizeof(id), "_%ld.%s.%02d", unique, side == SIDE_LEFT ? "L" : "R", uNum);
+    idBuf = id;
+    return &idBuf;
 }
 
-string RVSender::getUniqueId() {
+const string* RVSender::getUniqueId() {
     return getUniqueId(uniqueIdNum++);
 }
 
@@ -214,8 +228,64 @@ void RVSender::flipPolygon(float *v, int numVerts) {
     }
 }
 
-void RVSender::updateDrawings(string id, string buf) {
-    drawings[id] = buf;
+unsigned char* RVSender::newPacket(int bufSize, bool fBudgeted) {
+    if (fBudgeted) {
+        if (cyclePackets >= packetBudget || bufSize > RV_ARENA_SIZE) {
+            droppedPackets++;
+            return NULL;
+        }
+        cyclePackets++;
+    }
+    if (arenaUsed + bufSize > RV_ARENA_SIZE || numPackets == RV_MAX_QUEUED_PACKETS) {
+        flush();
+    }
+    if (bufSize > RV_ARENA_SIZE) {
+        return NULL;
+    }
+
+    unsigned char* buf = arena + arenaUsed;
+    packets[numPackets].iov_base = buf;
+    packets[numPackets].iov_len = bufSize;
+    numPackets++;
+    arenaUsed += bufSize;
+    return buf;
+}
+
+/*
+ * Sends all queued packets, with as few system calls as possible
+ */
+void RVSender::flush() {
+    if (numPackets == 0) {
+        return;
+    }
+#ifdef __linux__
+    struct mmsghdr msgs[RV_MAX_QUEUED_PACKETS];
+    memset(msgs, 0, numPackets * sizeof(struct mmsghdr));
+    for (int i = 0; i < numPackets; i++) {
+        msgs[i].msg_hdr.msg_name = p.ai_addr;
+        msgs[i].msg_hdr.msg_namelen = p.ai_addrlen;
+        msgs[i].msg_hdr.msg_iov = &packets[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int sent = 0;
+    while (sent < numPackets) {
+        int n = sendmmsg(sockfd, msgs + sent, numPackets - sent, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            // Drawing is best effort, whatever didn't make it is lost
+            break;
+        }
+        sent += n;
+    }
+#else
+    for (int i = 0; i < numPackets; i++) {
+        sendto(sockfd, packets[i].iov_base, packets[i].iov_len, 0, p.ai_addr, p.ai_addrlen);
+    }
+#endif
+    numPackets = 0;
+    arenaUsed = 0;
 }
 
 
@@ -223,21 +293,20 @@ void RVSender::updateDrawings(string id, string buf) {
 // Protect them with a check for isInit()
 
 void RVSender::clear() {
-    if (!isInit()) {
-        return;
-    }
-    for (map<string,string>::iterator it = drawings.begin();
-            it != drawings.end(); ++it) {
-        it->second = "";
-    }
 }
 
 void RVSender::refresh() {
     if (!isInit()) {
         return;
     }
-    string myId(getMyId());
-    swapBuffers(&myId);
+    swapBuffers(getMyId());
+    flush();
+
+    if (droppedPackets > 0 && !fWarnedDropped) {
+        cerr << "RVSender: more than " << packetBudget << " draw commands in a cycle, dropping the rest" << endl;
+        fWarnedDropped = true;
+    }
+    cyclePackets = 0;
 }
 
 void RVSender::clearStaticDrawings() {
@@ -245,13 +314,12 @@ void RVSender::clearStaticDrawings() {
         return;
     }
     for (long i = 0; i < uniqueIdNum; i++) {
-        string uniqueId = getUniqueId(i);
-        swapBuffers(&uniqueId);
+        swapBuffers(getUniqueId(i));
     }
     uniqueIdNum = 0;
 }
 
-void RVSender::drawCircle(string name, double x, double y, double radius,
+void RVSender::drawCircle(const string& name, double x, double y, double radius,
                           RVSender::Color c) {
     if (!isInit()) {
         return;
@@ -261,7 +329,7 @@ void RVSender::drawCircle(string name, double x, double y, double radius,
     drawCircle(name, x, y, radius, r, g, b);
 }
 
-void RVSender::drawCircle(string name, double x, double y, double radius, float r, float g, float b) {
+void RVSender::drawCircle(const string& name, double x, double y, double radius, float r, float g, float b) {
     if (!isInit()) {
         return;
     }
@@ -269,10 +337,8 @@ void RVSender::drawCircle(string name, double x, double y, double radius, float
         x *= -1;
         y *= -1;
     }
-    string id = getDrawingId(&name);
-    string buf = string(id);
-    drawCircle(x, y, radius, 3, r, g, b, &buf);
-    updateDrawings(id, buf);
+    const string* id = getDrawingId(name);
+    drawCircle(x, y, radius, 3, r, g, b, id);
 }
 
 void RVSender::drawCircle(double x, double y, double radius, RVSender::Color c) {
@@ -292,13 +358,12 @@ void RVSender::drawCircle(double x, double y, double radius, float r, float g, f
         x *= -1;
         y *= -1;
     }
-    string id = getUniqueId();
-    string buf = string(id);
-    drawCircle(x, y, radius, 3, r, g, b, &buf);
-    swapBuffers(&id);
+    const string* id = getUniqueId();
+    drawCircle(x, y, radius, 3, r, g, b, id);
+    swapBuffers(id);
 }
 
-void RVSender::drawLine(string name, double x1, double y1, double x2, double y2,
+void RVSender::drawLine(const string& name, double x1, double y1, double x2, double y2,
                         RVSender::Color c) {
     if (!isInit()) {
         return;
@@ -308,7 +373,7 @@ void RVSender::drawLine(string name, double x1, double y1, double x2, double y2,
     drawLine(name, x1, y1, x2, y2, r, g, b);
 }
 
-void RVSender::drawLine(string name, double x1, double y1, double x2, double y2,
+void RVSender::drawLine(const string& name, double x1, double y1, double x2, double y2,
                         float r, float g, float b) {
     if (!isInit()) {
         return;
@@ -319,10 +384,8 @@ void RVSender::drawLine(string name, double x1, double y1, double x2, double y2,
         x2 *= -1;
         y2 *= -1;
     }
-    string id = getDrawingId(&name);
-    string buf = string(id);
-    drawLine(x1, y1, 0, x2, y2, 0, 3, r, g, b, &buf);
-    updateDrawings(id, buf);
+    const string* id = getDrawingId(name);
+    drawLine(x1, y1, 0, x2, y2, 0, 3, r, g, b, id);
 }
 
 void RVSender::drawLine(double x1, double y1, double x2, double y2, RVSender::Color c) {
@@ -344,13 +407,12 @@ void RVSender::drawLine(double x1, double y1, double x2, double y2, float r, flo
         x2 *= -1;
         y2 *= -1;
     }
-    string id = getUniqueId();
-    string buf = string(id);
-    drawLine(x1, y1, 0, x2, y2, 0, 3, r, g, b, &buf);
-    swapBuffers(&id);
+    const string* id = getUniqueId();
+    drawLine(x1, y1, 0, x2, y2, 0, 3, r, g, b, id);
+    swapBuffers(id);
 }
 
-void RVSender::drawText(string name, string text, double x, double y,
+void RVSender::drawText(const string& name, string text, double x, double y,
                         RVSender::Color c) {
     if (!isInit()) {
         return;
@@ -360,7 +422,7 @@ void RVSender::drawText(string name, string text, double x, double y,
     drawText(name, text, x, y, r, g, b);
 }
 
-void RVSender::drawText(string name, string text, double x, double y,
+void RVSender::drawText(const string& name, string text, double x, double y,
                         float r, float g, float b) {
     if (!isInit()) {
         return;
@@ -369,10 +431,8 @@ void RVSender::drawText(string name, string text, double x, double y,
         x *= -1;
         y *= -1;
     }
-    string id = getDrawingId(&name);
-    string buf = string(id);
-    drawAnnotation(&text, x, y, 0, r, g, b, &buf);
-    updateDrawings(id, buf);
+    const string* id = getDrawingId(name);
+    drawAnnotation(&text, x, y, 0, r, g, b, id);
 }
 
 void RVSender::drawText(string text, double x, double y,
@@ -394,13 +454,12 @@ void RVSender::drawText(string text, double x, double y,
         x *= -1;
         y *= -1;
     }
-    string id = getUniqueId();
-    string buf = string(id);
-    drawAnnotation(&text, x, y, 0, r, g, b, &buf);
-    swapBuffers(&id);
+    const string* id = getUniqueId();
+    drawAnnotation(&text, x, y, 0, r, g, b, id);
+    swapBuffers(id);
 }
 
-void RVSender::drawPoint(string name, double x, double y, double radius,
+void RVSender::drawPoint(const string& name, double x, double y, double radius,
                          RVSender::Color c) {
     if (!isInit()) {
         return;
@@ -410,7 +469,7 @@ void RVSender::drawPoint(string name, double x, double y, double radius,
     drawPoint(name, x, y, radius, r, g, b);
 }
 
-void RVSender::drawPoint(string name, double x, double y, double radius,
+void RVSender::drawPoint(const string& name, double x, double y, double radius,
                          float r, float g, float b) {
     if (!isInit()) {
         return;
@@ -419,10 +478,8 @@ void RVSender::drawPoint(string name, double x, double y, double radius,
         x *= -1;
         y *= -1;
     }
-    string id = getDrawingId(&name);
-    string buf = string(id);
-    drawPoint(x, y, 0, radius, r, g, b, &buf);
-    updateDrawings(id, buf);
+    const string* id = getDrawingId(name);
+    drawPoint(x, y, 0, radius, r, g, b, id);
 }
 
 void RVSender::drawPoint(double x, double y, double radius,
@@ -444,13 +501,12 @@ void RVSender::drawPoint(double x, double y, double radius,
         x *= -1;
         y *= -1;
     }
-    string id = getUniqueId();
-    string buf = string(id);
-    drawPoint(x, y, 0, radius, r, g, b, &buf);
-    swapBuffers(&id);
+    const string* id = getUniqueId();
+    drawPoint(x, y, 0, radius, r, g, b, id);
+    swapBuffers(id);
 }
 
-void RVSender::drawSphere(string name, double x, double y, double z,
+void RVSender::drawSphere(const string& name, double x, double y, double z,
                           double radius, RVSender::Color c) {
     if (!isInit()) {
         return;
@@ -460,7 +516,7 @@ void RVSender::drawSphere(string name, double x, double y, double z,
     drawSphere(name, x, y, z, radius, r, g, b);
 }
 
-void RVSender::drawSphere(string name, double x, double y, double z,
+void RVSender::drawSphere(const string& name, double x, double y, double z,
                           double radius, float r, float g, float b) {
     if (!isInit()) {
         return;
@@ -469,10 +525,8 @@ void RVSender::drawSphere(string name, double x, double y, double z,
         x *= -1;
         y *= -1;
     }
-    string id = getDrawingId(&name);
-    string buf = string(id);
-    drawSphere(x, y, 0, radius, r, g, b, &buf);
-    updateDrawings(id, buf);
+    const string* id = getDrawingId(name);
+    drawSphere(x, y, 0, radius, r, g, b, id);
 }
 
 void RVSender::drawSphere(double x, double y, double z,
@@ -494,13 +548,12 @@ void RVSender::drawSphere(double x, double y, double z,
         x *= -1;
         y *= -1;
     }
-    string id = getUniqueId();
-    string buf = string(id);
-    drawSphere(x, y, 0, radius, r, g, b, &buf);
-    swapBuffers(&id);
+    const string* id = getUniqueId();
+    drawSphere(x, y, 0, radius, r, g, b, id);
+    swapBuffers(id);
 }
 
-void RVSender::drawPolygon(string name, float *v, int numVerts, float a) {
+void RVSender::drawPolygon(const string& name, float *v, int numVerts, float a) {
     float r, g, b;
     if (!isInit()) {
         return;
@@ -509,7 +562,7 @@ void RVSender::drawPolygon(string name, float *v, int numVerts, float a) {
     drawPolygon(name, v, numVerts, r, g, b, a);
 }
 
-void RVSender::drawPolygon(string name, float *v, int numVerts,
+void RVSender::drawPolygon(const string& name, float *v, int numVerts,
                            RVSender::Color c, float a) {
     if (!isInit()) {
         return;
@@ -519,7 +572,7 @@ void RVSender::drawPolygon(string name, float *v, int numVerts,
     drawPolygon(name, v, numVerts, r, g, b, a);
 }
 
-void RVSender::drawPolygon(string name, float *v, int numVerts,
+void RVSender::drawPolygon(const string& name, float *v, int numVerts,
                            float r, float g, float b, float a) {
     if (!isInit()) {
         return;
@@ -527,10 +580,8 @@ void RVSender::drawPolygon(string name, float *v, int numVerts,
     if (side == SIDE_RIGHT) {
         flipPolygon(v, numVerts);
     }
-    string id = getDrawingId(&name);
-    string buf = string(id);
-    drawPolygon((float*)v, numVerts, r, g, b, a, &buf);
-    updateDrawings(id, buf);
+    const string* id = getDrawingId(name);
+    drawPolygon((float*)v, numVerts, r, g, b, a, id);
 }
 
 void RVSender::drawPolygon(float *v, int numVerts) {
@@ -567,10 +618,9 @@ void RVSender::drawPolygon(float *v, int numVerts,
     if (side == SIDE_RIGHT) {
         flipPolygon(v, numVerts);
     }
-    string id = getUniqueId();
-    string buf = string(id);
-    drawPolygon((float*)v, numVerts, r, g, b, a, &buf);
-    swapBuffers(&id);
+    const string* id = getUniqueId();
+    drawPolygon((float*)v, numVerts, r, g, b, a, id);
+    swapBuffers(id);
 }
 
 void RVSender::drawAgentText(string text, RVSender::Color c) {
@@ -642,10 +692,7 @@ void RVSender::swapBuffers(const string* setName) {
     if (!isInit()) {
         return;
     }
-    int bufSize = -1;
-    unsigned char* buf = newBufferSwap(setName, &bufSize);
-    sendto(sockfd, buf, bufSize, 0, p.ai_addr, p.ai_addrlen);
-    delete[] buf;
+    queueBufferSwap(setName);
 }
 
 void RVSender::drawLine(float x1, float y1, float z1, float x2, float y2, float z2, float thickness, float r, float g, float b,
@@ -657,10 +704,7 @@ void RVSender::drawLine(float x1, float y1, float z1, float x2, float y2, float
     float pb[3] = {x2,y2,z2};
     float color[3] = {r,g,b};
 
-    int bufSize = -1;
-    unsigned char* buf = newLine(pa, pb, thickness, color, setName, &bufSize);
-    sendto(sockfd, buf, bufSize, 0, p.ai_addr, p.ai_addrlen);
-    delete[] buf;
+    queueLine(pa, pb, thickness, color, setName);
 }
 
 void RVSender::drawCircle(float x, float y, float radius, float thickness, float r, float g, float b, const string* setName) {
@@ -670,10 +714,7 @@ void RVSender::drawCircle(float x, float y, float radius, float thickness, float
     float center[2] = {x,y};
     float color[3] = {r,g,b};
 
-    int bufSize = -1;
-    unsigned char* buf = newCircle(center, radius, thickness, color, setName, &bufSize);
-    sendto(sockfd, buf, bufSize, 0, p.ai_addr, p.ai_addrlen);
-    delete[] buf;
+    queueCircle(center, radius, thickness, color, setName);
 }
 
 void RVSender::drawSphere(float x, float y, float z, float radius, float r, float g, float b, const string* setName) {
@@ -683,10 +724,7 @@ void RVSender::drawSphere(float x, float y, float z, float radius, float r, floa
     float center[3] = {x,y,z};
     float color[3] = {r,g,b};
 
-    int bufSize = -1;
-    unsigned char* buf = newSphere(center, radius, color, setName, &bufSize);
-    sendto(sockfd, buf, bufSize, 0, p.ai_addr, p.ai_addrlen);
-    delete[] buf;
+    queueSphere(center, radius, color, setName);
 }
 
 void RVSender::drawPoint(float x, float y, float z, float size, float r, float g, float b, const string* setName) {
@@ -698,10 +736,7 @@ void RVSender::drawPoint(float x, float y, float z, float size, float r, float g
 
     //printf("Point: (%f, %f, %f)\n", x, y, z);
 
-    int bufSize = -1;
-    unsigned char* buf = newPoint(center, size, color, setName, &bufSize);
-    sendto(sockfd, buf, bufSize, 0, p.ai_addr, p.ai_addrlen);
-    delete[] buf;
+    queuePoint(center, size, color, setName);
 }
 
 void RVSender::drawPolygon(const float* v, int numVerts, float r, float g, float b, float a,
@@ -711,10 +746,7 @@ void RVSender::drawPolygon(const float* v, int numVerts, float r, float g, float
     }
     float color[4] = {r,g,b,a};
 
-    int bufSize = -1;
-    unsigned char* buf = newPolygon(v, numVerts, color, setName, &bufSize);
-    sendto(sockfd, buf, bufSize, 0, p.ai_addr, p.ai_addrlen);
-    delete[] buf;
+    queuePolygon(v, numVerts, color, setName);
 }
 
 void RVSender::drawAnnotation(const string *txt, float x, float y, float z,
@@ -725,10 +757,7 @@ void RVSender::drawAnnotation(const string *txt, float x, float y, float z,
     }
     float color[3] = {r,g,b};
     float point[3] = {x,y,z};
-    int bufSize = -1;
-    unsigned char *buf = newAnnotation(txt, point, color, setName, &bufSize);
-    sendto(sockfd, buf, bufSize, 0, p.ai_addr, p.ai_addrlen);
-    delete[] buf;
+    queueAnnotation(txt, point, color, setName);
 }
 
 void RVSender::drawAgentAnnotation(const string *txt, char teamAgent,
@@ -738,10 +767,7 @@ void RVSender::drawAgentAnnotation(const string *txt, char teamAgent,
         return;
     }
     float color[3] = {r,g,b};
-    int bufSize = -1;
-    unsigned char *buf = newAgentAnnotation(txt, teamAgent, color, &bufSize);
-    sendto(sockfd, buf, bufSize, 0, p.ai_addr, p.ai_addrlen);
-    delete[] buf;
+    queueAgentAnnotation(txt, teamAgent, color);
 }
 
 void RVSender::removeAgentAnnotation(char teamAgent)
@@ -749,10 +775,7 @@ void RVSender::removeAgentAnnotation(char teamAgent)
     if (!isInit()) {
         return;
     }
-    int bufSize = -1;
-    unsigned char *buf = newRemoveAgentAnnotation(teamAgent, &bufSize);
-    sendto(sockfd, buf, bufSize, 0, p.ai_addr, p.ai_addrlen);
-    delete[] buf;
+    queueRemoveAgentAnnotation(teamAgent);
 }
 
 void RVSender::selectAgent(char teamAgent)
@@ -760,32 +783,33 @@ void RVSender::selectAgent(char teamAgent)
     if (!isInit()) {
         return;
     }
-    int bufSize = -1;
-    unsigned char *buf = newSelectAgent(teamAgent, &bufSize);
-    sendto(sockfd, buf, bufSize, 0, p.ai_addr, p.ai_addrlen);
-    delete[] buf;
+    queueSelectAgent(teamAgent);
 }
 
-// The following commands allocate memory, if you use them be sure to deallocate
-// the memory later.
+// The following commands build their packet in place in the arena, to be
+// sent by the next flush().
 
-unsigned char* RVSender::newBufferSwap(const string* name, int* bufSize) {
-    *bufSize = 3 + ((name != NULL) ? name->length() : 0);
-    unsigned char* buf = new unsigned char[*bufSize];
+void RVSender::queueBufferSwap(const string* name) {
+    int bufSize = 3 + ((name != NULL) ? name->length() : 0);
+    unsigned char* buf = newPacket(bufSize, false);
+    if (buf == NULL) {
+        return;
+    }
 
     long i = 0;
     i += writeCharToBuf(buf+i, 0);
     i += writeCharToBuf(buf+i, 0);
     i += writeStringToBuf(buf+i, name);
-
-    return buf;
 }
 
-unsigned char* RVSender::newCircle(const float* center, float radius, float thickness,
-                                   const float* color, const string* setName, int* bufSize) {
+void RVSender::queueCircle(const float* center, float radius, float thickness,
+                           const float* color, const string* setName) {
 
-    *bufSize = 30 + ((setName != NULL) ? setName->length() : 0);
-    unsigned char* buf = new unsigned char[*bufSize];
+    int bufSize = 30 + ((setName != NULL) ? setName->length() : 0);
+    unsigned char* buf = newPacket(bufSize);
+    if (buf == NULL) {
+        return;
+    }
 
     long i = 0;
     i += writeCharToBuf(buf+i, 1);
@@ -796,15 +820,16 @@ unsigned char* RVSender::newCircle(const float* center, float radius, float thic
     i += writeFloatToBuf(buf+i, thickness);
     i += writeColorToBuf(buf+i, color, 3);
     i += writeStringToBuf(buf+i, setName);
-
-    return buf;
 }
 
-unsigned char* RVSender::newLine(const float* a, const float* b, float thickness,
-                                 const float* color, const string* setName, int* bufSize) {
+void RVSender::queueLine(const float* a, const float* b, float thickness,
+                         const float* color, const string* setName) {
 
-    *bufSize = 48 + ((setName != NULL) ? setName->length() : 0);
-    unsigned char* buf = new unsigned char[*bufSize];
+    int bufSize = 48 + ((setName != NULL) ? setName->length() : 0);
+    unsigned char* buf = newPacket(bufSize);
+    if (buf == NULL) {
+        return;
+    }
 
     long i = 0;
     i += writeCharToBuf(buf+i, 1);
@@ -818,15 +843,16 @@ unsigned char* RVSender::newLine(const float* a, const float* b, float thickness
     i += writeFloatToBuf(buf+i, thickness);
     i += writeColorToBuf(buf+i, color, 3);
     i += writeStringToBuf(buf+i, setName);
-
-    return buf;
 }
 
-unsigned char* RVSender::newPoint(const float* p, float size, const float* color,
-                                  const string* setName, int* bufSize) {
+void RVSender::queuePoint(const float* p, float size, const float* color,
+                          const string* setName) {
 
-    *bufSize = 30 + ((setName != NULL) ? setName->length() : 0);
-    unsigned char* buf = new unsigned char[*bufSize];
+    int bufSize = 30 + ((setName != NULL) ? setName->length() : 0);
+    unsigned char* buf = newPacket(bufSize);
+    if (buf == NULL) {
+        return;
+    }
 
     long i = 0;
     i += writeCharToBuf(buf+i, 1);
@@ -837,15 +863,16 @@ unsigned char* RVSender::newPoint(const float* p, float size, const float* color
     i += writeFloatToBuf(buf+i, size);
     i += writeColorToBuf(buf+i, color, 3);
     i += writeStringToBuf(buf+i, setName);
-
-    return buf;
 }
 
-unsigned char* RVSender::newSphere(const float* p, float radius, const float* color,
-                                   const string* setName, int* bufSize) {
+void RVSender::queueSphere(const float* p, float radius, const float* color,
+                           const string* setName) {
 
-    *bufSize = 30 + ((setName != NULL) ? setName->length() : 0);
-    unsigned char* buf = new unsigned char[*bufSize];
+    int bufSize = 30 + ((setName != NULL) ? setName->length() : 0);
+    unsigned char* buf = newPacket(bufSize);
+    if (buf == NULL) {
+        return;
+    }
 
     long i = 0;
     i += writeCharToBuf(buf+i, 1);
@@ -856,15 +883,16 @@ unsigned char* RVSender::newSphere(const float* p, float radius, const float* co
     i += writeFloatToBuf(buf+i, radius);
     i += writeColorToBuf(buf+i, color, 3);
     i += writeStringToBuf(buf+i, setName);
-
-    return buf;
 }
 
-unsigned char* RVSender::newPolygon(const float* v, int numVerts, const float* color,
-                                    const string* setName, int* bufSize) {
+void RVSender::queuePolygon(const float* v, int numVerts, const float* color,
+                            const string* setName) {
 
-    *bufSize = 18 * numVerts + 8 + ((setName != NULL) ? setName->length() : 0);
-    unsigned char* buf = new unsigned char[*bufSize];
+    int bufSize = 18 * numVerts + 8 + ((setName != NULL) ? setName->length() : 0);
+    unsigned char* buf = newPacket(bufSize);
+    if (buf == NULL) {
+        return;
+    }
 
     long i = 0;
     i += writeCharToBuf(buf+i, 1);
@@ -879,16 +907,17 @@ unsigned char* RVSender::newPolygon(const float* v, int numVerts, const float* c
     }
 
     i += writeStringToBuf(buf+i, setName);
-
-    return buf;
 }
 
-unsigned char* RVSender::newAnnotation(const string *txt, const float *p, const float* color,
-                                       const string* setName, int* bufSize) {
+void RVSender::queueAnnotation(const string *txt, const float *p, const float* color,
+                               const string* setName) {
 
-    *bufSize = 25 + ((setName != NULL) ? setName->length() : 0)
+    int bufSize = 25 + ((setName != NULL) ? setName->length() : 0)
                + ((txt != NULL) ? txt->length(): 0);
-    unsigned char* buf = new unsigned char[*bufSize];
+    unsigned char* buf = newPacket(bufSize);
+    if (buf == NULL) {
+        return;
+    }
 
     long i = 0;
     i += writeCharToBuf(buf+i, 2);
@@ -899,14 +928,15 @@ unsigned char* RVSender::newAnnotation(const string *txt, const float *p, const
     i += writeColorToBuf(buf+i, color, 3);
     i += writeStringToBuf(buf+i, txt);
     i += writeStringToBuf(buf+i, setName);
-
-    return buf;
 }
 
-unsigned char* RVSender::newAgentAnnotation(const string *txt, const char teamAgent, const float* color, int* bufSize) {
+void RVSender::queueAgentAnnotation(const string *txt, const char teamAgent, const float* color) {
 
-    *bufSize = 7 + ((txt != NULL) ? txt->length(): 0);
-    unsigned char* buf = new unsigned char[*bufSize];
+    int bufSize = 7 + ((txt != NULL) ? txt->length(): 0);
+    unsigned char* buf = newPacket(bufSize);
+    if (buf == NULL) {
+        return;
+    }
 
     long i = 0;
     i += writeCharToBuf(buf+i, 2);
@@ -914,34 +944,34 @@ unsigned char* RVSender::newAgentAnnotation(const string *txt, const char teamAg
     i += writeCharToBuf(buf+i, teamAgent);
     i += writeColorToBuf(buf+i, color, 3);
     i += writeStringToBuf(buf+i, txt);
-
-    return buf;
 }
 
-unsigned char* RVSender::newRemoveAgentAnnotation(const char teamAgent, int* bufSize) {
+void RVSender::queueRemoveAgentAnnotation(const char teamAgent) {
 
-    *bufSize = 3;
-    unsigned char* buf = new unsigned char[*bufSize];
+    int bufSize = 3;
+    unsigned char* buf = newPacket(bufSize, false);
+    if (buf == NULL) {
+        return;
+    }
 
     long i = 0;
     i += writeCharToBuf(buf+i, 2);
     i += writeCharToBuf(buf+i, 2);
     i += writeCharToBuf(buf+i, teamAgent);
-
-    return buf;
 }
 
-unsigned char* RVSender::newSelectAgent(const char teamAgent, int* bufSize) {
+void RVSender::queueSelectAgent(const char teamAgent) {
 
-    *bufSize = 3;
-    unsigned char* buf = new unsigned char[*bufSize];
+    int bufSize = 3;
+    unsigned char* buf = newPacket(bufSize, false);
+    if (buf == NULL) {
+        return;
+    }
 
     long i = 0;
     i += writeCharToBuf(buf+i, 3);
     i += writeCharToBuf(buf+i, 0);
     i += writeCharToBuf(buf+i, teamAgent);
-
-    return buf;
 }
 
 /*
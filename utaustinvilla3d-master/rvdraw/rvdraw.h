@@ -27,6 +27,7 @@
 #include <string.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -39,6 +40,15 @@
 
 #define ROBOVIS_PORT "32769"
 
+// Draw packets are queued in a fixed arena and sent together at refresh(),
+// or earlier if the arena or packet table fills up
+#define RV_ARENA_SIZE (64*1024)
+#define RV_MAX_QUEUED_PACKETS 1024
+
+// Default number of draw packets sent per cycle, shapes drawn after that
+// are dropped until the next refresh()
+#define RV_DEFAULT_PACKET_BUDGET 256
+
 using namespace std;
 
 inline int writeCharToBuf(unsigned char* buf, unsigned char value) {
@@ -68,12 +78,6 @@ inline int writeStringToBuf(unsigned char* buf, const string* text) {
     return i;
 }
 
-//for the drawings map
-struct DrawObject {
-    string id;
-    string buf;
-};
-
 class RVSender
 {
 private:
@@ -81,61 +85,67 @@ private:
     static int side; //either SIDE_RIGHT or SIDE_LEFT
     static int uNum;
     static long uniqueIdNum;
-    map<string, string> drawings;
-    map<int, string> sideMap;
     char getTeamAgent(int uNum, int side); //for AgentAnnotation commands
     void getColor(int uNum, int side, float &r, float &g, float &b);
-    string getMyId();
-    string getDrawingId(const string* name);
-    string getUniqueId(long unique);
-    string getUniqueId();
+    const string* getMyId();
+    const string* getDrawingId(const string& name);
+    const string* getUniqueId(long unique);
+    const string* getUniqueId();
     void flipPolygon(float *v, const int numVerts); //for agents on SIDE_RIGHT
-    void updateDrawings(string id, string buf);
+    string idBuf; //reused for the set names of draw commands
 
     int sockfd;
     struct addrinfo p;
     bool socketCreated;
 
-    unsigned char* newBufferSwap(const string* name, int* bufSize);
-    unsigned char* newCircle(const float* center,
-                             float radius, float thickness,
-                             const float* color,
-                             const string* setName,
-                             int *bufSize);
-    unsigned char* newLine(const float* a,
-                           const float* b,
-                           float thickness,
-                           const float* color,
-                           const string* setName,
-                           int* bufSize);
-    unsigned char* newPoint(const float* p,
-                            float size,
-                            const float* color,
-                            const string* setName,
-                            int* bufSize);
-    unsigned char* newSphere(const float* p,
-                             float radius,
-                             const float* color,
-                             const string* setName,
-                             int* bufSize);
-    unsigned char* newPolygon(const float* v,
-                              int numVerts,
-                              const float* color,
-                              const string* setName,
-                              int* bufSize);
-    unsigned char* newAnnotation(const string *txt,
-                                 const float *p,
-                                 const float* color,
-                                 const string* setName,
-                                 int* bufSize);
-    unsigned char* newAgentAnnotation(const string *txt,
-                                      const char teamAgent,
-                                      const float* color,
-                                      int* bufSize);
-    unsigned char* newRemoveAgentAnnotation(const char teamAgent,
-                                            int* bufSize);
-    unsigned char* newSelectAgent(const char teamAgent,
-                                  int* bufSize);
+    // Packets queued since the last flush, back to back in arena
+    unsigned char arena[RV_ARENA_SIZE];
+    int arenaUsed;
+    struct iovec packets[RV_MAX_QUEUED_PACKETS];
+    int numPackets;
+    int packetBudget;
+    int cyclePackets;
+    long droppedPackets;
+    bool fWarnedDropped;
+
+    void initArena();
+    /* Space for a packet of bufSize bytes in the arena, NULL if it's dropped.
+     * Only draw commands count against the budget, buffer swaps and agent
+     * selection are always sent. */
+    unsigned char* newPacket(int bufSize, bool fBudgeted=true);
+    void flush();
+
+    void queueBufferSwap(const string* name);
+    void queueCircle(const float* center,
+                     float radius, float thickness,
+                     const float* color,
+                     const string* setName);
+    void queueLine(const float* a,
+                   const float* b,
+                   float thickness,
+                   const float* color,
+                   const string* setName);
+    void queuePoint(const float* p,
+                    float size,
+                    const float* color,
+                    const string* setName);
+    void queueSphere(const float* p,
+                     float radius,
+                     const float* color,
+                     const string* setName);
+    void queuePolygon(const float* v,
+                      int numVerts,
+                      const float* color,
+                      const string* setName);
+    void queueAnnotation(const string *txt,
+                         const float *p,
+                         const float* color,
+                         const string* setName);
+    void queueAgentAnnotation(const string *txt,
+                              const char teamAgent,
+                              const float* color);
+    void queueRemoveAgentAnnotation(const char teamAgent);
+    void queueSelectAgent(const char teamAgent);
 
 public:
     RVSender();
@@ -160,6 +170,15 @@ public:
         return side != -1 && uNum !=1 -1;
     }
 
+    /* maximum number of draw packets sent per cycle */
+    inline void setPacketBudget(int budget) {
+        packetBudget = budget;
+    }
+    /* draw packets dropped so far because the budget was used up */
+    inline long getDroppedPackets() const {
+        return droppedPackets;
+    }
+
     //this must match the switch in getColor. See rvdraw.cc before changing
     enum Color {
         RED       = 1, ORANGE      =  2, YELLOW    =  3, GREEN     = 4,
@@ -171,16 +190,16 @@ public:
     /*
      *  These draw commands support animation.
      *
-     *  Every time a draw command is called, a map is updated with
-     *  key = string name (the first argument to each of these commands), and
-     *  value = the draw command's buffer (no need to understand that part).
+     *  Every time a draw command is called, the shape is queued with its
+     *  string name (the first argument to each of these commands) as the
+     *  name of its set.
      *
-     *  Call refresh() to write these buffers to the screen. I recommend putting refresh() in
-     *  NaoBehavior::Think().
+     *  Call refresh() to send all queued shapes and show them on the screen. I recommend
+     *  putting refresh() in NaoBehavior::Think(). Only the first setPacketBudget() shapes
+     *  of a cycle are sent, so drawing can be left on during games.
      *
-     *  Call clear() to erase what's in the buffers. That allows old shapes to be removed from the
-     *  screen and prevents clutter. It allows you to know what your agents are thinking right now.
-     *  I recommend putting clear() in NaoBehavior::selectSkill().
+     *  Shapes that were not drawn again since the last refresh() are removed from the
+     *  screen, so you only see what your agents are thinking right now.
      *
      *  It's important to give shapes unique a unique 'string name' argument.
      *  A shape created with some 'string name' argument will overwrite an older shape with the
@@ -191,40 +210,40 @@ public:
      *  uNum (very useful).
      */
 
-    /* draws all elements of drawings map to the screen */
+    /* sends all queued shapes and draws them to the screen */
     void refresh();
 
-    /* erases all elements of drawings map */
+    /* shapes not drawn again are already erased by refresh(), kept for old callers */
     void clear();
 
-    void drawCircle(string name, double x, double y, double radius,
+    void drawCircle(const string& name, double x, double y, double radius,
                     RVSender::Color c=(RVSender::Color)uNum);
-    void drawCircle(string name, double x, double y, double radius, float r, float g, float b);
+    void drawCircle(const string& name, double x, double y, double radius, float r, float g, float b);
 
-    void drawLine(string name, double x1, double y1, double x2, double y2,
+    void drawLine(const string& name, double x1, double y1, double x2, double y2,
                   RVSender::Color c=(RVSender::Color)uNum);
-    void drawLine(string name, double x1, double y1, double x2, double y2, float r, float g, float b);
+    void drawLine(const string& name, double x1, double y1, double x2, double y2, float r, float g, float b);
 
-    void drawText(string name, string text, double x, double y,
+    void drawText(const string& name, string text, double x, double y,
                   RVSender::Color c=(RVSender::Color)uNum);
-    void drawText(string name, string text, double x, double y, float r, float g, float b);
+    void drawText(const string& name, string text, double x, double y, float r, float g, float b);
 
-    void drawPoint(string name, double x, double y, double radius,
+    void drawPoint(const string& name, double x, double y, double radius,
                    RVSender::Color c=(RVSender::Color)uNum);
-    void drawPoint(string name, double x, double y, double radius, float r, float g, float b);
+    void drawPoint(const string& name, double x, double y, double radius, float r, float g, float b);
 
-    void drawSphere(string name, double x, double y, double z, double radius,
+    void drawSphere(const string& name, double x, double y, double z, double radius,
                     RVSender::Color c=(RVSender::Color)uNum);
-    void drawSphere(string name, double x, double y, double z, double radius,
+    void drawSphere(const string& name, double x, double y, double z, double radius,
                     float r, float g, float b);
 
     /* format your *v array as {x1, y1, z1, x2, y2, z2, ...} */
     /* the 'a' arguments are for alpha channel (transparency) */
-    void drawPolygon(string name, float *v, int numVerts);
-    void drawPolygon(string name, float *v, int numVerts, float a);
-    void drawPolygon(string name, float *v, int numVerts, RVSender::Color c=(RVSender::Color)uNum,
+    void drawPolygon(const string& name, float *v, int numVerts);
+    void drawPolygon(const string& name, float *v, int numVerts, float a);
+    void drawPolygon(const string& name, float *v, int numVerts, RVSender::Color c=(RVSender::Color)uNum,
                      float a=1.0f);
-    void drawPolygon(string name, float *v, int numVerts, float r, float g, float b, float a=1.0f);
+    void drawPolygon(const string& name, float *v, int numVerts, float r, float g, float b, float a=1.0f);
 
     /*
      *  These draw commands are for static shapes that remain on the screen indefinitely,
@@ -263,8 +282,8 @@ public:
     void drawPolygon(float *v, int numVerts, float r, float g, float b, float a=1.0f);
 
     /*
-     *  These agentText commands work differently. No animation involved, you don't need
-     *  the refresh() and clear() commands for these to work. No unique 'string name' either.
+     *  These agentText commands work differently. No animation involved, they stay on the
+     *  screen after the refresh() that sends them. No unique 'string name' either.
      */
 
     void drawText(string text, double x, double y,
@@ -289,7 +308,8 @@ public:
     void selectAgent(int u=uNum, int s=side);
 
 
-    /* old draw commands, don't support the animation */
+    /* old draw commands, don't support the animation. These are queued too and
+     * only sent by the next refresh(). */
     void swapBuffers(const string* setName);
     void drawLine(float x1, float y1, float z1,
                   float x2, float y2, float z2,
@@ -144,6 +144,14 @@ string NaoBehavior::composeAction() {
 
     }
 
+    ss << composeSayMessage();
+
+    return ss.str();
+}
+
+string NaoBehavior::composeSayMessage() {
+
+    stringstream ss("");
 
     // Create say message
     double time = worldModel->getTime();
@@ -151,8 +159,8 @@ string NaoBehavior::composeAction() {
     VecPosition ball = worldModel->getLastBallSeenPosition()[0];
     double ballX = ball.getX();
     double ballY = ball.getY();
-    double myX = worldModel->l2g(VecPosition(0,0,0)).getX();
-    double myY = worldModel->l2g(VecPosition(0,0,0)).getY();
+    double myX = worldModel->getMyTorsoGlobal().getX();
+    double myY = worldModel->getMyTorsoGlobal().getY();
     bool seeingBall = worldModel->getWorldObject(WO_BALL)->currentlySeen;
     double timeBallLastSeen = worldModel->getLastBallSeenTime()[0];
     bool canTrust = worldModel->canTrustVision();
@@ -178,3 +186,85 @@ string NaoBehavior::composeAction() {
 
     return ss.str();
 }
+
+// Names of the simulator effectors, indexed by Effectors
+static const char* SimEffectorNames[EFF_NUM] = {
+    "he1", "he2",
+    "lae1", "lae2", "lae3", "lae4",
+    "rae1", "rae2", "rae3", "rae4",
+    "lle1", "lle2", "lle3", "lle4", "lle5", "lle6", "lle7",
+    "rle1", "rle2", "rle3", "rle4", "rle5", "rle6", "rle7"
+};
+
+/*
+ * Motion thread counterpart of BodyModel::refresh() for the effectors,
+ * must be called right after parsing the hinge joints into raw_joint_angles_
+ */
+void NaoBehavior::senseMotionEffectors() {
+    for (int j = 0; j < NUM_JOINTS; j++) {
+        motionEffectors[UTWalkJointToSimEffectors(Joint(j))].update(RAD_T_DEG*raw_joint_angles_->values_[j]);
+    }
+}
+
+/*
+ * Walk engine targets of all joints but the head, as the motion thread last
+ * commanded them
+ */
+void NaoBehavior::getMotionWalkTargets(double targetAngle[]) {
+    for (int j = 0; j < NUM_JOINTS; j++) {
+        Effectors eff = UTWalkJointToSimEffectors(Joint(j));
+        targetAngle[eff] = motionEffectors[eff].targetAngle;
+    }
+}
+
+/*
+ * Motion thread counterpart of composeAction(), computing the torques from
+ * the motion thread's own copy of the effectors.  Walk targets are read from
+ * raw_joint_commands_, all other targets and scales come from the behavior
+ * thread's last decision.
+ */
+string NaoBehavior::composeMotionAction(const BehaviorOutput& decision) {
+
+    stringstream ss("");
+
+    float m = -0.7 / 990;
+    float b = 1.0 - m * 10;
+    float command_time_factor = m * raw_joint_commands_->angle_time_ + b;
+
+    for (int j = 0; j < NUM_JOINTS; j++) {
+        Effectors eff = UTWalkJointToSimEffectors(Joint(j));
+        Effector &effector = motionEffectors[eff];
+
+        effector.scale = decision.scale[eff];
+
+        // First two joints are head joints which we want to control ourself
+        bool fWalkJoint = decision.useOmniWalk && j >= 2;
+        if (fWalkJoint) {
+            effector.setTargetAngle(RAD_T_DEG*raw_joint_commands_->angles_[j]);
+        } else {
+            effector.targetAngle = decision.targetAngle[eff];
+        }
+    }
+
+    for (int eff = 0; eff < EFF_NUM; eff++) {
+        if ((eff == EFF_LL7 || eff == EFF_RL7) && !bodyModel->hasToe()) {
+            continue;
+        }
+
+        Effector &effector = motionEffectors[eff];
+        effector.updateErrors();
+
+        double torque = effector.k1 * effector.currentError;
+        torque += effector.k2 * effector.cumulativeError;
+        torque += effector.k3 * (effector.currentError - effector.previousError);
+        torque *= effector.scale;
+
+        if (decision.useOmniWalk && eff != EFF_H1 && eff != EFF_H2) {
+            torque *= command_time_factor;
+        }
+
+        ss << "(" << SimEffectorNames[eff] << " " << torque << ")";
+    }
+
+    return ss.str();
+}
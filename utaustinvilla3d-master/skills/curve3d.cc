@@ -2,6 +2,7 @@
 #include <cmath>
 #include <cassert>
 #include <stdexcept>
+#include <algorithm>
 using namespace std;
 
 /**
@@ -31,6 +32,60 @@ int nChooseK(const int n, const int k) {
     }
 }
 
+/**
+ * Throws if t is outside the [0, 1] domain of a curve.
+ */
+static void checkDomain(float t) {
+    if (t < 0.0) {
+        throw std::domain_error("t must be >= 0.0");
+    } else if (t > 1.0) {
+        throw std::domain_error("t must be <= 1.0");
+    }
+}
+
+/**
+ * Solves the Vandermonde system sum_j coeff[j] * s[i]^j = value[i] for the
+ * coefficients of the polynomial through the points (s[i], value[i]).
+ */
+static void fitPolynomial(const vector<double> &s, vector<VecPosition> value, vector<VecPosition> &coeff) {
+    size_t n = s.size();
+    vector<vector<double> > a(n, vector<double>(n));
+    for (size_t i = 0; i < n; ++i) {
+        double x = 1;
+        for (size_t j = 0; j < n; ++j) {
+            a[i][j] = x;
+            x *= s[i];
+        }
+    }
+
+    // Gaussian elimination with partial pivoting, then back substitution
+    for (size_t col = 0; col < n; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < n; ++row) {
+            if (fabs(a[row][col]) > fabs(a[pivot][col])) {
+                pivot = row;
+            }
+        }
+        swap(a[col], a[pivot]);
+        swap(value[col], value[pivot]);
+        for (size_t row = col + 1; row < n; ++row) {
+            double f = a[row][col] / a[col][col];
+            for (size_t j = col; j < n; ++j) {
+                a[row][j] -= f * a[col][j];
+            }
+            value[row] -= value[col] * f;
+        }
+    }
+    coeff.resize(n);
+    for (size_t i = n; i-- > 0; ) {
+        VecPosition sum = value[i];
+        for (size_t j = i + 1; j < n; ++j) {
+            sum -= coeff[j] * a[i][j];
+        }
+        coeff[i] = sum / a[i][i];
+    }
+}
+
 /**
  * Constructor.
  *
@@ -46,16 +101,30 @@ Curve3D::Curve3D(const std::vector<VecPosition> &controlPoints) :
 Curve3D::~Curve3D() {
 }
 
+void Curve3D::getPoints(const std::vector<float> &ts, std::vector<VecPosition> &points) const {
+    points.resize(ts.size());
+    for (size_t i = 0; i < ts.size(); ++i) {
+        points[i] = getPoint(ts[i]);
+    }
+}
+
 /**
  * Constructor.
  *
  * \param controlPoints The control points defining the curve.
  */
 Bezier3D::Bezier3D(const std::vector<VecPosition> &controlPoints) :
-    Curve3D(controlPoints), _coeff(controlPoints.size()) {
+    Curve3D(controlPoints), _power(controlPoints.size()) {
+    // Expanding the Bernstein polynomials, the coefficient of t^j is
+    // C(n, j) * sum_{i<=j} (-1)^(j-i) * C(j, i) * P_i
     int n = controlPoints.size() - 1;
-    for (int i = 0; i <= n; ++i) {
-        _coeff[i] = nChooseK(n, i);
+    for (int j = 0; j <= n; ++j) {
+        VecPosition sum;
+        for (int i = 0; i <= j; ++i) {
+            double sign = ((j - i) % 2 == 0) ? 1 : -1;
+            sum += controlPoints[i] * (sign * nChooseK(j, i));
+        }
+        _power[j] = sum * nChooseK(n, j);
     }
 }
 
@@ -76,21 +145,23 @@ Bezier3D::~Bezier3D() {
  *           Value of t < 0.0 or > 1.0 are erroneous.
  */
 VecPosition Bezier3D::getPoint(float t) const {
-    if (t < 0.0) {
-        throw std::domain_error("t must be >= 0.0");
-    } else if (t > 1.0) {
-        throw std::domain_error("t must be <= 1.0");
+    checkDomain(t);
+    return evaluate(t);
+}
+
+void Bezier3D::getPoints(const std::vector<float> &ts, std::vector<VecPosition> &points) const {
+    points.resize(ts.size());
+    for (size_t i = 0; i < ts.size(); ++i) {
+        checkDomain(ts[i]);
+        points[i] = evaluate(ts[i]);
     }
+}
 
+VecPosition Bezier3D::evaluate(float t) const {
     VecPosition sum;
-    int n = _controlPoints.size() - 1;
-
-    for (int i = 0; i <= n; ++i) {
-        const VecPosition &p = _controlPoints[i];
-        float mult = _coeff[i] * (float) (pow(1 - t, n - i) * pow(t, i));
-        sum = sum + p * mult;
+    for (size_t j = _power.size(); j-- > 0; ) {
+        sum = sum * t + _power[j];
     }
-
     return sum;
 }
 
@@ -112,6 +183,27 @@ UniformBSpline3D::UniformBSpline3D(const std::vector<VecPosition> &controlPoints
     assert(0.0f == _T[0]);
     assert(1.0f == _T[_m-1]);
     //LOG(_T);
+
+    // The curve is a polynomial of degree _n on each knot span of the domain
+    // [_T[_n], _T[_m-_n-1]].  Fit each one from _n + 1 samples inside the
+    // span, in the span's local parameter s in [0, 1].
+    size_t numSpans = _m - 2 * _n - 1;
+    _spans.reserve(numSpans * (_n + 1));
+    vector<double> s(_n + 1);
+    vector<VecPosition> value(_n + 1);
+    vector<VecPosition> coeff;
+    for (size_t k = _n; k < _n + numSpans; ++k) {
+        for (size_t j = 0; j <= _n; ++j) {
+            s[j] = (j + 0.5) / (_n + 1);
+            float x = _T[k] + s[j] * (_T[k+1] - _T[k]);
+            value[j] = VecPosition(0, 0, 0);
+            for (size_t i = 0; i < _controlPoints.size(); ++i) {
+                value[j] += _controlPoints[i] * b(i, _n, x);
+            }
+        }
+        fitPolynomial(s, value, coeff);
+        _spans.insert(_spans.end(), coeff.begin(), coeff.end());
+    }
 }
 
 /**
@@ -130,27 +222,46 @@ HermiteSpline3D::HermiteSpline3D(const std::vector<VecPosition> &controlPoints,
         tangents[i] = (controlPoints[i+1] - controlPoints[i-1]) * scale;
     }
     tangents[len - 1] = VecPosition();//(controlPoints[len - 1] - controlPoints[len - 2]) * scale;
+
+    // Collect the cubic hermite basis functions
+    //   h1 = 2u^3 - 3u^2 + 1, h2 = -2u^3 + 3u^2, h3 = u^3 - 2u^2 + u, h4 = u^3 - u^2
+    // into coefficients of u for each segment
+    for(size_t i = 0; i + 1 < len; ++i) {
+        const VecPosition &p1 = _controlPoints[i];
+        const VecPosition &p2 = _controlPoints[i + 1];
+        const VecPosition &t1 = tangents[i];
+        const VecPosition &t2 = tangents[i + 1];
+        _a.push_back(p1);
+        _b.push_back(t1);
+        _c.push_back((p2 - p1) * 3 - t1 * 2 - t2);
+        _d.push_back((p1 - p2) * 2 + t1 + t2);
+    }
 }
 
 VecPosition HermiteSpline3D::getPoint(float u) const {
     assert( u >= 0 && u <= 1 );
+    return evaluate(u);
+}
 
-    // get associated index for curve
-    int idx = floor( (_controlPoints.size() - 1) * u);
-    // get u between these corresponding points only
-    u = u * (_controlPoints.size()-1) - idx;
+void HermiteSpline3D::getPoints(const std::vector<float> &ts, std::vector<VecPosition> &points) const {
+    points.resize(ts.size());
+    for(size_t i = 0; i < ts.size(); ++i) {
+        assert( ts[i] >= 0 && ts[i] <= 1 );
+        points[i] = evaluate(ts[i]);
+    }
+}
 
-    // compute cubic hermite parameters
-    float h1 = 2 * pow(u, 3) - 3 * pow(u, 2) + 1;
-    float h2 = -2 * pow(u, 3) + 3 * pow(u, 2);
-    float h3 = pow(u, 3) - 2 * pow(u, 2) + u;
-    float h4 = pow(u, 3) -  pow(u, 2);
+VecPosition HermiteSpline3D::evaluate(float u) const {
+    if(_a.empty()) {
+        return _controlPoints[0];
+    }
 
-    VecPosition p1, p2;
-    p1 = _controlPoints[ idx ];
-    p2 = _controlPoints[ idx + 1 ];
+    // get associated index for curve, u = 1 being the end of the last segment
+    int idx = std::min((int) floor(_a.size() * u), (int) _a.size() - 1);
+    // get u between these corresponding points only
+    u = u * _a.size() - idx;
 
-    return p1 * h1 + p2 * h2 + tangents[idx] * h3 + tangents[idx + 1] * h4;
+    return _a[idx] + (_b[idx] + (_c[idx] + _d[idx] * u) * u) * u;
 }
 
 /**
@@ -169,25 +280,32 @@ HermiteSpline3D::~HermiteSpline3D() {}
  *           Value of t < 0.0 or > 1.0 are erroneous.
  */
 VecPosition UniformBSpline3D::getPoint(float t) const {
-    if (t < 0.0) {
-        throw std::domain_error("t must be >= 0.0");
-    } else if (t > 1.0) {
-        throw std::domain_error("t must be <= 1.0");
+    checkDomain(t);
+    return evaluate(t);
+}
+
+void UniformBSpline3D::getPoints(const std::vector<float> &ts, std::vector<VecPosition> &points) const {
+    points.resize(ts.size());
+    for (size_t i = 0; i < ts.size(); ++i) {
+        checkDomain(ts[i]);
+        points[i] = evaluate(ts[i]);
     }
+}
 
+VecPosition UniformBSpline3D::evaluate(float t) const {
     assert(_controlPoints.size() == _m -_n - 1);
 
-    VecPosition sum = VecPosition(0, 0, 0);
-
-    // t really needs to be in the range [_T[_n], _T[_m-_n-1]]
-    float trange = _T[_m-_n-1] - _T[_n];
-    float newT = t*trange + _T[_n];
+    // t really needs to be in the range [_T[_n], _T[_m-_n-1]], which the
+    // uniform knots split into equal spans
+    size_t numSpans = _spans.size() / (_n + 1);
+    size_t span = std::min((size_t) (t * numSpans), numSpans - 1);
+    double s = t * numSpans - span;
 
-    for (size_t i = 0; i < _controlPoints.size(); ++i) {
-        sum += _controlPoints[i] * b(i, _n, newT);
-//    LOG(sum);
+    const VecPosition *coeff = &_spans[span * (_n + 1)];
+    VecPosition sum = coeff[_n];
+    for (size_t j = _n; j-- > 0; ) {
+        sum = sum * s + coeff[j];
     }
-
     return sum;
 }
 
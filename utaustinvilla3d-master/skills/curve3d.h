@@ -11,6 +11,12 @@ public:
 
     virtual VecPosition getPoint(float t) const = 0;
 
+    /**
+     * Gets the points at each of ts, in order, into points.  Evaluating many
+     * values at once saves a virtual call per point.
+     */
+    virtual void getPoints(const std::vector<float> &ts, std::vector<VecPosition> &points) const;
+
     const std::vector<VecPosition> &getControlPoints() const {
         return _controlPoints;
     }
@@ -25,9 +31,14 @@ public:
     virtual ~Bezier3D();
 
     virtual VecPosition getPoint(float t) const;
+    virtual void getPoints(const std::vector<float> &ts, std::vector<VecPosition> &points) const;
 
 private:
-    std::vector<long> _coeff;
+    // Coefficients of the curve in the power basis, lowest order first, so
+    // that a point is evaluated with Horner's rule
+    std::vector<VecPosition> _power;
+
+    VecPosition evaluate(float t) const;
 };
 
 class HermiteSpline3D : public Curve3D {
@@ -35,9 +46,14 @@ public:
     HermiteSpline3D(const std::vector<VecPosition> &controlPoints, float tangentScale);
     virtual ~HermiteSpline3D();
     virtual VecPosition getPoint(float t) const;
+    virtual void getPoints(const std::vector<float> &ts, std::vector<VecPosition> &points) const;
 private:
     float scale;
     std::vector<VecPosition> tangents;
+    // Cubic a + b*u + c*u^2 + d*u^3 of each segment between control points
+    std::vector<VecPosition> _a, _b, _c, _d;
+
+    VecPosition evaluate(float u) const;
 };
 
 class UniformBSpline3D : public Curve3D {
@@ -46,13 +62,18 @@ public:
     virtual ~UniformBSpline3D();
 
     virtual VecPosition getPoint(float t) const;
+    virtual void getPoints(const std::vector<float> &ts, std::vector<VecPosition> &points) const;
 
 protected:
     const size_t _n;              ///< degree
     const size_t _m;              ///< m knots
     std::vector<float> _T;      ///< knot vector
+    /// Power basis coefficients of the curve on each knot span in the
+    /// domain, in the span's local parameter, (_n + 1) per span
+    std::vector<VecPosition> _spans;
 
     float b(int, int, float) const;
+    VecPosition evaluate(float t) const;
 
 };
 
@@ -23,6 +23,14 @@ void IncTar::execute(BodyModel *bodyModel, const WorldModel *worldModel) {
     }
 }
 
+bool IncTar::compile(vector<EffectorOp> &ops) const {
+    for( size_t i = 0; i < effectorIDs.size(); ++i ) {
+        EffectorOp op = { EffectorOp::INC_TARGET, effectorIDs[i], increments[i] };
+        ops.push_back( op );
+    }
+    return true;
+}
+
 boost::shared_ptr<Macro>
 IncTar::getReflection(BodyModel *bodyModel) {
 
@@ -66,6 +74,14 @@ void SetTar::execute(BodyModel *bodyModel, const WorldModel *worldModel) {
     }
 }
 
+bool SetTar::compile(vector<EffectorOp> &ops) const {
+    for( size_t i = 0; i < effectorIDs.size(); ++i ) {
+        EffectorOp op = { EffectorOp::SET_TARGET, effectorIDs[i], targetAngles[i] };
+        ops.push_back( op );
+    }
+    return true;
+}
+
 boost::shared_ptr<Macro>
 SetTar::getReflection(BodyModel *bodyModel) {
 
@@ -259,10 +275,15 @@ bool Curve::canExecute(const BodyModel *bodyModel, const WorldModel *worldModel)
       double tot = 20;
       double pass = 0;
 
-      for( double u = 0; u < 1; u += (1.0/tot) ) {
-         VecPosition pos = curve->getPoint(u);
-         VecPosition rpy = rpy_curve->getPoint(u);
-         if(bodyModel->canReachOutLeg(legIDX, pos + curveOffsetWrtTorso, rpy)) {
+      vector<float> us;
+      for( int i = 0; i < tot; ++i ) {
+         us.push_back(i / tot);
+      }
+      vector<VecPosition> pos, rpy;
+      curve->getPoints(us, pos);
+      rpy_curve->getPoints(us, rpy);
+      for( size_t i = 0; i < us.size(); ++i ) {
+         if(bodyModel->canReachOutLeg(legIDX, pos[i] + curveOffsetWrtTorso, rpy[i])) {
            ++pass;
          }
       }
@@ -317,24 +338,35 @@ Reset::Reset(const std::vector<int>& components_) :
     components( components_ ) {
 }
 
+static void resetBodyPart(BodyModel *bodyModel, int part) {
+    if( part == HEAD ) {
+        bodyModel->setInitialHead();
+    } else if( part == ARM_LEFT ) {
+        bodyModel->setInitialArm(ARM_LEFT);
+    } else if( part == ARM_RIGHT ) {
+        bodyModel->setInitialArm(ARM_RIGHT);
+    } else if( part == LEG_LEFT ) {
+        bodyModel->setInitialLeg(LEG_LEFT);
+    } else if( part == LEG_RIGHT ) {
+        bodyModel->setInitialLeg(LEG_RIGHT);
+    }
+}
+
 void Reset::execute(BodyModel *bodyModel, const WorldModel *worldModel) {
     vector<int>::iterator begin( components.begin() ), end( components.end() );
     for( ; begin != end; ++begin ) {
-        int currentJoint = *begin;
-        if( currentJoint == HEAD ) {
-            bodyModel->setInitialHead();
-        } else if( currentJoint == ARM_LEFT ) {
-            bodyModel->setInitialArm(ARM_LEFT);
-        } else if( currentJoint == ARM_RIGHT ) {
-            bodyModel->setInitialArm(ARM_RIGHT);
-        } else if( currentJoint == LEG_LEFT ) {
-            bodyModel->setInitialLeg(LEG_LEFT);
-        } else if( currentJoint == LEG_RIGHT ) {
-            bodyModel->setInitialLeg(LEG_RIGHT);
-        }
+        resetBodyPart( bodyModel, *begin );
     }
 }
 
+bool Reset::compile(vector<EffectorOp> &ops) const {
+    for( size_t i = 0; i < components.size(); ++i ) {
+        EffectorOp op = { EffectorOp::RESET, components[i], 0 };
+        ops.push_back( op );
+    }
+    return true;
+}
+
 boost::shared_ptr<Macro>
 Reset::getReflection(BodyModel *bodyModel) {
 
@@ -382,6 +414,14 @@ void SetScale::execute(BodyModel *bodyModel, const WorldModel *worldModel) {
     }
 }
 
+bool SetScale::compile(vector<EffectorOp> &ops) const {
+    for( size_t i = 0; i < effectorIDs.size(); ++i ) {
+        EffectorOp op = { EffectorOp::SET_SCALE, effectorIDs[i], targetScales[i] };
+        ops.push_back( op );
+    }
+    return true;
+}
+
 boost::shared_ptr<Macro>
 SetScale::getReflection(BodyModel *bodyModel) {
 
@@ -504,21 +544,33 @@ bool KeyFrame::done(BodyModel *bodyModel, const WorldModel *worldModel, const do
 void KeyFrame::updateCurveMacros(BodyModel *bodyModel, const WorldModel *worldModel, const double &t) {
     assert(t>=0.0);
     assert(t<=1.0);
-    for(size_t i = 0; i < macros.size(); ++i) {
-        // Try to cast the macro to a Bezier macro
-        Curve *curve = dynamic_cast<Curve *>(macros[i].get());
-        // If cast was successful, update the Bezier macro
-        if(curve) {
-            curve->setTimeParam(t);
-            curve->execute(bodyModel, worldModel);
-        }
+    for(size_t i = 0; i < curves.size(); ++i) {
+        curves[i]->setTimeParam(t);
+        curves[i]->execute(bodyModel, worldModel);
     }
 }
 
 void KeyFrame::execute(BodyModel *bodyModel, const WorldModel *worldModel) {
     updateCurveMacros(bodyModel, worldModel, 0.0);
-    for(unsigned m = 0; m < macros.size(); m++) {
-        macros[m]->execute(bodyModel, worldModel);
+    for(size_t i = 0; i < ops.size(); ++i) {
+        const EffectorOp &op = ops[i];
+        switch(op.type) {
+        case EffectorOp::INC_TARGET:
+            bodyModel->increaseTargetAngle(op.effector, op.value);
+            break;
+        case EffectorOp::SET_TARGET:
+            bodyModel->setTargetAngle(op.effector, op.value);
+            break;
+        case EffectorOp::SET_SCALE:
+            bodyModel->setScale(op.effector, op.value);
+            break;
+        case EffectorOp::RESET:
+            resetBodyPart(bodyModel, op.effector);
+            break;
+        case EffectorOp::MACRO:
+            macros[op.effector]->execute(bodyModel, worldModel);
+            break;
+        }
     }
 }
 
@@ -549,8 +601,23 @@ void KeyFrame::setMaxWaitTime( double value ) {
     maxWaitTime = value;
 }
 
+/*
+ * Effector macros are compiled to operations on the effectors as they are
+ * appended, in order, so that executing the key frame is a single loop
+ * over them.  SetFoot, Curve and Stabilize, which need the world and
+ * body models, are kept as calls to the macro.
+ */
 void KeyFrame::appendMacro(boost::shared_ptr<Macro> macro) {
     macros.push_back( macro );
+    if( !macro->compile( ops ) ) {
+        EffectorOp op = { EffectorOp::MACRO, (int)macros.size() - 1, 0 };
+        ops.push_back( op );
+    }
+
+    Curve *curve = dynamic_cast<Curve *>( macro.get() );
+    if( curve ) {
+        curves.push_back( curve );
+    }
 }
 
 boost::shared_ptr<KeyFrame> KeyFrame::getReflection(BodyModel *bodyModel) {
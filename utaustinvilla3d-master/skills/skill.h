@@ -12,6 +12,21 @@ std::ostream& operator<<(std::ostream &out, const Pos6DOF &pos);
 /////////////////////////////////////////////////////
 // Macros
 /////////////////////////////////////////////////////
+
+// One operation of a key frame compiled for execution, see KeyFrame::appendMacro()
+struct EffectorOp {
+    enum Type {
+        INC_TARGET,   // increase the target angle of effector by value
+        SET_TARGET,   // set the target angle of effector to value
+        SET_SCALE,    // set the scale of effector to value
+        RESET,        // set body part effector (HEAD, ARM_LEFT, ...) to its initial angles
+        MACRO         // execute macro number effector of the key frame
+    };
+    Type type;
+    int effector;
+    double value;
+};
+
 class Macro {
 private:
 protected:
@@ -20,6 +35,11 @@ public:
     virtual ~Macro() {}
 
     virtual void execute(BodyModel *bodyModel, const WorldModel *worldModel) = 0;
+    // Appends operations doing the same as execute() to ops and returns
+    // true, or returns false if the macro has to be executed itself
+    virtual bool compile(vector<EffectorOp> &ops) const {
+        return false;
+    }
     virtual boost::shared_ptr<Macro> getReflection(BodyModel *bodyModel) = 0;
     virtual void display() = 0;
 
@@ -46,6 +66,7 @@ public:
     ~IncTar() {}
 
     virtual void execute(BodyModel *bodyModel, const WorldModel *worldModel);
+    virtual bool compile(vector<EffectorOp> &ops) const;
 
     virtual boost::shared_ptr<Macro> getReflection(BodyModel *bodyModel);
 
@@ -69,6 +90,7 @@ public:
     ~SetTar() {}
 
     virtual void execute(BodyModel *bodyModel, const WorldModel *worldModel);
+    virtual bool compile(vector<EffectorOp> &ops) const;
 
     virtual boost::shared_ptr<Macro> getReflection(BodyModel *bodyModel);
 
@@ -151,6 +173,7 @@ public:
     ~Reset() {}
 
     virtual void execute(BodyModel *bodyModel, const WorldModel *worldModel);
+    virtual bool compile(vector<EffectorOp> &ops) const;
 
     virtual boost::shared_ptr<Macro> getReflection(BodyModel *bodyModel);
 
@@ -174,6 +197,7 @@ public:
     ~SetScale() {}
 
     virtual void execute(BodyModel *bodyModel, const WorldModel *worldModel);
+    virtual bool compile(vector<EffectorOp> &ops) const;
 
     virtual boost::shared_ptr<Macro> getReflection(BodyModel *bodyModel);
 
@@ -215,6 +239,10 @@ class KeyFrame {
 private:
 protected:
     vector< boost::shared_ptr<Macro> > macros;
+    // The macros compiled to a flat list of operations, executed in one loop
+    vector<EffectorOp> ops;
+    // The Curve macros, updated every cycle while the key frame waits
+    vector<Curve*> curves;
 
     bool toWaitTime; // Default: false.
     double waitTime; // Default: 0.
@@ -757,6 +757,7 @@ struct SkillParser : public grammar<SkillParser>
                 SkillType source = EnumParser<SkillType>::getEnumFromString( refSkillSource );
                 SkillType target = EnumParser<SkillType>::getEnumFromString( refSkillTarget );
                 parser.skills[target] = parser.skills[source]->getReflection( parser.bodyModel );
+                setSkillMirror( source, target );
             }
 
             std::string& refSkillSource;
@@ -0,0 +1,140 @@
+/*
+ * Checks Affine3f against HCTMatrix on six-joint leg chains with random
+ * anchors, axes and angles, composed the way BodyModel::refreshComponent
+ * composes them, and with --bench times a chain in each.
+ */
+
+#include "testutil.h"
+
+#include "../math/affine3f.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+#define NUM_CHAIN_JOINTS 6
+
+// Float cells of transforms whose translations are around 0.1 m
+#define MAX_CELL_ERROR 1e-5
+
+struct ChainJoint {
+    VecPosition anchor;
+    VecPosition axis;
+    HCTMatrix translateMatrix;
+    HCTMatrix backTranslateMatrix;
+    Affine3f translateMatrixF;
+    Affine3f backTranslateMatrixF;
+};
+
+struct Chain {
+    ChainJoint joints[NUM_CHAIN_JOINTS];
+    double angles[NUM_CHAIN_JOINTS];
+};
+
+static VecPosition randomAxis() {
+    VecPosition axis(randomIn(-1, 1), randomIn(-1, 1), randomIn(-1, 1));
+    if (axis.getMagnitude() < 0.1) {
+        return VecPosition(0, 1, 0);
+    }
+    return axis.normalize();
+}
+
+static vector<Chain> randomChains(int numChains) {
+    vector<Chain> chains(numChains);
+    for (int c = 0; c < numChains; c++) {
+        for (int i = 0; i < NUM_CHAIN_JOINTS; i++) {
+            ChainJoint &joint = chains[c].joints[i];
+            joint.anchor = VecPosition(randomIn(-0.06, 0.06), randomIn(-0.06, 0.06), randomIn(-0.12, 0));
+            joint.axis = randomAxis();
+            joint.translateMatrix.createTranslate(joint.anchor);
+            joint.backTranslateMatrix.createTranslate(-joint.anchor);
+            joint.translateMatrixF = Affine3f(joint.translateMatrix);
+            joint.backTranslateMatrixF = Affine3f(joint.backTranslateMatrix);
+            chains[c].angles[i] = randomIn(-120, 120);
+        }
+    }
+    return chains;
+}
+
+// As refreshComponent did before Affine3f
+static HCTMatrix chainHCT(const Chain &chain) {
+    HCTMatrix fromRoot;
+    for (int i = 0; i < NUM_CHAIN_JOINTS; i++) {
+        const ChainJoint &joint = chain.joints[i];
+        HCTMatrix fromParent = joint.translateMatrix;
+        fromParent.multiply(HCTMatrix(HCT_GENERALIZED_ROTATE, joint.axis, chain.angles[i]));
+        fromParent.multiply(joint.backTranslateMatrix);
+        fromRoot.multiply(fromParent);
+    }
+    return fromRoot;
+}
+
+// As refreshComponent does now
+static HCTMatrix chainAffine(const Chain &chain) {
+    Affine3f fromRoot;
+    for (int i = 0; i < NUM_CHAIN_JOINTS; i++) {
+        const ChainJoint &joint = chain.joints[i];
+        Affine3f fromParent = joint.translateMatrixF;
+        fromParent.multiply(Affine3f::rotation(Vec3f(joint.axis), chain.angles[i]));
+        fromParent.multiply(joint.backTranslateMatrixF);
+        fromRoot.multiply(fromParent);
+        // BodyModel keeps every component's transform as an HCTMatrix
+        fromRoot = Affine3f(fromRoot.toHCTMatrix());
+    }
+    return fromRoot.toHCTMatrix();
+}
+
+static double timeChains(HCTMatrix (*compose)(const Chain&), const vector<Chain> &chains, int repeats) {
+    double sum = 0;
+    double start = getWallTime();
+    for (int r = 0; r < repeats; r++) {
+        for (size_t i = 0; i < chains.size(); i++) {
+            sum += compose(chains[i]).getCell(2, 3);
+        }
+    }
+    double elapsed = getWallTime() - start;
+    consume(sum);
+    return elapsed / ((double)repeats * chains.size()) * 1e9;
+}
+
+int main(int argc, char **argv) {
+    int failures = 0;
+    srand(45);
+
+    vector<Chain> chains = randomChains(100000);
+    double maxError = 0;
+    for (size_t c = 0; c < chains.size(); c++) {
+        HCTMatrix expected = chainHCT(chains[c]);
+        HCTMatrix actual = chainAffine(chains[c]);
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                double error = fabs(actual.getCell(i, j) - expected.getCell(i, j));
+                // NaN fails the check too
+                if (!(error <= maxError)) {
+                    maxError = error;
+                }
+            }
+        }
+    }
+    cout << "Largest cell difference from HCTMatrix: " << maxError << " over "
+         << chains.size() << " chains" << endl;
+    CHECK(maxError <= MAX_CELL_ERROR);
+
+    // The last row stays (0 0 0 1) and translation alone is exact
+    Affine3f translate(HCTMatrix(HCT_TRANSLATE, VecPosition(1, 2, 3)));
+    Vec3f moved = translate.transform(Vec3f(0.5, -0.5, 0.25));
+    CHECK(moved.getX() == 1.5f && moved.getY() == 1.5f && moved.getZ() == 3.25f);
+    CHECK(chainAffine(chains[0]).getCell(3, 3) == 1);
+    CHECK(chainAffine(chains[0]).getCell(3, 0) == 0);
+
+    if (isBenchRun(argc, argv)) {
+        vector<Chain> benchChains = randomChains(1000);
+        int repeats = 1000;
+        double hctNs = timeChains(chainHCT, benchChains, repeats);
+        double affineNs = timeChains(chainAffine, benchChains, repeats);
+        cout << "Six-joint chain: HCTMatrix " << hctNs << " ns, Affine3f " << affineNs << " ns" << endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
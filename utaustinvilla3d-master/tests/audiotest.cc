@@ -0,0 +1,339 @@
+/*
+ * Checks the say/hear codec: SayMessageWriter and HearMessageReader give
+ * back every field written, makeSayMessage writes the same messages as the
+ * bit vector codec it replaced, and processHearMessage reads back what
+ * makeSayMessage said.  With --bench it times encoding and decoding
+ * against the bit vector codec.
+ */
+
+#include "testutil.h"
+
+#include "../audio/audio.h"
+#include "../headers/Field.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+ * The bit vector codec makeSayMessage and processHearMessage used before,
+ * kept as the reference for the wire format: one int per bit, and a
+ * search of commAlphabet per symbol.
+ */
+namespace reference {
+
+const double minBallX = -HALF_FIELD_X - 2.0;
+const double maxBallX = HALF_FIELD_X + 2.0;
+const double minBallY = -HALF_FIELD_Y - 2.0;
+const double maxBallY = HALF_FIELD_Y + 2.0;
+const double minAgentX = -HALF_FIELD_X - 5.0;
+const double maxAgentX = HALF_FIELD_X + 5.0;
+const double minAgentY = -HALF_FIELD_Y - 5.0;
+const double maxAgentY = HALF_FIELD_Y + 5.0;
+
+vector<int> intToBits(int n, int numBits) {
+    vector<int> bits(numBits);
+    for (int i = numBits - 1; i >= 0; i--) {
+        bits[i] = n % 2;
+        n /= 2;
+    }
+    return bits;
+}
+
+int bitsToInt(const vector<int> &bits, int start, int end) {
+    int n = 0;
+    for (int i = start; i <= end; i++) {
+        n = n * 2 + bits[i];
+    }
+    return n;
+}
+
+int quantize(double x, double min, double max) {
+    double clipped = (x < min) ? min : ((x > max) ? max : x);
+    return (((clipped - min) * 1023) / (max - min)) + 0.5;
+}
+
+void appendBits(vector<int> &bits, const vector<int> &field) {
+    bits.insert(bits.end(), field.begin(), field.end());
+}
+
+string encode(double time, double ballLastSeenTime, double ballX, double ballY, double myX, double myY,
+              bool fFallen) {
+    vector<int> bits;
+    appendBits(bits, intToBits((int)((time * 50) + 0.1) % (1 << 16), 16));
+    appendBits(bits, intToBits((int)((ballLastSeenTime * 50) + 0.1) % (1 << 16), 16));
+    appendBits(bits, intToBits(quantize(ballX, minBallX, maxBallX), 10));
+    appendBits(bits, intToBits(quantize(ballY, minBallY, maxBallY), 10));
+    appendBits(bits, intToBits(quantize(myX, minAgentX, maxAgentX), 10));
+    appendBits(bits, intToBits(quantize(myY, minAgentY, maxAgentY), 10));
+    bits.push_back(fFallen ? 1 : 0);
+
+    vector<int> index((bits.size() + 5) / 6);
+    size_t ctr = 0;
+    for (size_t i = 0; i < index.size(); i++) {
+        index[i] = 0;
+        for (int j = 0; j < 6; j++) {
+            index[i] *= 2;
+            if (ctr < bits.size()) {
+                index[i] += bits[ctr++];
+            }
+        }
+    }
+    string message;
+    for (size_t i = 0; i < index.size(); i++) {
+        message += commAlphabet.at(index[i]);
+    }
+    return message;
+}
+
+bool decode(const string &message, double &time, double &ballLastSeenTime, double &ballX, double &ballY,
+            double &agentX, double &agentY, bool &fFallen) {
+    vector<int> bits(message.length() * 6);
+    for (size_t i = 0; i < message.length(); i++) {
+        size_t n = commAlphabet.find(message.at(i));
+        if (n == string::npos) {
+            return false;
+        }
+        for (int j = 5; j >= 0; j--) {
+            bits[(i * 6) + j] = n % 2;
+            n /= 2;
+        }
+    }
+    if (bits.size() < 16 + 16 + 10 + 10 + 10 + 10 + 1) {
+        return false;
+    }
+    time = bitsToInt(bits, 0, 15) * 0.02;
+    ballLastSeenTime = bitsToInt(bits, 16, 31) * 0.02;
+    ballX = minBallX + ((maxBallX - minBallX) * (bitsToInt(bits, 32, 41) / 1023.0));
+    ballY = minBallY + ((maxBallY - minBallY) * (bitsToInt(bits, 42, 51) / 1023.0));
+    agentX = minAgentX + ((maxAgentX - minAgentX) * (bitsToInt(bits, 52, 61) / 1023.0));
+    agentY = minAgentY + ((maxAgentY - minAgentY) * (bitsToInt(bits, 62, 71) / 1023.0));
+    fFallen = bits[72] != 0;
+    return true;
+}
+
+} // namespace reference
+
+struct SayData {
+    int uNum;
+    double time;
+    double ballLastSeenTime;
+    double ballX, ballY;
+    double myX, myY;
+    bool fFallen;
+};
+
+// A message in uNum's time slice, with positions a little past the field
+// limits now and then so that clipping is covered too
+static SayData randomSayData() {
+    SayData data;
+    data.uNum = 1 + rand() % NUM_AGENTS;
+    int cycle = (rand() % 30000) * NUM_AGENTS * 2 + (data.uNum - 1) * 2;
+    data.time = cycle * 0.02;
+    data.ballLastSeenTime = data.time - (rand() % 500) * 0.02;
+    data.ballLastSeenTime = data.ballLastSeenTime < 0 ? 0 : data.ballLastSeenTime;
+    data.ballX = randomIn(-HALF_FIELD_X - 3, HALF_FIELD_X + 3);
+    data.ballY = randomIn(-HALF_FIELD_Y - 3, HALF_FIELD_Y + 3);
+    data.myX = randomIn(-HALF_FIELD_X - 6, HALF_FIELD_X + 6);
+    data.myY = randomIn(-HALF_FIELD_Y - 6, HALF_FIELD_Y + 6);
+    data.fFallen = rand() % 2;
+    return data;
+}
+
+// The body of a say message, what the hear perceptor reports
+static string sayBody(const string &message) {
+    return message.substr(5, message.length() - 6);
+}
+
+static double clip(double x, double min, double max) {
+    return x < min ? min : (x > max ? max : x);
+}
+
+static int checkFieldRoundTrip() {
+    int failures = 0;
+    for (int trial = 0; trial < 20000; trial++) {
+        int numFields = 1 + rand() % 12;
+        vector<int> widths(numFields);
+        vector<unsigned int> values(numFields);
+        string message;
+        SayMessageWriter writer(message);
+        for (int i = 0; i < numFields; i++) {
+            widths[i] = 1 + rand() % 32;
+            values[i] = ((unsigned int)rand() << 16 ^ rand()) & (unsigned int)((1ULL << widths[i]) - 1);
+            writer.write(values[i], widths[i]);
+        }
+        writer.finish();
+
+        HearMessageReader reader(message);
+        for (int i = 0; i < numFields; i++) {
+            unsigned int value = 0;
+            CHECK(reader.read(widths[i], value) && value == values[i]);
+        }
+        CHECK(reader.restIsValid());
+        unsigned int ignored;
+        CHECK(!reader.read(COMM_SYMBOL_BITS + 1, ignored));
+    }
+    return failures;
+}
+
+static int checkSayMessages() {
+    int failures = 0;
+    double ballStep = (reference::maxBallX - reference::minBallX) / 1023;
+    double agentStep = (reference::maxAgentX - reference::minAgentX) / 1023;
+    for (int trial = 0; trial < 200000; trial++) {
+        SayData data = randomSayData();
+        string message;
+        CHECK(makeSayMessage(data.uNum, data.time, data.ballLastSeenTime, data.ballX, data.ballY,
+                             data.myX, data.myY, data.fFallen, message));
+        string body = sayBody(message);
+        CHECK(body == reference::encode(data.time, data.ballLastSeenTime, data.ballX, data.ballY,
+                                        data.myX, data.myY, data.fFallen));
+
+        int uNum;
+        double ballLastSeenTime, ballX, ballY, agentX, agentY, time;
+        bool fFallen;
+        CHECK(processHearMessage(body, data.time + 0.02, uNum, ballLastSeenTime, ballX, ballY,
+                                 agentX, agentY, fFallen, time));
+        CHECK(uNum == data.uNum);
+        CHECK(fabs(time - data.time) < 1e-6);
+        CHECK(fabs(ballLastSeenTime - data.ballLastSeenTime) < 1e-6);
+        CHECK(fabs(ballX - clip(data.ballX, reference::minBallX, reference::maxBallX)) <= ballStep / 2 + 1e-9);
+        CHECK(fabs(ballY - clip(data.ballY, reference::minBallY, reference::maxBallY)) <= ballStep / 2 + 1e-9);
+        CHECK(fabs(agentX - clip(data.myX, reference::minAgentX, reference::maxAgentX)) <= agentStep / 2 + 1e-9);
+        CHECK(fabs(agentY - clip(data.myY, reference::minAgentY, reference::maxAgentY)) <= agentStep / 2 + 1e-9);
+        CHECK(fFallen == data.fFallen);
+
+        if (failures > 0) {
+            cerr << "Message " << message << " for trial " << trial << endl;
+            return failures;
+        }
+    }
+    return failures;
+}
+
+// Corrupted, truncated and overlong messages are accepted or rejected
+// as by the bit vector codec, with the same values
+static int checkDamagedMessages() {
+    int failures = 0;
+    const string damage = "abZ9*#!( )~";
+    for (int trial = 0; trial < 200000; trial++) {
+        SayData data = randomSayData();
+        string body = reference::encode(data.time, data.ballLastSeenTime, data.ballX, data.ballY,
+                                        data.myX, data.myY, data.fFallen);
+        switch (rand() % 3) {
+        case 0:
+            body[rand() % body.length()] = damage[rand() % damage.length()];
+            break;
+        case 1:
+            body.resize(rand() % body.length());
+            break;
+        default:
+            body += damage[rand() % damage.length()];
+            break;
+        }
+
+        double time, ballLastSeenTime, ballX, ballY, agentX, agentY;
+        bool fFallen;
+        HearMessageReader reader(body);
+        bool fValid = readHearData(reader, time, ballLastSeenTime, ballX, ballY, agentX, agentY, fFallen);
+
+        double refTime, refBallLastSeenTime, refBallX, refBallY, refAgentX, refAgentY;
+        bool refFallen;
+        bool fRefValid = reference::decode(body, refTime, refBallLastSeenTime, refBallX, refBallY,
+                                           refAgentX, refAgentY, refFallen);
+
+        CHECK(fValid == fRefValid);
+        if (fValid && fRefValid) {
+            CHECK(time == refTime && ballLastSeenTime == refBallLastSeenTime);
+            CHECK(ballX == refBallX && ballY == refBallY);
+            CHECK(agentX == refAgentX && agentY == refAgentY);
+            CHECK(fFallen == refFallen);
+        }
+        if (failures > 0) {
+            cerr << "Message " << body << " for trial " << trial << endl;
+            return failures;
+        }
+    }
+    return failures;
+}
+
+static void bench() {
+    vector<SayData> says(1000);
+    vector<string> bodies(says.size());
+    for (size_t i = 0; i < says.size(); i++) {
+        says[i] = randomSayData();
+        bodies[i] = reference::encode(says[i].time, says[i].ballLastSeenTime, says[i].ballX, says[i].ballY,
+                                      says[i].myX, says[i].myY, says[i].fFallen);
+    }
+    int repeats = 200;
+    double count = (double)repeats * says.size();
+
+    size_t length = 0;
+    double start = getWallTime();
+    for (int r = 0; r < repeats; r++) {
+        for (size_t i = 0; i < says.size(); i++) {
+            const SayData &d = says[i];
+            string message;
+            makeSayMessage(d.uNum, d.time, d.ballLastSeenTime, d.ballX, d.ballY, d.myX, d.myY, d.fFallen, message);
+            length += message.length();
+        }
+    }
+    double encodeNs = (getWallTime() - start) / count * 1e9;
+
+    start = getWallTime();
+    for (int r = 0; r < repeats; r++) {
+        for (size_t i = 0; i < says.size(); i++) {
+            const SayData &d = says[i];
+            length += reference::encode(d.time, d.ballLastSeenTime, d.ballX, d.ballY, d.myX, d.myY,
+                                        d.fFallen).length();
+        }
+    }
+    double refEncodeNs = (getWallTime() - start) / count * 1e9;
+
+    double sum = 0;
+    start = getWallTime();
+    for (int r = 0; r < repeats; r++) {
+        for (size_t i = 0; i < bodies.size(); i++) {
+            int uNum;
+            double ballLastSeenTime, ballX, ballY, agentX, agentY, time;
+            bool fFallen;
+            processHearMessage(bodies[i], says[i].time + 0.02, uNum, ballLastSeenTime, ballX, ballY,
+                               agentX, agentY, fFallen, time);
+            sum += ballX + agentY;
+        }
+    }
+    double decodeNs = (getWallTime() - start) / count * 1e9;
+
+    start = getWallTime();
+    for (int r = 0; r < repeats; r++) {
+        for (size_t i = 0; i < bodies.size(); i++) {
+            double ballLastSeenTime, ballX, ballY, agentX, agentY, time;
+            bool fFallen;
+            reference::decode(bodies[i], time, ballLastSeenTime, ballX, ballY, agentX, agentY, fFallen);
+            sum += ballX + agentY;
+        }
+    }
+    double refDecodeNs = (getWallTime() - start) / count * 1e9;
+
+    consume(length);
+    consume(sum);
+    cout << "Per message: encode " << encodeNs << " ns (bit vectors " << refEncodeNs << " ns), decode "
+         << decodeNs << " ns (bit vectors " << refDecodeNs << " ns)" << endl;
+}
+
+int main(int argc, char **argv) {
+    srand(32);
+
+    int failures = 0;
+    failures += checkFieldRoundTrip();
+    failures += checkSayMessages();
+    failures += checkDamagedMessages();
+
+    if (isBenchRun(argc, argv)) {
+        bench();
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+/*
+ * Checks InverseKinematics::calcLegJointsPair against two calls of the
+ * single leg calcLegJoints over random foot poses in the range the walk
+ * engine commands, and with --bench times both per motion frame.
+ */
+
+#include "testutil.h"
+
+#include <kinematics/InverseKinematics.h>
+
+#include <climits>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+// The pair solver does the single leg solver's operations in the same
+// order, so it should agree to the bit; a few ulps leave room for the
+// compiler contracting differently in the two
+#define MAX_ULPS 4
+
+struct FramePoses {
+    Pose3D left;
+    Pose3D right;
+    float joint0;
+};
+
+static Pose3D randomFootPose(int sign) {
+    Pose3D pose(randomIn(-60, 60), sign * randomIn(20, 90), randomIn(-220, -140));
+    pose.rotateZ(randomIn(-0.6, 0.6));
+    pose.rotateY(randomIn(-0.3, 0.3));
+    pose.rotateX(randomIn(-0.2, 0.2));
+    return pose;
+}
+
+static vector<FramePoses> randomFrames(int numFrames) {
+    vector<FramePoses> frames(numFrames);
+    for (int i = 0; i < numFrames; i++) {
+        frames[i].left = randomFootPose(1);
+        frames[i].right = randomFootPose(-1);
+        frames[i].joint0 = randomIn(-0.8, 0.2);
+    }
+    return frames;
+}
+
+static int ulpDistance(float a, float b) {
+    if (a != a || b != b) {
+        return (a != a && b != b) ? 0 : INT_MAX;
+    }
+    int ia, ib;
+    memcpy(&ia, &a, sizeof(float));
+    memcpy(&ib, &b, sizeof(float));
+    // Map the sign-magnitude floats onto a monotonic integer line
+    ia = ia < 0 ? INT_MIN - ia : ia;
+    ib = ib < 0 ? INT_MIN - ib : ib;
+    long long distance = (long long)ia - ib;
+    distance = distance < 0 ? -distance : distance;
+    return distance > INT_MAX ? INT_MAX : (int)distance;
+}
+
+static void solveScalar(const FramePoses &frame, Joints angles, const RobotDimensions &dimensions) {
+    InverseKinematics::calcLegJoints(frame.left, angles, frame.joint0, true, dimensions);
+    InverseKinematics::calcLegJoints(frame.right, angles, frame.joint0, false, dimensions);
+}
+
+static void solvePair(const FramePoses &frame, Joints angles, const RobotDimensions &dimensions) {
+    InverseKinematics::calcLegJointsPair(frame.left, frame.right, angles, frame.joint0, dimensions);
+}
+
+static double timeFrames(void (*solve)(const FramePoses&, Joints, const RobotDimensions&),
+                         const vector<FramePoses> &frames, const RobotDimensions &dimensions, int repeats) {
+    Joints angles;
+    memset(angles, 0, sizeof(angles));
+    float sum = 0;
+    double start = getWallTime();
+    for (int r = 0; r < repeats; r++) {
+        for (size_t i = 0; i < frames.size(); i++) {
+            solve(frames[i], angles, dimensions);
+            sum += angles[LHipPitch] + angles[RAnklePitch];
+        }
+    }
+    double elapsed = getWallTime() - start;
+    consume(sum);
+    return elapsed / (repeats * frames.size()) * 1e9;
+}
+
+int main(int argc, char **argv) {
+    int failures = 0;
+    RobotDimensions dimensions;
+    srand(27);
+
+    vector<FramePoses> frames = randomFrames(200000);
+    int maxUlps = 0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        Joints scalar, pair;
+        memset(scalar, 0, sizeof(scalar));
+        memset(pair, 0, sizeof(pair));
+        solveScalar(frames[i], scalar, dimensions);
+        solvePair(frames[i], pair, dimensions);
+        for (int j = 0; j < NUM_JOINTS; j++) {
+            int ulps = ulpDistance(scalar[j], pair[j]);
+            if (ulps > maxUlps) {
+                maxUlps = ulps;
+            }
+        }
+    }
+    cout << "Largest difference from calcLegJoints: " << maxUlps << " ulps over "
+         << frames.size() << " frames" << endl;
+    CHECK(maxUlps <= MAX_ULPS);
+
+    if (isBenchRun(argc, argv)) {
+        vector<FramePoses> benchFrames = randomFrames(1000);
+        int repeats = 1000;
+        double scalarNs = timeFrames(solveScalar, benchFrames, dimensions, repeats);
+        double pairNs = timeFrames(solvePair, benchFrames, dimensions, repeats);
+        cout << "Both legs per frame: calcLegJoints twice " << scalarNs << " ns, calcLegJointsPair "
+             << pairNs << " ns" << endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
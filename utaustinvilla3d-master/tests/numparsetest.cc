@@ -0,0 +1,166 @@
+/*
+ * Fuzzes parseDouble and parseInt against strtod and atoi over numbers in
+ * the server's formats, numbers in other formats and random strings.
+ * Every token is parsed in place from a buffer that goes on past it, as
+ * in a message, so reading past its end shows up as a difference.  With
+ * --bench it times parsing the server's numbers against atof.
+ */
+
+#include "testutil.h"
+
+#include "../parser/numparse.h"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static bool sameDouble(double a, double b) {
+    if (a != a || b != b) {
+        return a != a && b != b;
+    }
+    return a == b && signbit(a) == signbit(b);
+}
+
+// A number as the server writes it, "%.2f" and the like
+static string randomServerNumber() {
+    char buffer[64];
+    int precision = rand() % 4;
+    double magnitude = pow(10.0, rand() % 7 - 2);
+    sprintf(buffer, "%.*f", precision, randomIn(-magnitude, magnitude));
+    return buffer;
+}
+
+// Numbers strtod reads that the fast path leaves to it, and near misses
+static string randomOtherNumber() {
+    static const char *const forms[] = {
+        "%se%d", "%sE+%d", "%se-%d", "%s.", ".%s", "+%s", "-%s", "%sx", "%s.5.5", " %s", "%s-"
+    };
+    static const char *const specials[] = {
+        "nan", "-nan", "inf", "-inf", "Infinity", "0x1p3", "0X1A", "-", "+", ".", "-.", "",
+        "1e", "1e+", "00000000000000000001.5", "123456789012345678", "0.000000000000000000000001"
+    };
+    char buffer[128];
+    switch (rand() % 3) {
+    case 0:
+        return specials[rand() % (sizeof(specials) / sizeof(specials[0]))];
+    case 1: {
+        // Long mantissas around the 15 digits the fast path stops at
+        string digits;
+        int numDigits = 1 + rand() % 25;
+        for (int i = 0; i < numDigits; i++) {
+            digits += '0' + rand() % 10;
+        }
+        if (rand() % 2) {
+            digits.insert(rand() % digits.length(), ".");
+        }
+        return digits;
+    }
+    default:
+        sprintf(buffer, forms[rand() % (sizeof(forms) / sizeof(forms[0]))],
+                randomServerNumber().c_str(), rand() % 400 - 100);
+        return buffer;
+    }
+}
+
+static string randomString() {
+    static const char alphabet[] = "0123456789+-.eExXnaifINAF ";
+    string s;
+    int length = rand() % 12;
+    for (int i = 0; i < length; i++) {
+        s += alphabet[rand() % (sizeof(alphabet) - 1)];
+    }
+    return s;
+}
+
+static string randomInteger() {
+    char buffer[64];
+    switch (rand() % 3) {
+    case 0:
+        sprintf(buffer, "%d", rand() % 200 - 100);
+        break;
+    case 1:
+        // Around the 9 digits the fast path stops at
+        sprintf(buffer, "%s%d%d", rand() % 2 ? "-" : "", rand(), rand() % 1000);
+        break;
+    default:
+        return randomString();
+    }
+    return buffer;
+}
+
+int main(int argc, char **argv) {
+    int failures = 0;
+    srand(43);
+
+    int numTokens = 4000000;
+    for (int trial = 0; trial < numTokens && failures < 10; trial++) {
+        string token;
+        switch (trial % 4) {
+        case 0:
+        case 1:
+            token = randomServerNumber();
+            break;
+        case 2:
+            token = randomOtherNumber();
+            break;
+        default:
+            token = randomString();
+            break;
+        }
+
+        // Followed by more of the message
+        string buffer = token + (rand() % 2 ? "5 ) (" : "e9.1)");
+        double value = parseDouble(buffer.data(), token.length());
+        double expected = strtod(token.c_str(), NULL);
+        if (!sameDouble(value, expected)) {
+            cerr << "parseDouble(\"" << token << "\") = " << value << ", strtod gives " << expected << endl;
+            failures++;
+        }
+
+        string integer = randomInteger();
+        buffer = integer + "7)";
+        int intValue = parseInt(buffer.data(), integer.length());
+        int intExpected = atoi(integer.c_str());
+        if (intValue != intExpected) {
+            cerr << "parseInt(\"" << integer << "\") = " << intValue << ", atoi gives " << intExpected << endl;
+            failures++;
+        }
+    }
+    cout << "Compared " << numTokens << " doubles and integers with strtod and atoi" << endl;
+
+    if (isBenchRun(argc, argv)) {
+        vector<string> numbers(10000);
+        for (size_t i = 0; i < numbers.size(); i++) {
+            char number[32];
+            sprintf(number, "%.2f", randomIn(-200, 200));
+            numbers[i] = number;
+        }
+        int repeats = 500;
+        double count = (double)repeats * numbers.size();
+        double sum = 0;
+
+        double start = getWallTime();
+        for (int r = 0; r < repeats; r++) {
+            for (size_t i = 0; i < numbers.size(); i++) {
+                sum += parseDouble(numbers[i].data(), numbers[i].length());
+            }
+        }
+        double parseNs = (getWallTime() - start) / count * 1e9;
+
+        start = getWallTime();
+        for (int r = 0; r < repeats; r++) {
+            for (size_t i = 0; i < numbers.size(); i++) {
+                sum += atof(numbers[i].c_str());
+            }
+        }
+        double atofNs = (getWallTime() - start) / count * 1e9;
+        consume(sum);
+
+        cout << "Per %.2f number: parseDouble " << parseNs << " ns, atof " << atofNs << " ns" << endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,355 @@
+/*
+ * Checks that the parser's vocabularies map every name perceptors report
+ * to the play mode, joint, landmark or body part the parser expects.  Then
+ * checks PerfectHash on the vocabularies of names in recorded server
+ * messages (the file given as the argument, one message per line as
+ * written by agentspark --recordmessages): every name finds its own row
+ * and other strings find nothing.  With --bench it times looking up every
+ * name in the messages against comparing with each name of its vocabulary
+ * in turn, as the parser did before.
+ */
+
+#include "testutil.h"
+
+#include "../parser/perfecthash.h"
+#include "../parser/token.h"
+#include "../parser/vocabulary.h"
+#include "../headers/headers.h"
+#include "../worldmodel/WorldObject.h"
+
+#include <common/RobotInfo.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct NameRow {
+    const char *name;
+};
+
+/*
+ * The names of one vocabulary, in the order they first appear in the
+ * messages, and every place they appear
+ */
+struct Vocabulary {
+    string description;
+    vector<string> names;
+    vector<NameRow> rows;
+    vector<Token> occurrences;
+
+    Vocabulary(const string &description_) : description(description_) {}
+
+    void add(const Token &name) {
+        occurrences.push_back(name);
+        for (size_t i = 0; i < names.size(); i++) {
+            if (name.is(names[i])) {
+                return;
+            }
+        }
+        names.push_back(name.toString());
+    }
+
+    // Call once all names are added, rows point into names
+    void finish() {
+        rows.resize(names.size());
+        for (size_t i = 0; i < names.size(); i++) {
+            rows[i].name = names[i].c_str();
+        }
+    }
+};
+
+static vector<Token> tokenise(const string &message) {
+    vector<Token> tokens;
+    size_t start = 0;
+    for (size_t i = 0; i < message.length(); i++) {
+        char c = message[i];
+        if (c == '(' || c == ')' || c == ' ') {
+            if (i > start) {
+                tokens.push_back(Token(message.data() + start, i - start));
+            }
+            start = i + 1;
+        }
+    }
+    return tokens;
+}
+
+static bool isNumber(const Token &token) {
+    char c = token.str[0];
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.';
+}
+
+// The index of name in the vocabulary found by comparing with every name
+static int compareChain(const Vocabulary &vocabulary, const Token &name) {
+    for (size_t i = 0; i < vocabulary.rows.size(); i++) {
+        if (name.is(vocabulary.rows[i].name)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int checkVocabulary(const Vocabulary &vocabulary, const PerfectHash &hash) {
+    int failures = 0;
+    for (size_t i = 0; i < vocabulary.names.size(); i++) {
+        const string &name = vocabulary.names[i];
+        CHECK(hash.lookup(name) == (int)i);
+        CHECK(hash.lookup(name.data(), name.size() - 1) != (int)i);
+        CHECK(hash.lookup(name + "x") == -1);
+        CHECK(hash.lookup("x" + name) == -1);
+    }
+    CHECK(hash.lookup("") == -1);
+    for (size_t i = 0; i < vocabulary.occurrences.size(); i++) {
+        const Token &name = vocabulary.occurrences[i];
+        CHECK(hash.lookup(name.str, name.length) == compareChain(vocabulary, name));
+    }
+    return failures;
+}
+
+static void benchVocabulary(const Vocabulary &vocabulary, const PerfectHash &hash, int numMessages) {
+    int repeats = 2000;
+    long sum = 0;
+
+    double start = getWallTime();
+    for (int r = 0; r < repeats; r++) {
+        for (size_t i = 0; i < vocabulary.occurrences.size(); i++) {
+            sum += hash.lookup(vocabulary.occurrences[i].str, vocabulary.occurrences[i].length);
+        }
+    }
+    double hashTime = getWallTime() - start;
+
+    start = getWallTime();
+    for (int r = 0; r < repeats; r++) {
+        for (size_t i = 0; i < vocabulary.occurrences.size(); i++) {
+            sum += compareChain(vocabulary, vocabulary.occurrences[i]);
+        }
+    }
+    double chainTime = getWallTime() - start;
+    consume(sum);
+
+    double lookups = (double)repeats * vocabulary.occurrences.size();
+    cout << vocabulary.description << " (" << vocabulary.names.size() << " names, "
+         << vocabulary.occurrences.size() / (double)numMessages << " per message): PerfectHash "
+         << hashTime / lookups * 1e9 << " ns, compare chain " << chainTime / lookups * 1e9
+         << " ns per lookup; " << hashTime / repeats / numMessages * 1e9 << " against "
+         << chainTime / repeats / numMessages * 1e9 << " ns per message" << endl;
+}
+
+#define NUM_ROWS(table) (sizeof(table) / sizeof(table[0]))
+
+// What the parser's vocabularies must map each name to, written out
+// independently of them
+struct ExpectedName {
+    const char *name;
+    int value;
+    int value2;
+};
+
+static const ExpectedName expectedPlayModes[] = {
+    {"BeforeKickOff", PM_BEFORE_KICK_OFF, 0},
+    {"KickOff_Left", PM_KICK_OFF_LEFT, 0},
+    {"KickOff_Right", PM_KICK_OFF_RIGHT, 0},
+    {"PlayOn", PM_PLAY_ON, 0},
+    {"KickIn_Left", PM_KICK_IN_LEFT, 0},
+    {"KickIn_Right", PM_KICK_IN_RIGHT, 0},
+    {"Goal_Left", PM_GOAL_LEFT, 0},
+    {"Goal_Right", PM_GOAL_RIGHT, 0},
+    {"GameOver", PM_GAME_OVER, 0},
+    {"corner_kick_left", PM_CORNER_KICK_LEFT, 0},
+    {"corner_kick_right", PM_CORNER_KICK_RIGHT, 0},
+    {"goal_kick_left", PM_GOAL_KICK_LEFT, 0},
+    {"goal_kick_right", PM_GOAL_KICK_RIGHT, 0},
+    {"offside_left", PM_OFFSIDE_LEFT, 0},
+    {"offside_right", PM_OFFSIDE_RIGHT, 0},
+    {"free_kick_left", PM_FREE_KICK_LEFT, 0},
+    {"free_kick_right", PM_FREE_KICK_RIGHT, 0},
+    {"direct_free_kick_left", PM_DIRECT_FREE_KICK_LEFT, 0},
+    {"direct_free_kick_right", PM_DIRECT_FREE_KICK_RIGHT, 0}
+};
+
+static const ExpectedName expectedHingeJoints[] = {
+    {"hj1", HJ_H1, HeadYaw},
+    {"hj2", HJ_H2, HeadPitch},
+    {"laj1", HJ_LA1, LShoulderPitch},
+    {"laj2", HJ_LA2, LShoulderRoll},
+    {"laj3", HJ_LA3, LElbowYaw},
+    {"laj4", HJ_LA4, LElbowRoll},
+    {"raj1", HJ_RA1, RShoulderPitch},
+    {"raj2", HJ_RA2, RShoulderRoll},
+    {"raj3", HJ_RA3, RElbowYaw},
+    {"raj4", HJ_RA4, RElbowRoll},
+    {"llj1", HJ_LL1, LHipYawPitch},
+    {"llj2", HJ_LL2, LHipRoll},
+    {"llj3", HJ_LL3, LHipPitch},
+    {"llj4", HJ_LL4, LKneePitch},
+    {"llj5", HJ_LL5, LAnklePitch},
+    {"llj6", HJ_LL6, LAnkleRoll},
+    {"llj7", HJ_LL7, LToePitch},
+    {"rlj1", HJ_RL1, RHipYawPitch},
+    {"rlj2", HJ_RL2, RHipRoll},
+    {"rlj3", HJ_RL3, RHipPitch},
+    {"rlj4", HJ_RL4, RKneePitch},
+    {"rlj5", HJ_RL5, RAnklePitch},
+    {"rlj6", HJ_RL6, RAnkleRoll},
+    {"rlj7", HJ_RL7, RToePitch}
+};
+
+static const ExpectedName expectedGoalPosts[] = {
+    {"G1L", GOALPOST_1_L, 0},
+    {"G1R", GOALPOST_1_R, 0},
+    {"G2L", GOALPOST_2_L, 0},
+    {"G2R", GOALPOST_2_R, 0}
+};
+
+static const ExpectedName expectedFlags[] = {
+    {"F1L", FLAG_1_L, 0},
+    {"F1R", FLAG_1_R, 0},
+    {"F2L", FLAG_2_L, 0},
+    {"F2R", FLAG_2_R, 0}
+};
+
+static const ExpectedName expectedBodyParts[] = {
+    {"head", WO_TEAMMATE_HEAD1, WO_OPPONENT_HEAD1},
+    {"llowerarm", WO_TEAMMATE_ARM_L1, WO_OPPONENT_ARM_L1},
+    {"rlowerarm", WO_TEAMMATE_ARM_R1, WO_OPPONENT_ARM_R1},
+    {"lfoot", WO_TEAMMATE_FOOT_L1, WO_OPPONENT_FOOT_L1},
+    {"rfoot", WO_TEAMMATE_FOOT_R1, WO_OPPONENT_FOOT_R1}
+};
+
+/*
+ * Looks up every expected name with the parser's hash and checks what
+ * the row it gets holds.  getValue and getValue2 read a row of table.
+ */
+template<class Row>
+static int checkParserVocabulary(const char *description, const PerfectHash &hash, const Row *table,
+                                 const ExpectedName *expected, size_t numExpected,
+                                 int (*getValue)(const Row&), int (*getValue2)(const Row&)) {
+    int failures = 0;
+    for (size_t i = 0; i < numExpected; i++) {
+        int row = hash.lookup(expected[i].name);
+        if (row < 0) {
+            cerr << description << ": \"" << expected[i].name << "\" not found" << endl;
+            failures++;
+            continue;
+        }
+        if (getValue(table[row]) != expected[i].value || getValue2(table[row]) != expected[i].value2) {
+            cerr << description << ": \"" << expected[i].name << "\" maps to " << getValue(table[row])
+                 << ", " << getValue2(table[row]) << " instead of " << expected[i].value << ", "
+                 << expected[i].value2 << endl;
+            failures++;
+        }
+    }
+    return failures;
+}
+
+static int getPlayMode(const PlayModeName &row) {
+    return row.playMode;
+}
+static int getIndexBM(const HingeJointName &row) {
+    return row.indexBM;
+}
+static int getIndexWE(const HingeJointName &row) {
+    return row.indexWE;
+}
+static int getLandmark(const LandmarkName &row) {
+    return row.index;
+}
+static int getTeammate1(const BodyPartName &row) {
+    return row.teammate1;
+}
+static int getOpponent1(const BodyPartName &row) {
+    return row.opponent1;
+}
+template<class Row>
+static int getZero(const Row&) {
+    return 0;
+}
+
+static int checkParserVocabularies() {
+    int failures = 0;
+    failures += checkParserVocabulary("Play modes", playModeHash, playModeNames, expectedPlayModes,
+                                      NUM_ROWS(expectedPlayModes), getPlayMode, getZero<PlayModeName>);
+    failures += checkParserVocabulary("Hinge joints", hingeJointHash, hingeJointNames, expectedHingeJoints,
+                                      NUM_ROWS(expectedHingeJoints), getIndexBM, getIndexWE);
+    failures += checkParserVocabulary("Goal posts", goalPostHash, goalPostNames, expectedGoalPosts,
+                                      NUM_ROWS(expectedGoalPosts), getLandmark, getZero<LandmarkName>);
+    failures += checkParserVocabulary("Flags", flagHash, flagNames, expectedFlags,
+                                      NUM_ROWS(expectedFlags), getLandmark, getZero<LandmarkName>);
+    failures += checkParserVocabulary("Body parts", bodyPartHash, bodyPartNames, expectedBodyParts,
+                                      NUM_ROWS(expectedBodyParts), getTeammate1, getOpponent1);
+
+    // Names from one vocabulary aren't found in another
+    CHECK(playModeHash.lookup("hj1") == -1);
+    CHECK(hingeJointHash.lookup("PlayOn") == -1);
+    CHECK(goalPostHash.lookup("F1L") == -1);
+    CHECK(flagHash.lookup("G1L") == -1);
+    CHECK(bodyPartHash.lookup("llj1") == -1);
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    int failures = 0;
+
+    failures += checkParserVocabularies();
+
+    const char *messagesFile = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench")) {
+            messagesFile = argv[i];
+        }
+    }
+    if (messagesFile == NULL) {
+        cerr << "usage: " << argv[0] << " [--bench] <recorded messages file>" << endl;
+        return 2;
+    }
+
+    vector<string> messages;
+    ifstream in(messagesFile);
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty()) {
+            messages.push_back(line);
+        }
+    }
+    if (messages.empty()) {
+        cerr << "No messages in " << messagesFile << endl;
+        return 2;
+    }
+
+    Vocabulary hingeJoints("Hinge joints");
+    Vocabulary playModes("Play modes");
+    Vocabulary sightings("Objects and body parts seen");
+    for (size_t m = 0; m < messages.size(); m++) {
+        vector<Token> tokens = tokenise(messages[m]);
+        for (size_t i = 2; i < tokens.size(); i++) {
+            if (tokens[i - 2].is("HJ") && tokens[i - 1].is("n")) {
+                hingeJoints.add(tokens[i]);
+            } else if (tokens[i - 1].is("pm")) {
+                playModes.add(tokens[i]);
+            }
+        }
+        for (size_t i = 0; i + 1 < tokens.size(); i++) {
+            if (tokens[i + 1].is("pol") && !isNumber(tokens[i])) {
+                sightings.add(tokens[i]);
+            }
+        }
+    }
+
+    Vocabulary *vocabularies[] = {&hingeJoints, &playModes, &sightings};
+    for (int v = 0; v < 3; v++) {
+        Vocabulary &vocabulary = *vocabularies[v];
+        vocabulary.finish();
+        CHECK(!vocabulary.names.empty());
+        if (vocabulary.names.empty()) {
+            continue;
+        }
+        PerfectHash hash(&vocabulary.rows[0], vocabulary.rows.size());
+        failures += checkVocabulary(vocabulary, hash);
+        if (isBenchRun(argc, argv)) {
+            benchVocabulary(vocabulary, hash, messages.size());
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
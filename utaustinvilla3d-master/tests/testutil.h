@@ -0,0 +1,51 @@
+#ifndef TESTUTIL_H
+#define TESTUTIL_H
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/time.h>
+
+/*
+ * Shared by the tests in this directory.  Each test is a program that
+ * runs its checks and exits with a non-zero status if one failed; given
+ * --bench it also times the code it checks and prints the results.
+ */
+
+inline bool isBenchRun(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--bench")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline double getWallTime() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// Uniform in [low, high), reproducible through srand()
+inline double randomIn(double low, double high) {
+    return low + (high - low) * (rand() / (RAND_MAX + 1.0));
+}
+
+// Keeps a benchmark's result alive so that the compiler can't drop the
+// work that computed it
+template<class T>
+inline void consume(const T &value) {
+    static volatile T sink;
+    sink = value;
+}
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond << std::endl; \
+            failures++; \
+        } \
+    } while (0)
+
+#endif // TESTUTIL_H
@@ -2,19 +2,22 @@
 
 Module::Module():
     memory_(NULL)
-{}
+{
+    for (int i = 0; i < NUM_MEMORY_BLOCKS; i++)
+        required_blocks_[i] = false;
+}
 
 void Module::init(Memory *memory) {
     memory_ = memory;
     specifyMemoryBlocks();
 }
 
-void Module::requiresMemoryBlock(const std::string &name) {
+void Module::requiresMemoryBlock(MemoryBlockID id) {
     //I commented this check out as it doesn't work well with the new getOrAdd commands (MQ 3/15/2011)
 
     //MemoryBlock *block;
     //memory_->getBlockByName(block,name);
     //if (block == NULL)
     //  std::cerr << "Module::requiresMemoryBlock: ERROR: requiring memory block that does not exist: " << name << std::endl;
-    required_blocks_.push_back(name);
+    required_blocks_[id] = true;
 }
@@ -14,38 +14,34 @@ public:
     void init(Memory *memory);
 
 protected:
-    void requiresMemoryBlock(const std::string &name);
+    void requiresMemoryBlock(MemoryBlockID id);
     virtual void specifyMemoryBlocks() = 0;
 
     Memory *memory_; // Should go private once we remove bhuman walk module
 
 protected:
-    template <class T>
-    void getMemoryBlock(T *&ptr, const std::string &name) {
-        for (unsigned int i = 0; i < required_blocks_.size(); i++) {
-            if (required_blocks_[i] == name) {
-                memory_->getBlockByName(ptr,name);
-                return;
-            }
+    template <MemoryBlockID ID, class T>
+    void getMemoryBlock(T *&ptr) {
+        if (required_blocks_[ID]) {
+            memory_->getBlock<ID>(ptr);
+            return;
         }
-        std::cerr << "Module::getMemoryBlock - ERROR: tried to get a memory block that was not required: " << name << std::endl;
+        std::cerr << "Module::getMemoryBlock - ERROR: tried to get a memory block that was not required: " << getMemoryBlockName(ID) << std::endl;
         return;
     }
 
-    template <class T>
-    void getOrAddMemoryBlock(T *&ptr, const std::string &name) {
-        for (unsigned int i = 0; i < required_blocks_.size(); i++) {
-            if (required_blocks_[i] == name) {
-                memory_->getOrAddBlockByName(ptr,name);
-                return;
-            }
+    template <MemoryBlockID ID, class T>
+    void getOrAddMemoryBlock(T *&ptr) {
+        if (required_blocks_[ID]) {
+            memory_->getOrAddBlock<ID>(ptr);
+            return;
         }
-        std::cerr << "Module::getMemoryBlock - ERROR: tried to get a memory block that was not required: " << name << std::endl;
+        std::cerr << "Module::getMemoryBlock - ERROR: tried to get a memory block that was not required: " << getMemoryBlockName(ID) << std::endl;
         return;
     }
 
 private:
-    std::vector<std::string> required_blocks_;
+    bool required_blocks_[NUM_MEMORY_BLOCKS];
 };
 
 #endif /* end of include guard: MODULE_NNIRD0YI */
@@ -9,6 +9,9 @@
 #include <motion/MotionModule.h>
 #include <sensor/SensorModule.h>
 
+#include <common/ParamRegistry.h>
+
+
 MotionCore *MotionCore::inst_ = NULL;
 
 MotionCore::MotionCore (CoreType type, bool use_shared_memory, Memory& memory):
@@ -18,18 +21,21 @@ MotionCore::MotionCore (CoreType type, bool use_shared_memory, Memory& memory):
     memory_(memory),
     type_(type),
     last_frame_processed_(0),
-    log_("/dev/null"),
+    log_(NULL),
     fps_frames_processed_(0)
 {
     inst_ = this;
     initMemory();
     initModules();
+    initLog();
 
     start_time_ = frame_info_->seconds_since_start;
     fps_time_ = frame_info_->seconds_since_start;
 }
 
 MotionCore::~MotionCore() {
+    if (log_ != NULL)
+        delete log_;
     if (kinematics_ != NULL)
         delete kinematics_;
     if (motion_ != NULL)
@@ -66,6 +72,10 @@ void MotionCore::move(WalkRequestBlock::ParamSet paramSet, float xvel, float yve
     processMotionFrame();
 }
 
+void MotionCore::reloadParameters() {
+    motion_->reloadParameters();
+}
+
 void MotionCore::processMotionFrame() {
     unsigned int &frame_id = frame_info_->frame_id;
     if (frame_id <= last_frame_processed_) {
@@ -107,7 +117,7 @@ void MotionCore::processMotionFrame() {
     processSensorUpdate();
     motion_->processFrame();
 
-    //logMemory();
+    logMemory();
     //kinematics_->calculatePose();
     //std::cerr << ((BodyModelBlock*)memory_.getBlockPtr("body_model"))->center_of_mass_ << std::endl;
 
@@ -136,15 +146,15 @@ void MotionCore::initMemory() {
         mem_source = MEMORY_ROBOT;
 
     //Add required memory blocks
-    memory_.addBlockByName("processed_sensors");
-    memory_.addBlockByName("body_model");
-    memory_.addBlockByName("graphable");
-    memory_.addBlockByName("walk_engine");
-    memory_.addBlockByName("walk_request");
-    memory_.addBlockByName("odometry");
+    memory_.addBlockById(MB_PROCESSED_SENSORS);
+    memory_.addBlockById(MB_BODY_MODEL);
+    memory_.addBlockById(MB_GRAPHABLE);
+    memory_.addBlockById(MB_WALK_ENGINE);
+    memory_.addBlockById(MB_WALK_REQUEST);
+    memory_.addBlockById(MB_ODOMETRY);
 
-    memory_.getBlockByName(frame_info_,"frame_info");
-    memory_.getBlockByName(walk_request_,"walk_request");
+    memory_.getBlock<MB_FRAME_INFO>(frame_info_);
+    memory_.getBlock<MB_WALK_REQUEST>(walk_request_);
 
     // print out all the memory blocks we're using
     /*
@@ -157,6 +167,26 @@ void MotionCore::initMemory() {
     */
 }
 
+void MotionCore::initLog() {
+    // Optional: log every motion frame to a ring file of this many frames,
+    // read it with ringlogreader
+    const ParamRegistry &params = getParams();
+    ParamID file = params.find("motion_log_file");
+    if (!params.has(file))
+        return;
+    unsigned int num_frames = params.get("motion_log_frames", 30000);
+
+    memory_.setBlockLogging(MB_FRAME_INFO,true);
+    memory_.setBlockLogging(MB_PROCESSED_SENSORS,true);
+    memory_.setBlockLogging(MB_PROCESSED_JOINT_ANGLES,true);
+    memory_.setBlockLogging(MB_PROCESSED_JOINT_COMMANDS,true);
+    memory_.setBlockLogging(MB_WALK_REQUEST,true);
+    memory_.setBlockLogging(MB_WALK_ENGINE,true);
+    memory_.setBlockLogging(MB_ODOMETRY,true);
+    log_ = new RingLogger(params.getText(file).c_str(),num_frames);
+}
+
 void MotionCore::logMemory() {
-    log_.writeMemory(memory_);
+    if (log_ != NULL)
+        log_->writeMemory(memory_);
 }
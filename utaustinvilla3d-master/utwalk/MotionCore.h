@@ -4,7 +4,7 @@
 #include <memory/Memory.h>
 #include <memory/FrameInfoBlock.h>
 #include <memory/WalkRequestBlock.h> // TEMPORARY TODO
-#include <memory/Logger.h>
+#include <memory/RingLogger.h>
 
 class KinematicsModule;
 class MotionModule;
@@ -29,6 +29,9 @@ public:
 
     void logMemory();
 
+    // Picks up parameters reloaded into the parameter registry
+    void reloadParameters();
+
     Memory memory_;
     CoreType type_;
     unsigned int last_frame_processed_;
@@ -38,7 +41,7 @@ public:
     SensorModule *sensor_;
 
 #ifndef SWIG   // Lua can't handle the file IO
-    Logger log_; //handling logging in vision for now
+    RingLogger *log_; // NULL unless motion_log_file is set
 #endif
 
     static MotionCore *inst_;
@@ -52,6 +55,7 @@ public:
 private:
     void initMemory();
     void initModules();
+    void initLog();
 };
 
 #endif /* end of include guard: CORE_2H7QHCY7 */
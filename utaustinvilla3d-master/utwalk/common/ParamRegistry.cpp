@@ -0,0 +1,95 @@
+#include "ParamRegistry.h"
+
+#include <stdlib.h>
+
+ParamRegistry& getParams() {
+    // Constructed on first use so that Params declared as statics in any
+    // file can register themselves
+    static ParamRegistry params;
+    return params;
+}
+
+ParamRegistry::ParamRegistry() {
+}
+
+void ParamRegistry::set(const std::string &name, const std::string &text) {
+    ParamID id = intern(name);
+    texts_[id] = text;
+    values_[id] = atof(text.c_str());
+    set_[id] = true;
+}
+
+void ParamRegistry::clearValues() {
+    for (unsigned int id = 0; id < names_.size(); id++) {
+        texts_[id] = "";
+        values_[id] = 0;
+        set_[id] = false;
+    }
+}
+
+ParamID ParamRegistry::intern(const std::string &name) {
+    std::map<std::string, ParamID>::const_iterator it = ids_.find(name);
+    if (it != ids_.end())
+        return it->second;
+
+    ParamID id = names_.size();
+    ids_[name] = id;
+    names_.push_back(name);
+    texts_.push_back("");
+    values_.push_back(0);
+    set_.push_back(false);
+    declared_.push_back(false);
+    return id;
+}
+
+ParamID ParamRegistry::find(const std::string &name) const {
+    std::map<std::string, ParamID>::const_iterator it = ids_.find(name);
+    if (it == ids_.end())
+        return NO_PARAM;
+    return it->second;
+}
+
+ParamID ParamRegistry::require(const std::string &name) const {
+    // Every parameter that is set was interned when it was loaded
+    ParamID id = find(name);
+    if (!has(id))
+        throw "Missing parameter: " + name;
+    return id;
+}
+
+double ParamRegistry::get(const std::string &name) const {
+    return get(require(name));
+}
+
+double ParamRegistry::get(const std::string &name, double defaultValue) const {
+    ParamID id = find(name);
+    if (!has(id))
+        return defaultValue;
+    return get(id);
+}
+
+ParamID ParamRegistry::declare(const std::string &name) {
+    ParamID id = intern(name);
+    declared_[id] = true;
+    return id;
+}
+
+void ParamRegistry::checkDeclared() const {
+    std::string missing;
+    for (unsigned int id = 0; id < names_.size(); id++) {
+        if (declared_[id] && !set_[id])
+            missing += " " + names_[id];
+    }
+    if (!missing.empty())
+        throw "Missing parameters:" + missing;
+}
+
+Param::Param(const std::string &name, bool fRequired):
+    id_(fRequired ? getParams().declare(name) : getParams().intern(name)),
+    fRequired_(fRequired)
+{
+}
+
+void Param::missing() const {
+    throw "Missing parameter: " + getParams().getName(id_);
+}
@@ -0,0 +1,99 @@
+#ifndef PARAMREGISTRY_H7QX3MRC
+#define PARAMREGISTRY_H7QX3MRC
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Handle of a parameter name, an index into the registry
+typedef int ParamID;
+#define NO_PARAM -1
+
+/*
+ * All parameters loaded from the parameter files.  Every name is given an
+ * integer handle the first time it is seen and the values are parsed to
+ * double once when they are loaded, so reading a parameter through its
+ * handle is an array access.  Names are only looked up when handles are
+ * resolved, which is done when the agent starts.
+ */
+class ParamRegistry {
+public:
+    ParamRegistry();
+
+    // Sets a parameter from its text in a parameter file
+    void set(const std::string &name, const std::string &text);
+    // Forgets every value before the parameter files are loaded again.
+    // Handles stay valid.
+    void clearValues();
+
+    // Handle of name, assigned on first use even if the parameter is not set
+    ParamID intern(const std::string &name);
+    // Handle of name, NO_PARAM if it was never interned
+    ParamID find(const std::string &name) const;
+    // Handle of a parameter that has to be set, throws if it isn't
+    ParamID require(const std::string &name) const;
+
+    inline bool has(ParamID id) const {
+        return id >= 0 && id < (int)set_.size() && set_[id];
+    }
+    inline double get(ParamID id) const {
+        return values_[id];
+    }
+    inline const std::string& getText(ParamID id) const {
+        return texts_[id];
+    }
+    inline const std::string& getName(ParamID id) const {
+        return names_[id];
+    }
+
+    // Value of a parameter that has to be set, throws if it isn't
+    double get(const std::string &name) const;
+    // Value of an optional parameter
+    double get(const std::string &name, double defaultValue) const;
+
+    // Marks a parameter as needed by a Param declared in the code
+    ParamID declare(const std::string &name);
+    // Throws listing every declared parameter that was not loaded, call
+    // once all parameter files are loaded
+    void checkDeclared() const;
+
+private:
+    std::map<std::string, ParamID> ids_;
+    std::vector<std::string> names_;
+    std::vector<std::string> texts_;
+    std::vector<double> values_;
+    std::vector<bool> set_;
+    std::vector<bool> declared_;
+};
+
+// The parameters of this agent, filled in by LoadParams() in main.cc
+ParamRegistry& getParams();
+
+/*
+ * A parameter the code always needs, meant to be declared as a static so
+ * that its handle is interned at startup and a missing value is reported
+ * by checkDeclared() when the parameter files are loaded.  Parameters that
+ * are only needed sometimes (for one body type, say) are declared with
+ * fRequired false and only fail when read without being set.
+ */
+class Param {
+public:
+    Param(const std::string &name, bool fRequired = true);
+
+    inline operator double() const {
+        if (!fRequired_ && !getParams().has(id_))
+            missing();
+        return getParams().get(id_);
+    }
+    inline ParamID getID() const {
+        return id_;
+    }
+
+private:
+    void missing() const;
+
+    ParamID id_;
+    bool fRequired_;
+};
+
+#endif /* end of include guard: PARAMREGISTRY_H7QX3MRC */
@@ -0,0 +1,68 @@
+/**
+ * @file TripleBuffer.h
+ *
+ * Declaration of class TripleBuffer
+ */
+
+#ifndef __TripleBuffer_h_
+#define __TripleBuffer_h_
+
+#include <boost/atomic.hpp>
+
+/**
+ * @class TripleBuffer
+ *
+ * Lock-free hand off of the latest value of type V from exactly one writer
+ * thread to exactly one reader thread.  The writer fills writeBuffer() and
+ * calls publish(); the reader calls update() and then reads readBuffer().
+ * Neither side ever blocks: values the reader did not get to before the
+ * next publish() are dropped, so the reader always sees the newest one.
+ *
+ * This is a double buffer with a third slot in the middle, which is what
+ * lets the writer publish while the reader is still looking at its buffer.
+ */
+template <class V> class TripleBuffer
+{
+public:
+    TripleBuffer() : middle(1), writeIndex(0), readIndex(2) {}
+
+    /** buffer owned by the writer until the next publish() */
+    V& writeBuffer() {
+        return buffer[writeIndex];
+    }
+
+    /** makes the contents of writeBuffer() available to the reader */
+    void publish() {
+        writeIndex = middle.exchange(writeIndex | FRESH, boost::memory_order_acq_rel) & INDEX;
+    }
+
+    /**
+     * moves the most recently published value into readBuffer()
+     * \return true if there was a value that had not been read yet
+     */
+    bool update() {
+        if (!(middle.load(boost::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        readIndex = middle.exchange(readIndex, boost::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    /** buffer owned by the reader until the next update() */
+    const V& readBuffer() const {
+        return buffer[readIndex];
+    }
+
+private:
+    enum {
+        INDEX = 3,
+        FRESH = 4
+    };
+
+    V buffer[3];
+    boost::atomic<unsigned int> middle;
+    unsigned int writeIndex;
+    unsigned int readIndex;
+};
+
+#endif // __TripleBuffer_h_
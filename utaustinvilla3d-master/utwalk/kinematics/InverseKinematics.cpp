@@ -124,6 +124,216 @@ void InverseKinematics::calcLegJoints(const Pose3D& position, Joints jointAngles
     jointAngles[firstJoint + 5] = joint5;
 }
 
+namespace {
+
+// Lane 0 holds the left leg, lane 1 the right leg, lanes 2 and 3 are padding.
+// GCC lowers the generic vector type to SSE on x86 and NEON on ARM.
+typedef float LegLanes __attribute__((vector_size(16)));
+
+enum {
+    LANE_LEFT,
+    LANE_RIGHT,
+    NUM_LANES = 4
+};
+
+struct LaneVector3 {
+    LegLanes x, y, z;
+};
+
+struct LaneRotation {
+    LaneVector3 c[3];
+};
+
+inline LaneVector3 operator+(const LaneVector3& a, const LaneVector3& b)
+{
+    LaneVector3 r = { a.x + b.x, a.y + b.y, a.z + b.z };
+    return r;
+}
+
+inline LaneVector3 operator-(const LaneVector3& a, const LaneVector3& b)
+{
+    LaneVector3 r = { a.x - b.x, a.y - b.y, a.z - b.z };
+    return r;
+}
+
+inline LaneVector3 operator*(const LaneVector3& a, const LegLanes& f)
+{
+    LaneVector3 r = { a.x * f, a.y * f, a.z * f };
+    return r;
+}
+
+// same evaluation order as Vector3::operator*(const Vector3&)
+inline LegLanes dot(const LaneVector3& a, const LaneVector3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// same evaluation order as Matrix3x3::operator*(const Vector3&)
+inline LaneVector3 operator*(const LaneRotation& m, const LaneVector3& v)
+{
+    return m.c[0] * v.x + m.c[1] * v.y + m.c[2] * v.z;
+}
+
+inline LaneRotation operator*(const LaneRotation& a, const LaneRotation& b)
+{
+    LaneRotation r = { { a * b.c[0], a * b.c[1], a * b.c[2] } };
+    return r;
+}
+
+inline LegLanes splat(float f)
+{
+    LegLanes r = { f, f, f, f };
+    return r;
+}
+
+inline LaneRotation identity()
+{
+    const LegLanes one = splat(1.0f), zero = splat(0.0f);
+    LaneRotation r = { { { one, zero, zero }, { zero, one, zero }, { zero, zero, one } } };
+    return r;
+}
+
+// RotationMatrix::rotateX/Y/Z with per lane angles given as cos and sin
+inline void rotateX(LaneRotation& m, const LegLanes& c, const LegLanes& s)
+{
+    const LaneVector3 c1 = m.c[1] * c + m.c[2] * s;
+    const LaneVector3 c2 = m.c[2] * c - m.c[1] * s;
+    m.c[1] = c1;
+    m.c[2] = c2;
+}
+
+inline void rotateY(LaneRotation& m, const LegLanes& c, const LegLanes& s)
+{
+    const LaneVector3 c0 = m.c[0] * c - m.c[2] * s;
+    const LaneVector3 c2 = m.c[2] * c + m.c[0] * s;
+    m.c[0] = c0;
+    m.c[2] = c2;
+}
+
+inline void rotateZ(LaneRotation& m, const LegLanes& c, const LegLanes& s)
+{
+    const LaneVector3 c0 = m.c[0] * c + m.c[1] * s;
+    const LaneVector3 c1 = m.c[1] * c - m.c[0] * s;
+    m.c[0] = c0;
+    m.c[1] = c1;
+}
+
+// per lane cos and sin of the two leg lanes, the padding lanes get the identity
+inline void cosSin(const LegLanes& angle, LegLanes& c, LegLanes& s)
+{
+    c = splat(1.0f);
+    s = splat(0.0f);
+    for (int i = LANE_LEFT; i <= LANE_RIGHT; i++) {
+        c[i] = cosf(angle[i]);
+        s[i] = sinf(angle[i]);
+    }
+}
+
+inline LegLanes sqrtLanes(const LegLanes& v)
+{
+    LegLanes r;
+    for (int i = 0; i < NUM_LANES; i++)
+        r[i] = sqrtf(v[i]);
+    return r;
+}
+
+inline void load(LaneVector3& lanes, int lane, const Vector3<float>& v)
+{
+    lanes.x[lane] = v.x;
+    lanes.y[lane] = v.y;
+    lanes.z[lane] = v.z;
+}
+
+} // namespace
+
+void InverseKinematics::calcLegJointsPair(const Pose3D& positionLeft, const Pose3D& positionRight, Joints jointAngles, float joint0, const RobotDimensions& robotDimensions)
+{
+    // sign is -1 for the left leg and 1 for the right leg, see calcLegJoints
+    const LegLanes sign = { -1, 1, 1, 1 };
+
+    // the padding lanes repeat the right leg so that they stay finite
+    LaneVector3 translation;
+    LaneRotation rotation;
+    for (int lane = 0; lane < NUM_LANES; lane++) {
+        const Pose3D& position = (lane == LANE_LEFT) ? positionLeft : positionRight;
+        load(translation, lane, position.translation);
+        for (int i = 0; i < 3; i++)
+            load(rotation.c[i], lane, position.rotation.c[i]);
+    }
+    translation.y += splat(robotDimensions.lengthBetweenLegs / 2) * sign; // translate to origin of leg
+
+    // compute residual transformation with fixed joint0, the angles only differ
+    // in sign between the legs so cos is shared and sin is mirrored
+    static const float cos_pi_4 = cosf(M_PI_4);
+    static const float sin_pi_4 = sinf(M_PI_4);
+    const float cosJoint0 = cosf(joint0);
+    const float sinJoint0 = sinf(joint0);
+    LegLanes c = { cosJoint0, cosJoint0, 1, 1 };
+    LegLanes s = { sinJoint0, -sinJoint0, 0, 0 };
+    LaneRotation residual = identity();
+    rotateZ(residual, c, s);
+    c = (LegLanes) { cos_pi_4, cos_pi_4, 1, 1 };
+    s = (LegLanes) { -sin_pi_4, sin_pi_4, 0, 0 };
+    rotateX(residual, c, s);
+    const LaneVector3 zero = { splat(0.0f), splat(0.0f), splat(0.0f) };
+    translation = residual * translation + zero; // + 0 as in Pose3D::conc, keeps signed zeros identical
+    rotation = residual * rotation;
+
+    // use cosine theorem and arctan to compute first three joints
+    const LegLanes length = sqrtLanes(dot(translation, translation));
+    const LegLanes sqrLength = length * length;
+    const float upperLeg = robotDimensions.upperLegLength;
+    const float sqrUpperLeg = upperLeg * upperLeg;
+    const float lowerLeg = robotDimensions.lowerLegLength;
+    const float sqrLowerLeg = lowerLeg * lowerLeg;
+    LegLanes cosUpperLeg = (splat(sqrUpperLeg) + sqrLength - splat(sqrLowerLeg)) / (splat(2 * upperLeg) * length);
+    LegLanes cosKnee = (splat(sqrUpperLeg + sqrLowerLeg) - sqrLength) / splat(2 * upperLeg * lowerLeg);
+    const LegLanes lengthYZ = sqrtLanes(translation.y * translation.y + translation.z * translation.z);
+
+    // the transcendental functions have no vector form, evaluate them per lane
+    const Range<float> clipping(-1.0f, 1.0f);
+    LegLanes joint1 = splat(0.0f), joint2 = splat(0.0f), joint3 = splat(0.0f);
+    for (int i = LANE_LEFT; i <= LANE_RIGHT; i++) {
+        // clip for the case that target position is not reachable
+        if(!clipping.isInside(cosKnee[i]))
+        {
+            cosKnee[i] = clipping.limit(cosKnee[i]);
+            cosUpperLeg[i] = clipping.limit(cosUpperLeg[i]);
+        }
+        joint1[i] = atan2f(translation.y[i], -translation.z[i]) * sign[i];
+        joint2[i] = -acosf(cosUpperLeg[i]);
+        joint2[i] -= atan2f(translation.x[i], lengthYZ[i]);
+        joint3[i] = M_PI - acosf(cosKnee[i]);
+    }
+
+    LaneRotation beforeFoot = identity();
+    cosSin(joint1 * sign, c, s);
+    rotateX(beforeFoot, c, s);
+    cosSin(joint2 + joint3, c, s);
+    rotateY(beforeFoot, c, s);
+
+    // only the z column of foot = beforeFoot.invert() * target.rotation is needed
+    const LaneVector3 footZ = { dot(beforeFoot.c[0], rotation.c[2]),
+                                dot(beforeFoot.c[1], rotation.c[2]),
+                                dot(beforeFoot.c[2], rotation.c[2])
+                              };
+
+    const Joint firstJoint[2] = { LHipYawPitch, RHipYawPitch };
+    for (int i = LANE_LEFT; i <= LANE_RIGHT; i++) {
+        float joint1Leg = joint1[i];
+        joint1Leg -= M_PI_4; // because of the strange hip of Nao
+        const float joint5 = asinf(-footZ.y[i]) * -sign[i] * -1;
+        const float joint4 = -atan2f(footZ.x[i], footZ.z[i]) * -1;
+
+        jointAngles[firstJoint[i] + 0] = joint0;
+        jointAngles[firstJoint[i] + 1] = joint1Leg;
+        jointAngles[firstJoint[i] + 2] = joint2[i];
+        jointAngles[firstJoint[i] + 3] = joint3[i];
+        jointAngles[firstJoint[i] + 4] = joint4;
+        jointAngles[firstJoint[i] + 5] = joint5;
+    }
+}
+
 bool InverseKinematics::calcArmJoints(const Pose3D &left, const Pose3D &right, Joints jointAngles, const RobotDimensions &theRobotDimensions)
 {
     const Vector3<float> leftDir = left.rotation * Vector3<float>(0,-1,0),
@@ -54,6 +54,19 @@ public:
     */
     static void calcLegJoints(const Pose3D& position, Joints jointAngles, float joint0, bool left, const RobotDimensions& robotDimensions);
 
+    /**
+    * Same as calcLegJoints with a fixed first joint, but solves the left and right leg together.
+    * The legs are mirror images of each other, so the linear algebra is done once with the
+    * left leg in lane 0 and the right leg in lane 1 of a 4-wide float vector (SSE/NEON).
+    * Results match two calls of the single leg version.
+    * @param positionLeft The desired position (translation + rotation) of the left foots ankle point
+    * @param positionRight The desired position (translation + rotation) of the right foots ankle point
+    * @param jointAngles The joint array where the resulting joints are written into
+    * @param joint0 Fixed value for joint0 of both legs
+    * @param robotDimensions The Robot Dimensions needed for calculation
+    */
+    static void calcLegJointsPair(const Pose3D& positionLeft, const Pose3D& positionRight, Joints jointAngles, float joint0, const RobotDimensions& robotDimensions);
+
     static bool calcArmJoints(const Pose3D &left, const Pose3D &right, Joints jointAngles, const RobotDimensions &theRobotDimensions);
 
     static bool calcArmJoints(Vector3<float> target, Vector3<float> targetDir, int side, Joints jointAngles, const RobotDimensions &theRobotDimensions);
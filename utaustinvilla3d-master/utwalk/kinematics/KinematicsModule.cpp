@@ -10,15 +10,15 @@
 KinematicsModule::~KinematicsModule() {};
 
 void KinematicsModule::specifyMemoryBlocks() {
-    requiresMemoryBlock("processed_sensors");
-    requiresMemoryBlock("processed_joint_angles");
-    requiresMemoryBlock("body_model");
+    requiresMemoryBlock(MB_PROCESSED_SENSORS);
+    requiresMemoryBlock(MB_PROCESSED_JOINT_ANGLES);
+    requiresMemoryBlock(MB_BODY_MODEL);
     //frame_info_ = (FrameInfo*)getMemoryBlock("frame_info");
 
-    getMemoryBlock(sensors_,"processed_sensors");
-    getMemoryBlock(joints_,"processed_joint_angles");
+    getMemoryBlock<MB_PROCESSED_SENSORS>(sensors_);
+    getMemoryBlock<MB_PROCESSED_JOINT_ANGLES>(joints_);
 
-    getMemoryBlock(body_model_,"body_model");
+    getMemoryBlock<MB_BODY_MODEL>(body_model_);
 }
 
 void KinematicsModule::calculatePose() {
@@ -15,6 +15,35 @@
 #include <boost/thread.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+static const char *memory_block_names[NUM_MEMORY_BLOCKS] = {
+    "frame_info",
+    "vision_frame_info",
+    "body_model",
+    "graphable",
+    "raw_joint_angles",
+    "processed_joint_angles",
+    "raw_joint_commands",
+    "processed_joint_commands",
+    "raw_sensors",
+    "processed_sensors",
+    "sim_effectors",
+    "walk_engine",
+    "walk_request",
+    "odometry"
+};
+
+const char* getMemoryBlockName(MemoryBlockID id) {
+    return memory_block_names[id];
+}
+
+MemoryBlockID getMemoryBlockID(const std::string &name) {
+    for (int i = 0; i < NUM_MEMORY_BLOCKS; i++) {
+        if (name == memory_block_names[i])
+            return MemoryBlockID(i);
+    }
+    return NUM_MEMORY_BLOCKS;
+}
+
 //void cleanLocks(){
 //cleanLock(LOCK_MOTION_NAME);
 //cleanLock(LOCK_VISION_NAME);
@@ -27,6 +56,8 @@ Memory::Memory(bool use_shared_memory, bool server):
     vision_lock_(NULL),
     vision_motion_lock_(NULL)
 {
+    for (int i = 0; i < NUM_MEMORY_BLOCKS; i++)
+        blocks_by_id_[i] = NULL;
     if (use_shared_memory_) {
         shared_memory_ = new SharedMemory(server);
         private_memory_ = NULL;
@@ -48,6 +79,8 @@ Memory::Memory(const Memory &old):
     }
     private_memory_ = new PrivateMemory(*old.private_memory_);
     shared_memory_ = NULL;
+    for (int i = 0; i < NUM_MEMORY_BLOCKS; i++)
+        blocks_by_id_[i] = old.blocks_by_id_[i];
 }
 
 Memory::~Memory() {
@@ -140,6 +173,17 @@ void Memory::setBlockLogging(const std::string &name, bool log_block) {
     getBlockPtr(name)->log_block = log_block;
 }
 
+void Memory::setBlockLogging(MemoryBlockID id, bool log_block) {
+    getBlockPtrById(id)->log_block = log_block;
+}
+
+MemoryBlock* Memory::getBlockPtrById(MemoryBlockID id) {
+    // with shared memory the block may have been added by another process
+    if (blocks_by_id_[id] == NULL)
+        blocks_by_id_[id] = getBlockPtr(getMemoryBlockName(id));
+    return blocks_by_id_[id];
+}
+
 MemoryBlock* Memory::getBlockPtrByName(const std::string &name) {
     return getBlockPtr(name);
 }
@@ -167,42 +211,63 @@ Lock& Memory::getLock(MemoryLockType lock_type) {
 }
 
 bool Memory::addBlockByName(const std::string &name) {
-    if (name == "frame_info")
-        return addBlock(name,new FrameInfoBlock(0,0,MEMORY_ROBOT));
-    if (name == "vision_frame_info")
-        return addBlock(name,new FrameInfoBlock(0,0,MEMORY_ROBOT));
-    else if (name == "body_model")
-        return addBlock(name,new BodyModelBlock());
-    else if (name == "graphable")
-        return addBlock(name,new GraphableBlock());
+    MemoryBlockID id = getMemoryBlockID(name);
+    if (id == NUM_MEMORY_BLOCKS) {
+        std::cerr << "Memory::addBlockByName: Error: Unknown memory block for name: " << name << std::endl << std::flush;
+        return false;
+    }
+    return addBlockById(id);
+}
+
+bool Memory::addBlockById(MemoryBlockID id) {
+    const std::string name = getMemoryBlockName(id);
+    bool res = false;
+    switch (id) {
+    case MB_FRAME_INFO:
+    case MB_VISION_FRAME_INFO:
+        res = addBlock(name,new FrameInfoBlock(0,0,MEMORY_ROBOT));
+        break;
+    case MB_BODY_MODEL:
+        res = addBlock(name,new BodyModelBlock());
+        break;
+    case MB_GRAPHABLE:
+        res = addBlock(name,new GraphableBlock());
+        break;
     // joints
-    else if (name == "raw_joint_angles")
-        return addBlock(name,new JointBlock());
-    else if (name == "processed_joint_angles")
-        return addBlock(name,new JointBlock());
+    case MB_RAW_JOINT_ANGLES:
+    case MB_PROCESSED_JOINT_ANGLES:
+        res = addBlock(name,new JointBlock());
+        break;
     // commands
-    else if (name == "raw_joint_commands")
-        return addBlock(name,new JointCommandBlock());
-    else if (name == "processed_joint_commands")
-        return addBlock(name,new JointCommandBlock());
+    case MB_RAW_JOINT_COMMANDS:
+    case MB_PROCESSED_JOINT_COMMANDS:
+        res = addBlock(name,new JointCommandBlock());
+        break;
     // sensors
-    else if (name == "raw_sensors")
-        return addBlock(name,new SensorBlock());
-    else if (name == "processed_sensors")
-        return addBlock(name,new SensorBlock());
+    case MB_RAW_SENSORS:
+    case MB_PROCESSED_SENSORS:
+        res = addBlock(name,new SensorBlock());
+        break;
     // Sim
-    else if (name == "sim_effectors")
-        return addBlock(name, new SimEffectorBlock());
+    case MB_SIM_EFFECTORS:
+        res = addBlock(name, new SimEffectorBlock());
+        break;
     // motion
-    else if (name == "walk_engine")
-        return addBlock(name,new WalkEngineBlock());
-    else if (name == "walk_request")
-        return addBlock(name,new WalkRequestBlock());
+    case MB_WALK_ENGINE:
+        res = addBlock(name,new WalkEngineBlock());
+        break;
+    case MB_WALK_REQUEST:
+        res = addBlock(name,new WalkRequestBlock());
+        break;
     // odometry for localization (includes kick, walk, fall info)
-    else if (name == "odometry")
-        return addBlock(name,new OdometryBlock());
-    else {
-        std::cerr << "Memory::addBlockByName: Error: Unknown memory block for name: " << name << std::endl << std::flush;
+    case MB_ODOMETRY:
+        res = addBlock(name,new OdometryBlock());
+        break;
+    default:
+        std::cerr << "Memory::addBlockById: Error: Unknown memory block id: " << id << std::endl << std::flush;
         return false;
     }
+    if (res)
+        blocks_by_id_[id] = getBlockPtr(name);
+    return res;
 }
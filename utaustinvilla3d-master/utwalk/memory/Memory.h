@@ -3,7 +3,10 @@
 
 #include <vector>
 #include <string>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
 #include "MemoryBlock.h"
+#include "MemoryBlockID.h"
 #include "SharedMemory.h"
 #include "PrivateMemory.h"
 #include "Lock.h"
@@ -31,10 +34,35 @@ public:
     ~Memory();
 
     void setBlockLogging(const std::string &name,bool log_block);
+    void setBlockLogging(MemoryBlockID id,bool log_block);
     MemoryBlock* getBlockPtrByName(const std::string &name);
     const MemoryBlock* getBlockPtrByName(const std::string &name) const;
     bool addBlockByName(const std::string &name);
 
+    MemoryBlock* getBlockPtrById(MemoryBlockID id);
+    bool addBlockById(MemoryBlockID id);
+
+    // Typed lookups by block id, e.g. getBlock<MB_FRAME_INFO>(frame_info_)
+    template <MemoryBlockID ID, class T>
+    void getBlock(T *&ptr) {
+        BOOST_STATIC_ASSERT((boost::is_same<T, typename MemoryBlockType<ID>::Type>::value));
+        ptr = (T*)(getBlockPtrById(ID));
+        if (ptr == NULL)
+            std::cerr << "Memory::getBlock: Error: couldn't get block for name " << getMemoryBlockName(ID) << std::endl;
+    }
+
+    template <MemoryBlockID ID, class T>
+    void getOrAddBlock(T *&ptr) {
+        if (getBlockPtrById(ID) == NULL) {
+            bool res = addBlockById(ID);
+            if (!res)
+                std::cerr << "Memory::getOrAddBlock: ERROR: failed to add block for name: " << getMemoryBlockName(ID) << std::endl;
+        }
+        getBlock<ID>(ptr);
+    }
+
+    // Lookups by block name, for logging and tools.  Prefer the typed
+    // lookups above in code that knows which block it wants.
     template <class T>
     void getBlockByName(T *&ptr, const std::string &name) {
         MemoryBlock *temp = getBlockPtr(name);
@@ -80,6 +108,9 @@ private:
     const MemoryBlock* getBlockPtr(const std::string &name) const;
 
 private:
+    // Blocks by id, filled in as blocks are added or first looked up
+    MemoryBlock *blocks_by_id_[NUM_MEMORY_BLOCKS];
+
     bool use_shared_memory_;
     SharedMemory *shared_memory_;
     PrivateMemory *private_memory_;
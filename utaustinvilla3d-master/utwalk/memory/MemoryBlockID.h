@@ -0,0 +1,74 @@
+#ifndef MEMORYBLOCKID_Q8TZ2WLA
+#define MEMORYBLOCKID_Q8TZ2WLA
+
+#include <string>
+
+// Every memory block Memory knows how to create.  Blocks are looked up by
+// these ids with an array index, the names are kept for logging, tools and
+// the shared memory map.
+enum MemoryBlockID {
+    MB_FRAME_INFO,
+    MB_VISION_FRAME_INFO,
+    MB_BODY_MODEL,
+    MB_GRAPHABLE,
+    // joints
+    MB_RAW_JOINT_ANGLES,
+    MB_PROCESSED_JOINT_ANGLES,
+    // commands
+    MB_RAW_JOINT_COMMANDS,
+    MB_PROCESSED_JOINT_COMMANDS,
+    // sensors
+    MB_RAW_SENSORS,
+    MB_PROCESSED_SENSORS,
+    // Sim
+    MB_SIM_EFFECTORS,
+    // motion
+    MB_WALK_ENGINE,
+    MB_WALK_REQUEST,
+    // odometry for localization (includes kick, walk, fall info)
+    MB_ODOMETRY,
+    NUM_MEMORY_BLOCKS
+};
+
+// Name of the block with the given id
+const char* getMemoryBlockName(MemoryBlockID id);
+
+// Id of the block with the given name, NUM_MEMORY_BLOCKS if there is none
+MemoryBlockID getMemoryBlockID(const std::string &name);
+
+struct FrameInfoBlock;
+struct BodyModelBlock;
+struct GraphableBlock;
+struct JointBlock;
+struct JointCommandBlock;
+struct SensorBlock;
+struct SimEffectorBlock;
+struct WalkEngineBlock;
+struct WalkRequestBlock;
+struct OdometryBlock;
+
+// Type of the block with a given id, so that typed lookups can be checked
+// at compile time
+template <MemoryBlockID ID> struct MemoryBlockType;
+
+#define MEMORY_BLOCK_TYPE(ID, T) \
+    template <> struct MemoryBlockType<ID> { typedef T Type; }
+
+MEMORY_BLOCK_TYPE(MB_FRAME_INFO, FrameInfoBlock);
+MEMORY_BLOCK_TYPE(MB_VISION_FRAME_INFO, FrameInfoBlock);
+MEMORY_BLOCK_TYPE(MB_BODY_MODEL, BodyModelBlock);
+MEMORY_BLOCK_TYPE(MB_GRAPHABLE, GraphableBlock);
+MEMORY_BLOCK_TYPE(MB_RAW_JOINT_ANGLES, JointBlock);
+MEMORY_BLOCK_TYPE(MB_PROCESSED_JOINT_ANGLES, JointBlock);
+MEMORY_BLOCK_TYPE(MB_RAW_JOINT_COMMANDS, JointCommandBlock);
+MEMORY_BLOCK_TYPE(MB_PROCESSED_JOINT_COMMANDS, JointCommandBlock);
+MEMORY_BLOCK_TYPE(MB_RAW_SENSORS, SensorBlock);
+MEMORY_BLOCK_TYPE(MB_PROCESSED_SENSORS, SensorBlock);
+MEMORY_BLOCK_TYPE(MB_SIM_EFFECTORS, SimEffectorBlock);
+MEMORY_BLOCK_TYPE(MB_WALK_ENGINE, WalkEngineBlock);
+MEMORY_BLOCK_TYPE(MB_WALK_REQUEST, WalkRequestBlock);
+MEMORY_BLOCK_TYPE(MB_ODOMETRY, OdometryBlock);
+
+#undef MEMORY_BLOCK_TYPE
+
+#endif /* end of include guard: MEMORYBLOCKID_Q8TZ2WLA */
@@ -0,0 +1,135 @@
+#include "RingLogger.h"
+#include "Memory.h"
+
+#include <iostream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Ask the kernel to start writing back dirty pages every this many frames
+#define RING_LOG_FLUSH_INTERVAL 100
+
+// Keep every block in a record 8 byte aligned
+static unsigned int alignRecordOffset(unsigned int offset) {
+    return (offset + 7) & ~7u;
+}
+
+RingLogger::RingLogger(const char filename[], unsigned int num_records):
+    filename_(filename),
+    num_records_(num_records),
+    stopped_(false),
+    fd_(-1),
+    map_(NULL),
+    map_size_(0),
+    record_size_(0),
+    records_offset_(0),
+    sequence_(0)
+{
+    if (num_records_ == 0) {
+        std::cerr << "RingLogger: ERROR: ring log " << filename_ << " needs at least one record" << std::endl;
+        stopped_ = true;
+    }
+}
+
+RingLogger::~RingLogger() {
+    close();
+}
+
+bool RingLogger::open(Memory &memory) {
+    std::vector<std::string> names;
+    memory.getBlockNames(names,true);
+
+    std::vector<RingLogBlockEntry> entries;
+    unsigned int offset = alignRecordOffset(sizeof(RingLogRecordHeader));
+    for (unsigned int i = 0; i < names.size(); i++) {
+        MemoryBlockID id = getMemoryBlockID(names[i]);
+        if (id == NUM_MEMORY_BLOCKS || names[i].size() >= sizeof(RingLogBlockEntry().name)) {
+            std::cerr << "RingLogger: ERROR: can't log block " << names[i] << std::endl;
+            continue;
+        }
+        const MemoryBlock *block = memory.getBlockPtrById(id);
+
+        RingLogBlockEntry entry;
+        memset(&entry,0,sizeof(entry));
+        strncpy(entry.name,names[i].c_str(),sizeof(entry.name)-1);
+        entry.version = block->header.version;
+        entry.size = block->header.size;
+        entry.offset = offset;
+        entries.push_back(entry);
+
+        blocks_.push_back(block);
+        offsets_.push_back(offset);
+        offset = alignRecordOffset(offset + entry.size);
+    }
+    record_size_ = offset;
+
+    RingLogHeader header;
+    memset(&header,0,sizeof(header));
+    strncpy(header.magic,RING_LOG_MAGIC,sizeof(header.magic));
+    header.format_version = RING_LOG_FORMAT_VERSION;
+    header.num_blocks = entries.size();
+    header.record_size = record_size_;
+    header.num_records = num_records_;
+    header.records_offset = alignRecordOffset(sizeof(header) + entries.size() * sizeof(RingLogBlockEntry));
+    records_offset_ = header.records_offset;
+
+    map_size_ = (size_t)records_offset_ + (size_t)record_size_ * num_records_;
+    fd_ = ::open(filename_.c_str(),O_RDWR | O_CREAT | O_TRUNC,0644);
+    if (fd_ < 0 || ftruncate(fd_,map_size_) != 0) {
+        std::cerr << "RingLogger: ERROR: couldn't create ring log " << filename_ << std::endl;
+        return false;
+    }
+    void *map = mmap(NULL,map_size_,PROT_READ | PROT_WRITE,MAP_SHARED,fd_,0);
+    if (map == MAP_FAILED) {
+        std::cerr << "RingLogger: ERROR: couldn't map ring log " << filename_ << std::endl;
+        return false;
+    }
+    map_ = (char*)map;
+
+    // The file was just truncated, so all records already read as empty
+    memcpy(map_,&header,sizeof(header));
+    if (!entries.empty())
+        memcpy(map_ + sizeof(header),&entries[0],entries.size() * sizeof(RingLogBlockEntry));
+    return true;
+}
+
+void RingLogger::writeMemory(Memory &memory) {
+    if (map_ == NULL) {
+        if (stopped_)
+            return;
+        if (!open(memory)) {
+            close();
+            return;
+        }
+    }
+
+    sequence_++;
+    char *record = map_ + records_offset_ + (size_t)record_size_ * ((sequence_ - 1) % num_records_);
+    RingLogRecordHeader *record_header = (RingLogRecordHeader*)record;
+
+    // Mark the record as being written first, so that a reader of a log
+    // cut off in the middle of a frame skips it
+    record_header->sequence = 0;
+    __sync_synchronize();
+    for (unsigned int i = 0; i < blocks_.size(); i++)
+        memcpy(record + offsets_[i],(const void*)blocks_[i],blocks_[i]->header.size);
+    __sync_synchronize();
+    record_header->sequence = sequence_;
+
+    if (sequence_ % RING_LOG_FLUSH_INTERVAL == 0)
+        msync(map_,map_size_,MS_ASYNC);
+}
+
+void RingLogger::close() {
+    stopped_ = true;
+    if (map_ != NULL) {
+        msync(map_,map_size_,MS_ASYNC);
+        munmap(map_,map_size_);
+        map_ = NULL;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
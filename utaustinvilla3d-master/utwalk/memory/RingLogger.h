@@ -0,0 +1,74 @@
+#ifndef RINGLOGGER_W5XK2N0D
+#define RINGLOGGER_W5XK2N0D
+
+#include <string>
+#include <vector>
+#include "MemoryBlock.h"
+
+class Memory;
+
+// On disk layout of a ring log:
+//   RingLogHeader
+//   RingLogBlockEntry[num_blocks]
+//   num_records records of record_size bytes starting at records_offset,
+//   each a RingLogRecordHeader followed by every logged block at the
+//   offset given for it in the block table
+#define RING_LOG_MAGIC "UTRLOG"
+#define RING_LOG_FORMAT_VERSION 1
+
+struct RingLogHeader {
+    char magic[8];
+    unsigned int format_version;
+    unsigned int num_blocks;
+    unsigned int record_size;
+    unsigned int num_records;
+    unsigned int records_offset;
+};
+
+struct RingLogBlockEntry {
+    char name[32];
+    unsigned int version;
+    unsigned int size;
+    unsigned int offset; // from the start of a record
+};
+
+struct RingLogRecordHeader {
+    // Increases by one every frame starting from 1, 0 while the record is
+    // empty or being written
+    unsigned long long sequence;
+};
+
+/*
+ * Logs a snapshot of all memory blocks marked for logging every frame into
+ * a fixed size file mapped into memory, overwriting the oldest frame once
+ * the file is full.  The block table is written once when the first frame
+ * is logged, after that a frame is one memcpy per block and the kernel
+ * writes the pages back to disk in the background.
+ */
+class RingLogger {
+public:
+    RingLogger(const char filename[], unsigned int num_records);
+    virtual ~RingLogger();
+
+    void writeMemory(Memory &memory);
+    void close();
+
+private:
+    bool open(Memory &memory);
+
+    std::string filename_;
+    unsigned int num_records_;
+    bool stopped_;
+
+    int fd_;
+    char *map_;
+    size_t map_size_;
+    unsigned int record_size_;
+    unsigned int records_offset_;
+    unsigned long long sequence_;
+
+    std::vector<const MemoryBlock*> blocks_;
+    std::vector<unsigned int> offsets_;
+};
+
+#endif /* end of include guard: RINGLOGGER_W5XK2N0D */
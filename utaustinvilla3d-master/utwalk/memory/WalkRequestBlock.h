@@ -17,7 +17,8 @@ public:
         PARAMS_NONE,
         PARAMS_DEFAULT,
         PARAMS_POSITIONING,
-        PARAMS_APPROACH_BALL
+        PARAMS_APPROACH_BALL,
+        NUM_PARAM_SETS
     };
 
     WalkRequestBlock():
@@ -5,23 +5,42 @@
 MotionModule::~MotionModule() {};
 
 void MotionModule::specifyMemoryBlocks() {
-    requiresMemoryBlock("body_model");
-    requiresMemoryBlock("processed_joint_angles");
-    requiresMemoryBlock("processed_joint_commands");
-    requiresMemoryBlock("processed_sensors");
-    requiresMemoryBlock("walk_request");
+    requiresMemoryBlock(MB_BODY_MODEL);
+    requiresMemoryBlock(MB_PROCESSED_JOINT_ANGLES);
+    requiresMemoryBlock(MB_PROCESSED_JOINT_COMMANDS);
+    requiresMemoryBlock(MB_PROCESSED_SENSORS);
+    requiresMemoryBlock(MB_WALK_REQUEST);
 
 
-    getMemoryBlock(body_model_,"body_model");
-    getMemoryBlock(joint_angles_,"processed_joint_angles");
-    getMemoryBlock(commands_,"processed_joint_commands");
-    getMemoryBlock(sensors_,"processed_sensors");
-    getMemoryBlock(walk_request_,"walk_request");
+    getMemoryBlock<MB_BODY_MODEL>(body_model_);
+    getMemoryBlock<MB_PROCESSED_JOINT_ANGLES>(joint_angles_);
+    getMemoryBlock<MB_PROCESSED_JOINT_COMMANDS>(commands_);
+    getMemoryBlock<MB_PROCESSED_SENSORS>(sensors_);
+    getMemoryBlock<MB_WALK_REQUEST>(walk_request_);
 
     ut_walk_engine_.init(memory_);
+    publishWalkStatus();
 }
 
 void MotionModule::processFrame() {
     ut_walk_engine_.processFrame();
+    publishWalkStatus();
+}
+
+void MotionModule::reloadParameters() {
+    ut_walk_engine_.reloadParameters();
+    publishWalkStatus();
+}
+
+void MotionModule::publishWalkStatus() {
+    WalkStatus &status = walk_status_.writeBuffer();
+    status.maxXSpeed = ut_walk_engine_.getMaxXSpeed();
+    status.maxYSpeed = ut_walk_engine_.getMaxYSpeed();
+    status.maxRotSpeed = ut_walk_engine_.getMaxRotSpeed();
+    status.stepSizeTranslationX = ut_walk_engine_.getStepSizeTranslationX();
+    status.stepSizeTranslationY = ut_walk_engine_.getStepSizeTranslationY();
+    status.stepSizeRotation = ut_walk_engine_.getStepSizeRotation();
+    status.phaseLength = ut_walk_engine_.getPhaseLength();
+    walk_status_.publish();
 }
 
@@ -9,6 +9,7 @@
 #include <memory/SensorBlock.h>
 #include <memory/WalkRequestBlock.h>
 #include <motion/UTWalkEngine.h>
+#include <common/TripleBuffer.h>
 
 
 class MotionModule: public Module {
@@ -19,27 +20,48 @@ public:
 
     void processFrame();
 
+    // Rebuilds the walk parameter sets after the parameters were reloaded
+    void reloadParameters();
+
+    // Walk engine limits and step sizes as of the end of the last motion
+    // frame.  These are read through a snapshot so that behaviors running
+    // on another thread than the motion core never see a half updated walk.
+    struct WalkStatus {
+        double maxXSpeed;
+        double maxYSpeed;
+        double maxRotSpeed;
+        double stepSizeTranslationX;
+        double stepSizeTranslationY;
+        double stepSizeRotation;
+        double phaseLength;
+    };
+
+    inline const WalkStatus& getWalkStatus() {
+        walk_status_.update();
+        return walk_status_.readBuffer();
+    }
+
     inline double getMaxXSpeed()   {
-        return ut_walk_engine_.getMaxXSpeed();
+        return getWalkStatus().maxXSpeed;
     }
     inline double getMaxYSpeed()   {
-        return ut_walk_engine_.getMaxYSpeed();
+        return getWalkStatus().maxYSpeed;
     }
     inline double getMaxRotSpeed() {
-        return ut_walk_engine_.getMaxRotSpeed();
+        return getWalkStatus().maxRotSpeed;
     }
 
     inline double getStepSizeTranslationX() {
-        return ut_walk_engine_.getStepSizeTranslationX();
+        return getWalkStatus().stepSizeTranslationX;
     }
     inline double getStepSizeTranslationY() {
-        return ut_walk_engine_.getStepSizeTranslationY();
+        return getWalkStatus().stepSizeTranslationY;
     }
     inline double getStepSizeRotation() {
-        return ut_walk_engine_.getStepSizeRotation();
+        return getWalkStatus().stepSizeRotation;
     }
     inline double getPhaseLength() {
-        return ut_walk_engine_.getPhaseLength();
+        return getWalkStatus().phaseLength;
     }
 
 private:
@@ -50,6 +72,9 @@ private:
     WalkRequestBlock *walk_request_;
 
     UTWalkEngine ut_walk_engine_;;
+    TripleBuffer<WalkStatus> walk_status_;
+
+    void publishWalkStatus();
 };
 
 #endif /* end of include guard: SENSOR_MODULE */
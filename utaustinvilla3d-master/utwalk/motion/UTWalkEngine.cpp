@@ -2,31 +2,78 @@
 
 #include <kinematics/ForwardKinematics.h>
 #include <math/Geometry.h>
+#include <common/ParamRegistry.h>
 
 extern int agentBodyType;
 
-UTWalkEngine::UTWalkEngine()
+UTWalkEngine::UTWalkEngine():
+    current_param_set_(WalkRequestBlock::PARAMS_NONE),
+    param_transition_steps_(0),
+    blend_step_(0),
+    blend_target_(NULL),
+    blend_start_(NULL),
+    blend_params_(NULL)
 {
-    paramSets[WalkRequestBlock::PARAMS_DEFAULT] = WalkEngineParameters();
-    paramSets[WalkRequestBlock::PARAMS_POSITIONING] = WalkEngineParameters("pos_");
-    paramSets[WalkRequestBlock::PARAMS_APPROACH_BALL] = WalkEngineParameters("app_");
+    paramSets_[WalkRequestBlock::PARAMS_NONE] = NULL;
+    paramSets_[WalkRequestBlock::PARAMS_DEFAULT] = new WalkEngineParameters();
+    paramSets_[WalkRequestBlock::PARAMS_POSITIONING] = new WalkEngineParameters("pos_");
+    paramSets_[WalkRequestBlock::PARAMS_APPROACH_BALL] = new WalkEngineParameters("app_");
+    params_ = paramSets_[WalkRequestBlock::PARAMS_DEFAULT];
+    frame_info_ = NULL;
+
+    // Optional: number of steps over which to blend when switching parameter sets
+    param_transition_steps_ = getParams().get("utwalk_param_transition_steps", param_transition_steps_);
 }
 
 UTWalkEngine::~UTWalkEngine() {
+    for (int i = 0; i < WalkRequestBlock::NUM_PARAM_SETS; i++)
+        delete paramSets_[i];
+    delete blend_start_;
+    delete blend_params_;
 }
 
 void UTWalkEngine::init(Memory *mem) {
-    mem->getBlockByName(body_model_,"body_model");
-    mem->getBlockByName(frame_info_,"frame_info");
-    mem->getBlockByName(graph_,"graphable");
-    mem->getBlockByName(commands_,"processed_joint_commands");
-    mem->getBlockByName(joint_angles_,"processed_joint_angles");
-    mem->getBlockByName(sensors_,"processed_sensors");
-    mem->getBlockByName(walk_engine_,"walk_engine");
-    mem->getBlockByName(walk_request_,"walk_request");
+    mem->getBlock<MB_BODY_MODEL>(body_model_);
+    mem->getBlock<MB_FRAME_INFO>(frame_info_);
+    mem->getBlock<MB_GRAPHABLE>(graph_);
+    mem->getBlock<MB_PROCESSED_JOINT_COMMANDS>(commands_);
+    mem->getBlock<MB_PROCESSED_JOINT_ANGLES>(joint_angles_);
+    mem->getBlock<MB_PROCESSED_SENSORS>(sensors_);
+    mem->getBlock<MB_WALK_ENGINE>(walk_engine_);
+    mem->getBlock<MB_WALK_REQUEST>(walk_request_);
 
     last_time_ = frame_info_->seconds_since_start;
 
+    loadParameterSets();
+    setWalkParameters(WalkRequestBlock::PARAMS_DEFAULT);
+
+    initWalk();
+}
+
+void UTWalkEngine::loadParameterSets() {
+    // The sets are overwritten in place so that params_ and blend_target_
+    // never dangle
+    *paramSets_[WalkRequestBlock::PARAMS_DEFAULT] = WalkEngineParameters();
+    *paramSets_[WalkRequestBlock::PARAMS_POSITIONING] = WalkEngineParameters("pos_");
+    *paramSets_[WalkRequestBlock::PARAMS_APPROACH_BALL] = WalkEngineParameters("app_");
+
+    if (frame_info_ != NULL && frame_info_->source == MEMORY_SIM) {
+        for (int i = 0; i < WalkRequestBlock::NUM_PARAM_SETS; i++) {
+            if (paramSets_[i] == NULL)
+                continue;
+            //paramSets_[i]->com_measurement_delay_ = 0.08; // in seconds
+            paramSets_[i]->correction_fwd_.rotation = DEG_T_RAD * 0;
+        }
+    }
+}
+
+void UTWalkEngine::reloadParameters() {
+    loadParameterSets();
+    param_transition_steps_ = getParams().get("utwalk_param_transition_steps", 0);
+
+    // Start over from the default set without blending
+    blend_target_ = NULL;
+    current_param_set_ = WalkRequestBlock::PARAMS_NONE;
     setWalkParameters(WalkRequestBlock::PARAMS_DEFAULT);
 
     initWalk();
@@ -52,41 +99,59 @@ void UTWalkEngine::setWalkParameters(WalkRequestBlock::ParamSet paramSet)
      * optimiztion.
      */
 
-    static WalkRequestBlock::ParamSet last_param_set = WalkRequestBlock::PARAMS_NONE;
-
-    if (paramSet == WalkRequestBlock::PARAMS_NONE)
+    if (paramSet == WalkRequestBlock::PARAMS_NONE || paramSet == current_param_set_)
         return;
 
-    if (last_param_set != paramSet)
-    {
-        setWalkParameters(paramSets[paramSet]);
-        last_param_set = paramSet;
+    const WalkEngineParameters *target = paramSets_[paramSet];
+    if (param_transition_steps_ <= 1 || current_param_set_ == WalkRequestBlock::PARAMS_NONE) {
+        // plain switch, no blending
+        blend_target_ = NULL;
+        setWalkParameters(target);
+    } else {
+        // blend from wherever we are now (possibly mid-transition) to the target
+        if (blend_start_ == NULL) {
+            blend_start_ = new WalkEngineParameters(*params_);
+            blend_params_ = new WalkEngineParameters(*params_);
+        } else {
+            *blend_start_ = *params_;
+        }
+        blend_target_ = target;
+        blend_step_ = 0;
+        advanceParamBlend();
     }
+    current_param_set_ = paramSet;
 }
 
-void UTWalkEngine::setWalkParameters(const WalkEngineParameters &params) {
-    params_ = params;
-
-    if (frame_info_->source == MEMORY_SIM) {
-        //params_.com_measurement_delay_ = 0.08; // in seconds
-        params_.correction_fwd_.rotation = DEG_T_RAD * 0;
+void UTWalkEngine::advanceParamBlend() {
+    blend_step_++;
+    if (blend_step_ >= param_transition_steps_) {
+        setWalkParameters(blend_target_);
+        blend_target_ = NULL;
+        return;
     }
 
-    walk_engine_->phase_length_ = params_.phase_length_;
+    WalkEngineParameters::interpolate(*blend_start_, *blend_target_, float(blend_step_) / param_transition_steps_, *blend_params_);
+    setWalkParameters(blend_params_);
+}
+
+void UTWalkEngine::setWalkParameters(const WalkEngineParameters *params) {
+    params_ = params;
+
+    walk_engine_->phase_length_ = params_->phase_length_;
     // tilt pids
-    pid_tilt_.setParams(params_.pid_tilt_);
-    pid_roll_.setParams(params_.pid_roll_);
+    pid_tilt_.setParams(params_->pid_tilt_);
+    pid_roll_.setParams(params_->pid_roll_);
     // com pids
-    pid_com_x_.setParams(params_.pid_com_x_);
-    pid_com_y_.setParams(params_.pid_com_y_);
-    pid_com_z_.setParams(params_.pid_com_z_);
+    pid_com_x_.setParams(params_->pid_com_x_);
+    pid_com_y_.setParams(params_->pid_com_y_);
+    pid_com_z_.setParams(params_->pid_com_z_);
     // arm pids
-    pid_arm_x_.setParams(params_.pid_arm_x_);
-    pid_arm_y_.setParams(params_.pid_arm_y_);
+    pid_arm_x_.setParams(params_->pid_arm_x_);
+    pid_arm_y_.setParams(params_->pid_arm_y_);
     // step pids
-    pid_step_size_x_.setParams(params_.pid_step_size_x_);
-    pid_step_size_y_.setParams(params_.pid_step_size_y_);
-    pid_step_size_rot_.setParams(params_.pid_step_size_rot_);
+    pid_step_size_x_.setParams(params_->pid_step_size_x_);
+    pid_step_size_y_.setParams(params_->pid_step_size_y_);
+    pid_step_size_rot_.setParams(params_->pid_step_size_rot_);
 }
 
 void UTWalkEngine::processFrame() {
@@ -157,7 +222,7 @@ void UTWalkEngine::calcDesiredCOM() {
     float groin;
 
     // convert the time using the measurement delay
-    float t = walk_engine_->phase_frac_ - params_.com_measurement_delay_ / walk_engine_->phase_length_;  // divison to convert from time to phase time
+    float t = walk_engine_->phase_frac_ - params_->com_measurement_delay_ / walk_engine_->phase_length_;  // divison to convert from time to phase time
     bool left_swing = walk_engine_->left_swing_;
 
     if (t < phase_start_) {
@@ -167,8 +232,8 @@ void UTWalkEngine::calcDesiredCOM() {
 
     // calculate the joint targets
     calcFeetTargets(left_target,right_target,groin,t,left_swing,walk_engine_->step_size_); // TODO step size needs to change?
-    //commandLegsRelativeToTorso(angles,left_target,right_target,groin,0,0,Vector3<float>(0,0,0),false);//params_.default_com_pos_,false);
-    commandLegsRelativeToTorso(angles,left_target,right_target,groin,0,0,params_.default_com_pos_,false);
+    //commandLegsRelativeToTorso(angles,left_target,right_target,groin,0,0,Vector3<float>(0,0,0),false);//params_->default_com_pos_,false);
+    commandLegsRelativeToTorso(angles,left_target,right_target,groin,0,0,params_->default_com_pos_,false);
     setArms(angles,Vector2<float>(0,0));
     setHead(angles);
 
@@ -212,9 +277,9 @@ void UTWalkEngine::calcDesiredCOM() {
 void UTWalkEngine::processWalkRequest() {
     if (walk_request_->percentage_speed_) {
         // convert from percentage speeds to step sizes
-        walk_engine_->step_size_.translation.x = walk_request_->speed_.translation.x * params_.max_step_size_.translation.x;
-        walk_engine_->step_size_.translation.y = walk_request_->speed_.translation.y * params_.max_step_size_.translation.y;
-        walk_engine_->step_size_.rotation = walk_request_->speed_.rotation * params_.max_step_size_.rotation;
+        walk_engine_->step_size_.translation.x = walk_request_->speed_.translation.x * params_->max_step_size_.translation.x;
+        walk_engine_->step_size_.translation.y = walk_request_->speed_.translation.y * params_->max_step_size_.translation.y;
+        walk_engine_->step_size_.rotation = walk_request_->speed_.rotation * params_->max_step_size_.rotation;
     } else {
         // convert from speeds to step sizes
         walk_engine_->step_size_.translation.x = walk_request_->speed_.translation.x / walk_engine_->phase_length_;
@@ -224,8 +289,8 @@ void UTWalkEngine::processWalkRequest() {
 
     // if the avg com error is too high, reduce the step size
     Vector3<float> avg_com_error_ = com_errors_.getAverage();
-    float x_error_frac = (fabs(avg_com_error_.x) - params_.max_normal_com_error_.x) / (params_.max_acceptable_com_error_.x - params_.max_normal_com_error_.x);
-    float y_error_frac = (fabs(avg_com_error_.y) - params_.max_normal_com_error_.y) / (params_.max_acceptable_com_error_.y - params_.max_normal_com_error_.y);
+    float x_error_frac = (fabs(avg_com_error_.x) - params_->max_normal_com_error_.x) / (params_->max_acceptable_com_error_.x - params_->max_normal_com_error_.x);
+    float y_error_frac = (fabs(avg_com_error_.y) - params_->max_normal_com_error_.y) / (params_->max_acceptable_com_error_.y - params_->max_normal_com_error_.y);
     float error_frac = max(x_error_frac,y_error_frac);
     error_frac = max(0.0,error_frac); // never less than 0
     error_frac = min(1.0,error_frac); // never greater than 1.0
@@ -245,17 +310,17 @@ void UTWalkEngine::processWalkRequest() {
 
 
     // crop the step sizes to the maximums
-    walk_engine_->step_size_.translation.x = crop(walk_engine_->step_size_.translation.x,-params_.max_step_size_.translation.x,params_.max_step_size_.translation.x);
-    walk_engine_->step_size_.translation.y = crop(walk_engine_->step_size_.translation.y,-params_.max_step_size_.translation.y,params_.max_step_size_.translation.y);
-    walk_engine_->step_size_.rotation = crop(walk_engine_->step_size_.rotation,-params_.max_step_size_.rotation,params_.max_step_size_.rotation);
+    walk_engine_->step_size_.translation.x = crop(walk_engine_->step_size_.translation.x,-params_->max_step_size_.translation.x,params_->max_step_size_.translation.x);
+    walk_engine_->step_size_.translation.y = crop(walk_engine_->step_size_.translation.y,-params_->max_step_size_.translation.y,params_->max_step_size_.translation.y);
+    walk_engine_->step_size_.rotation = crop(walk_engine_->step_size_.rotation,-params_->max_step_size_.rotation,params_->max_step_size_.rotation);
 
     walk_engine_->last_step_size_ = walk_engine_->step_size_;
 
     // apply a correction to the walk based on drift
-    float fwd_frac = walk_engine_->step_size_.translation.x / params_.max_step_size_.translation.x;
-    walk_engine_->step_size_.translation.x += fwd_frac * params_.correction_fwd_.translation.x;
-    walk_engine_->step_size_.translation.y += fwd_frac * params_.correction_fwd_.translation.y;
-    walk_engine_->step_size_.rotation += fwd_frac * params_.correction_fwd_.rotation;
+    float fwd_frac = walk_engine_->step_size_.translation.x / params_->max_step_size_.translation.x;
+    walk_engine_->step_size_.translation.x += fwd_frac * params_->correction_fwd_.translation.x;
+    walk_engine_->step_size_.translation.y += fwd_frac * params_->correction_fwd_.translation.y;
+    walk_engine_->step_size_.rotation += fwd_frac * params_->correction_fwd_.rotation;
 }
 
 void UTWalkEngine::initStiffness() {
@@ -294,8 +359,7 @@ void UTWalkEngine::commandLegsRelativeToTorso(float *command_angles, Pose3D left
     }
     ///////////////////////////////////////////
 
-    inverse_kinematics_.calcLegJoints(left_target,command_angles,groin,true,robot_dimensions_);
-    inverse_kinematics_.calcLegJoints(right_target,command_angles,groin,false,robot_dimensions_);
+    inverse_kinematics_.calcLegJointsPair(left_target,right_target,command_angles,groin,robot_dimensions_);
     command_angles[LHipYawPitch] = groin;
     command_angles[RHipYawPitch] = groin;
 
@@ -309,7 +373,7 @@ void UTWalkEngine::stand() {
         initStiffness();
     }
 
-    commandLegsRelativeToTorso(commands_->angles_,Pose3D(0,params_.foot_separation_ * 0.5,-params_.walk_height_),Pose3D(0,-params_.foot_separation_ * 0.5,-params_.walk_height_),0,tilt_offset_,roll_offset_,com_offset_,true);
+    commandLegsRelativeToTorso(commands_->angles_,Pose3D(0,params_->foot_separation_ * 0.5,-params_->walk_height_),Pose3D(0,-params_->foot_separation_ * 0.5,-params_->walk_height_),0,tilt_offset_,roll_offset_,com_offset_,true);
 
     setArms(commands_->angles_,arm_offset_);
     setHead(commands_->angles_);
@@ -335,12 +399,15 @@ void UTWalkEngine::initWalk() {
 void UTWalkEngine::switchPhase() {
     resetTime();
     walk_engine_->left_swing_ = !walk_engine_->left_swing_;
+
+    if (blend_target_ != NULL)
+        advanceParamBlend();
 }
 
 void UTWalkEngine::resetTime() {
-    double inner = 6 - cosh(params_.k_ * walk_engine_->phase_frac_ * 0.5);
+    double inner = 6 - cosh(params_->k_ * walk_engine_->phase_frac_ * 0.5);
     if (inner >= 1.0)
-        phase_start_ = acosh(inner) / (params_.k_ * 0.5);
+        phase_start_ = acosh(inner) / (params_->k_ * 0.5);
     else
         phase_start_ = 0.5;
     phase_start_ = -fabs(phase_start_);
@@ -351,10 +418,10 @@ void UTWalkEngine::resetTime() {
 
 float UTWalkEngine::calcOffsetFracTowards(float t, bool towards_swing) {
     if (towards_swing) {
-        if (t + 0.5 < params_.fraction_still_)
+        if (t + 0.5 < params_->fraction_still_)
             return 0;
-        else if (t + 0.5 < params_.fraction_still_ + params_.fraction_moving_)
-            return 0.5 * (1.0 + cos(M_PI * (t - params_.fraction_still_) / params_.fraction_moving_));
+        else if (t + 0.5 < params_->fraction_still_ + params_->fraction_moving_)
+            return 0.5 * (1.0 + cos(M_PI * (t - params_->fraction_still_) / params_->fraction_moving_));
         else
             return 1;
     } else {
@@ -367,10 +434,10 @@ float UTWalkEngine::calcOffsetFracTowards(float t, bool towards_swing) {
 
 float UTWalkEngine::calcOffsetFracAway(float t, bool away_swing) {
     if (away_swing) {
-        if (t + 0.5 < params_.fraction_still_)
+        if (t + 0.5 < params_->fraction_still_)
             return -1;
-        else if (t + 0.5 < params_.fraction_still_ + params_.fraction_moving_)
-            return 0.5 * (-1.0 + cos(M_PI * (t - params_.fraction_still_) / params_.fraction_moving_));
+        else if (t + 0.5 < params_->fraction_still_ + params_->fraction_moving_)
+            return 0.5 * (-1.0 + cos(M_PI * (t - params_->fraction_still_) / params_->fraction_moving_));
         else
             return 0;
     } else {
@@ -390,7 +457,7 @@ float UTWalkEngine::calcLeftSide(float t, bool left_swing, float step_side_size)
     if (left_swing)
         val = feetSeparation + calcRightSide(t,left_swing,step_side_size);
     else
-        val = feetSeparation/2.0 + params_.shift_amount_ * calcShiftFrac(t);
+        val = feetSeparation/2.0 + params_->shift_amount_ * calcShiftFrac(t);
     if (step_side_size > 0)
         val += step_side_size * calcOffsetFracTowards(t,left_swing);
     else
@@ -405,7 +472,7 @@ float UTWalkEngine::calcRightSide(float t, bool left_swing, float step_side_size
         feetSeparation = 75;
     }
     if (left_swing)
-        val = -feetSeparation/2.0 - params_.shift_amount_ * calcShiftFrac(t);
+        val = -feetSeparation/2.0 - params_->shift_amount_ * calcShiftFrac(t);
     else
         val = calcLeftSide(t,left_swing,step_side_size) - feetSeparation;
     if (step_side_size > 0)
@@ -416,7 +483,7 @@ float UTWalkEngine::calcRightSide(float t, bool left_swing, float step_side_size
 }
 
 void UTWalkEngine::calcFeetTargets(Pose3D &left_target, Pose3D &right_target, float &groin, float t, bool left_swing, const Pose2D &step_size) {
-    float step_height = params_.step_height_ * calcHeightFrac(t);
+    float step_height = params_->step_height_ * calcHeightFrac(t);
 
     float left = calcLeftSide(t,left_swing,step_size.translation.y);
     float right = calcRightSide(t,left_swing,step_size.translation.y);
@@ -425,7 +492,7 @@ void UTWalkEngine::calcFeetTargets(Pose3D &left_target, Pose3D &right_target, fl
     float stance_step_fwd;
     float swing_step_fwd;
     calcFwdFracs(t,stance_step_fwd,swing_step_fwd);
-    float fwd_offset =  params_.fwd_offset_ - step_size.translation.x * params_.fwd_offset_factor_; // TODO fix this better?
+    float fwd_offset =  params_->fwd_offset_ - step_size.translation.x * params_->fwd_offset_factor_; // TODO fix this better?
 
     groin = calcGroinAngle(t,left_swing,step_size.rotation);
 
@@ -441,12 +508,12 @@ void UTWalkEngine::calcFeetTargets(Pose3D &left_target, Pose3D &right_target, fl
 
     swing_target->translation.x = swing_step_fwd * step_size.translation.x + fwd_offset;
     stance_target->translation.x = stance_step_fwd * step_size.translation.x + fwd_offset;
-    swing_target->translation.z = step_height - params_.walk_height_;
-    stance_target->translation.z = -params_.walk_height_;
+    swing_target->translation.z = step_height - params_->walk_height_;
+    stance_target->translation.z = -params_->walk_height_;
 
 
     // add an angle offset to the swing foot, to make sure it does not hit toe first
-    float swing_ankle = params_.swing_ankle_offset_ * calcSwingAnkleFrac(t);
+    float swing_ankle = params_->swing_ankle_offset_ * calcSwingAnkleFrac(t);
     swing_target->rotation.rotateY(swing_ankle);
 }
 
@@ -474,11 +541,11 @@ void UTWalkEngine::walk() {
     float t = walk_engine_->phase_frac_;
     if (walk_engine_->left_swing_)
         t += 1.0;
-    commands_->angles_[LToePitch] = params_.toeConstOffset + params_.toeAmplitude * cos(M_PI * (t + params_.toePhaseOffset));
-    commands_->angles_[RToePitch] = params_.toeConstOffset + params_.toeAmplitude * cos(M_PI * (t + 1.0 + params_.toePhaseOffset));
+    commands_->angles_[LToePitch] = params_->toeConstOffset + params_->toeAmplitude * cos(M_PI * (t + params_->toePhaseOffset));
+    commands_->angles_[RToePitch] = params_->toeConstOffset + params_->toeAmplitude * cos(M_PI * (t + 1.0 + params_->toePhaseOffset));
     // ankles to counterbalance toes
-    commands_->angles_[LAnklePitch] += params_.ankleConstOffset + params_.ankleAmplitude * cos(M_PI * (t + params_.anklePhaseOffset));
-    commands_->angles_[RAnklePitch] += params_.ankleConstOffset + params_.ankleAmplitude * cos(M_PI * (t + 1.0 + params_.anklePhaseOffset));
+    commands_->angles_[LAnklePitch] += params_->ankleConstOffset + params_->ankleAmplitude * cos(M_PI * (t + params_->anklePhaseOffset));
+    commands_->angles_[RAnklePitch] += params_->ankleConstOffset + params_->ankleAmplitude * cos(M_PI * (t + 1.0 + params_->anklePhaseOffset));
 
 
     setArms(commands_->angles_,arm_offset_);
@@ -490,14 +557,14 @@ void UTWalkEngine::walk() {
 }
 
 void UTWalkEngine::applyHTWKClosedLoop(float angles[], float bodyTilt, float bodyRoll) {
-    angles[LHipPitch] += params_.balanceHipPitch * bodyTilt;
-    angles[RHipPitch] += params_.balanceHipPitch * bodyTilt;
-    angles[LKneePitch] += params_.balanceKneePitch * bodyTilt;
-    angles[RKneePitch] += params_.balanceKneePitch * bodyTilt;
-    angles[LHipRoll] += params_.balanceHipRoll * bodyRoll;
-    angles[RHipRoll] += params_.balanceHipRoll * bodyRoll;
-    angles[LAnkleRoll] += params_.balanceAnkleRoll * bodyRoll;
-    angles[RAnkleRoll] += params_.balanceAnkleRoll * bodyRoll;
+    angles[LHipPitch] += params_->balanceHipPitch * bodyTilt;
+    angles[RHipPitch] += params_->balanceHipPitch * bodyTilt;
+    angles[LKneePitch] += params_->balanceKneePitch * bodyTilt;
+    angles[RKneePitch] += params_->balanceKneePitch * bodyTilt;
+    angles[LHipRoll] += params_->balanceHipRoll * bodyRoll;
+    angles[RHipRoll] += params_->balanceHipRoll * bodyRoll;
+    angles[LAnkleRoll] += params_->balanceAnkleRoll * bodyRoll;
+    angles[RAnkleRoll] += params_->balanceAnkleRoll * bodyRoll;
 }
 
 float UTWalkEngine::calcGroinAngle(float t, bool left_swing, float step_turn_size) {
@@ -507,24 +574,24 @@ float UTWalkEngine::calcGroinAngle(float t, bool left_swing, float step_turn_siz
         turn_left = false;
     }
     if (left_swing == turn_left) {
-        if (t + 0.5 < params_.fraction_still_)
+        if (t + 0.5 < params_->fraction_still_)
             return 0;
-        else if (t + 0.5 < params_.fraction_still_ + params_.fraction_moving_)
-            return -step_turn_size * 0.5 * (1 - cos(M_PI * (t + 0.5 - params_.fraction_still_) / params_.fraction_moving_));
+        else if (t + 0.5 < params_->fraction_still_ + params_->fraction_moving_)
+            return -step_turn_size * 0.5 * (1 - cos(M_PI * (t + 0.5 - params_->fraction_still_) / params_->fraction_moving_));
         else
             return -step_turn_size;
     } else {
-        if (t + 0.5 < params_.fraction_still_)
+        if (t + 0.5 < params_->fraction_still_)
             return -step_turn_size;
-        else if (t + 0.5 < params_.fraction_still_ + params_.fraction_moving_)
-            return -step_turn_size * 0.5 * (1 + cos(M_PI * (t + 0.5 - params_.fraction_still_) / params_.fraction_moving_));
+        else if (t + 0.5 < params_->fraction_still_ + params_->fraction_moving_)
+            return -step_turn_size * 0.5 * (1 + cos(M_PI * (t + 0.5 - params_->fraction_still_) / params_->fraction_moving_));
         else
             return 0;
     }
 }
 
 float UTWalkEngine::calcSwingAnkleFrac(float t) {
-    float fraction_affected = 2 * (1.0 - params_.fraction_on_ground_ - params_.fraction_in_air_);
+    float fraction_affected = 2 * (1.0 - params_->fraction_on_ground_ - params_->fraction_in_air_);
     if (t + 0.5 < 1.0 - fraction_affected)
         return 0;
     else
@@ -532,15 +599,15 @@ float UTWalkEngine::calcSwingAnkleFrac(float t) {
 }
 
 float UTWalkEngine::calcShiftFrac(float t) {
-    float y = -1 + 0.5 * (cosh(params_.k_ * t * 0.5) - 1); // NOTE if you change this, you must change resetTime since it's based on setting the two pendulum positions equal
+    float y = -1 + 0.5 * (cosh(params_->k_ * t * 0.5) - 1); // NOTE if you change this, you must change resetTime since it's based on setting the two pendulum positions equal
     return y;
 }
 
 float UTWalkEngine::calcHeightFrac(float t) {
     float height = 0;
     t = (t - phase_start_) / (phase_end_ - phase_start_);
-    if ((t > params_.fraction_on_ground_) && (t < params_.fraction_on_ground_ + params_.fraction_in_air_)) {
-        height = 0.5 * (1 - cos(2 * M_PI * (t - params_.fraction_on_ground_) / params_.fraction_in_air_));
+    if ((t > params_->fraction_on_ground_) && (t < params_->fraction_on_ground_ + params_->fraction_in_air_)) {
+        height = 0.5 * (1 - cos(2 * M_PI * (t - params_->fraction_on_ground_) / params_->fraction_in_air_));
     }
     return height;
 }
@@ -551,16 +618,16 @@ inline float sigmoid(float t) {
 
 float UTWalkEngine::calcSwingFwd(float t) {
     float m = 0.125;
-    if (t + 0.5 < params_.fraction_still_) {
-        return -0.5 - t + params_.fraction_still_;
-    } else if (t + 0.5 < params_.fraction_still_ + params_.fraction_moving_) {
+    if (t + 0.5 < params_->fraction_still_) {
+        return -0.5 - t + params_->fraction_still_;
+    } else if (t + 0.5 < params_->fraction_still_ + params_->fraction_moving_) {
         float scale = 10.0;
-        t = scale * (-0.5 + (t + 0.5 - params_.fraction_still_) / params_.fraction_moving_);
+        t = scale * (-0.5 + (t + 0.5 - params_->fraction_still_) / params_->fraction_moving_);
         float minVal = sigmoid(-scale * 0.5);
         float maxVal = sigmoid(scale * 0.5);
-        return (1 + 2 * params_.fraction_still_) * (-0.5 + (sigmoid(t) - minVal) / (maxVal - minVal)) + 0.5 + params_.fraction_still_;
+        return (1 + 2 * params_->fraction_still_) * (-0.5 + (sigmoid(t) - minVal) / (maxVal - minVal)) + 0.5 + params_->fraction_still_;
     } else {
-        return 1.5 - t + params_.fraction_still_;
+        return 1.5 - t + params_->fraction_still_;
     }
 }
 
@@ -570,7 +637,7 @@ void UTWalkEngine::calcFwdFracs(float t, float &stance_fwd, float &swing_fwd) {
     swing_fwd = calcSwingFwd(t);
 
     // calculate stance
-    stance_fwd = 0.5 - t + params_.fraction_still_;
+    stance_fwd = 0.5 - t + params_->fraction_still_;
 }
 
 void UTWalkEngine::setArms(float *command_angles, const Vector2<float> &arm_offset) {
@@ -30,14 +30,19 @@ public:
     void init(Memory *mem);
     void processFrame();
 
+    // Reads every parameter set again from the parameter registry and
+    // restarts the walk from standing with the default set.  Only call it
+    // between motion frames.
+    void reloadParameters();
+
     inline double getMaxXSpeed()   {
-        return params_.max_step_size_.translation.x;
+        return params_->max_step_size_.translation.x;
     }
     inline double getMaxYSpeed()   {
-        return params_.max_step_size_.translation.y;
+        return params_->max_step_size_.translation.y;
     }
     inline double getMaxRotSpeed() {
-        return params_.max_step_size_.rotation;
+        return params_->max_step_size_.rotation;
     }
 
     inline double getStepSizeTranslationX() {
@@ -66,14 +71,26 @@ private:
     InverseKinematics inverse_kinematics_;
     RobotDimensions robot_dimensions_;
 
-    WalkEngineParameters params_;
-    map<WalkRequestBlock::ParamSet, WalkEngineParameters> paramSets;
+    // parameters currently driving the walk, points either into paramSets_
+    // or at blend_params_ while a transition is in progress
+    const WalkEngineParameters *params_;
+    WalkEngineParameters *paramSets_[WalkRequestBlock::NUM_PARAM_SETS];
+    WalkRequestBlock::ParamSet current_param_set_;
+
+    // blended transitions between parameter sets, advanced once per step
+    int param_transition_steps_;
+    int blend_step_;
+    const WalkEngineParameters *blend_target_;
+    WalkEngineParameters *blend_start_;
+    WalkEngineParameters *blend_params_;
 
     WalkRequestBlock::Motion last_frame_motion_;
     float last_time_;
 
+    void loadParameterSets();
     void setWalkParameters(WalkRequestBlock::ParamSet paramSet);
-    void setWalkParameters(const WalkEngineParameters &params);
+    void setWalkParameters(const WalkEngineParameters *params);
+    void advanceParamBlend();
 
     void processWalkRequest();
 
@@ -1,116 +1,184 @@
 #include "WalkEngineParameters.h"
 
 #include <math/Geometry.h>
+#include <common/ParamRegistry.h>
 
-#include <map>
 #include <stdio.h>
-extern map<string, string> namedParams; // from main.cc
 
 static double
-getParam(const map<string, string>& namedParams, const string name)
+getParam(const ParamRegistry& params, const string name)
 {
-    map<string, string>::const_iterator it = namedParams.find(name);
-    if ( it == namedParams.end())
+    ParamID id = params.find(name);
+    if (!params.has(id))
         throw "In \"WalkEngineParameters\": Missing parameter: " + name;
 
-    return atof(it->second.c_str());
+    return params.get(id);
 }
 
 WalkEngineParameters::WalkEngineParameters(const string& prefix):
     // max speeds
 //  max_step_size_(DEG_T_RAD*70,50,40),
-    max_step_size_(getParam(namedParams, prefix + "utwalk_max_step_size_angle"),
-                   getParam(namedParams, prefix + "utwalk_max_step_size_x"),
-                   getParam(namedParams, prefix + "utwalk_max_step_size_y")),
+    max_step_size_(getParam(getParams(), prefix + "utwalk_max_step_size_angle"),
+                   getParam(getParams(), prefix + "utwalk_max_step_size_x"),
+                   getParam(getParams(), prefix + "utwalk_max_step_size_y")),
     // dimensions of walk
 //  shift_amount_(20), // ?? might be different for fast and slow walk ??
-    shift_amount_(getParam(namedParams, prefix + "utwalk_shift_amount")), // ?? might be different for fast and slow walk ??
+    shift_amount_(getParam(getParams(), prefix + "utwalk_shift_amount")), // ?? might be different for fast and slow walk ??
     foot_separation_(2 * 50), // fixed parameter
 //  walk_height_(175),
-    walk_height_(getParam(namedParams, prefix + "utwalk_walk_height")),
+    walk_height_(getParam(getParams(), prefix + "utwalk_walk_height")),
 //  step_height_(20),
-    step_height_(getParam(namedParams, prefix + "utwalk_step_height")),
+    step_height_(getParam(getParams(), prefix + "utwalk_step_height")),
     // timing of moving swing foot
 //  fraction_still_(0.20),
-    fraction_still_(getParam(namedParams, prefix + "utwalk_fraction_still")),
+    fraction_still_(getParam(getParams(), prefix + "utwalk_fraction_still")),
     //fraction_moving_(1.0 - 2 * fraction_still_), // fixed parameter
-    fraction_moving_(getParam(namedParams, prefix + "utwalk_fraction_moving")), // fixed parameter
+    fraction_moving_(getParam(getParams(), prefix + "utwalk_fraction_moving")), // fixed parameter
     // timing of raising swing foot
 //  fraction_on_ground_(0.20), // probably should be the utwalk as fraction_still_
-    fraction_on_ground_(getParam(namedParams, prefix + "utwalk_fraction_on_ground")), // probably should be the utwalk as fraction_still_
+    fraction_on_ground_(getParam(getParams(), prefix + "utwalk_fraction_on_ground")), // probably should be the utwalk as fraction_still_
     //fraction_in_air_(1.0 - 2 * fraction_on_ground_),
-    fraction_in_air_(getParam(namedParams, prefix + "utwalk_fraction_in_air")),
+    fraction_in_air_(getParam(getParams(), prefix + "utwalk_fraction_in_air")),
     // other
 //  phase_length_(0.38),
-    phase_length_(getParam(namedParams, prefix + "utwalk_phase_length")),
+    phase_length_(getParam(getParams(), prefix + "utwalk_phase_length")),
     k_(sqrtf(9806.65f / walk_height_)), // sqrt(g/h) // fixed parameter
     //swing_ankle_offset_(DEG_T_RAD * -5), // if open for opt., start from 0
-    swing_ankle_offset_(getParam(namedParams, prefix + "utwalk_swing_ankle_offset")),
+    swing_ankle_offset_(getParam(getParams(), prefix + "utwalk_swing_ankle_offset")),
     com_measurement_delay_(0.02),
-    //com_measurement_delay_(getParam(namedParams, prefix + "utwalk_com_measurement_delay")),
+    //com_measurement_delay_(getParam(getParams(), prefix + "utwalk_com_measurement_delay")),
 
     // pid tilt and roll params
     //pid_tilt_(0.15,0,0.01),
-    pid_tilt_(getParam(namedParams, prefix + "utwalk_pid_tilt"),0,0),
+    pid_tilt_(getParam(getParams(), prefix + "utwalk_pid_tilt"),0,0),
     //pid_roll_(0.2,0,0),
-    pid_roll_(getParam(namedParams, prefix + "utwalk_pid_roll"),0,0),
+    pid_roll_(getParam(getParams(), prefix + "utwalk_pid_roll"),0,0),
 
     // pid com params
     //pid_com_x_(1.0,0,0),
-    pid_com_x_(getParam(namedParams, prefix + "utwalk_pid_com_x"),0,0),
+    pid_com_x_(getParam(getParams(), prefix + "utwalk_pid_com_x"),0,0),
     //pid_com_y_(1.0,0,0),
-    pid_com_y_(getParam(namedParams, prefix + "utwalk_pid_com_y"),0,0),
+    pid_com_y_(getParam(getParams(), prefix + "utwalk_pid_com_y"),0,0),
     //pid_com_z_(0.0,0,0),
-    pid_com_z_(getParam(namedParams, prefix + "utwalk_pid_com_z"),0,0),
+    pid_com_z_(getParam(getParams(), prefix + "utwalk_pid_com_z"),0,0),
 
     // pid arm params
     //pid_arm_x_(1.0,0,0),
-    pid_arm_x_(getParam(namedParams, prefix + "utwalk_pid_arm_x"),0,0),
+    pid_arm_x_(getParam(getParams(), prefix + "utwalk_pid_arm_x"),0,0),
     //pid_arm_y_(1.0,0,0),
-    pid_arm_y_(getParam(namedParams, prefix + "utwalk_pid_arm_y"),0,0),
+    pid_arm_y_(getParam(getParams(), prefix + "utwalk_pid_arm_y"),0,0),
 
     // pid step params
 //  pid_step_size_x_(0.03,0,0), // related to how smoothly to accelerate
-    pid_step_size_x_(getParam(namedParams, prefix + "utwalk_pid_step_size_x"),0,0), // related to how smoothly to accelerate
+    pid_step_size_x_(getParam(getParams(), prefix + "utwalk_pid_step_size_x"),0,0), // related to how smoothly to accelerate
 //  pid_step_size_y_(0.03,0,0), // related to how smoothly to accelerate
-    //pid_step_size_y_(getParam(namedParams, prefix + "utwalk_pid_step_size_x"),0,0), // related to how smoothly to accelerate
-    pid_step_size_y_(getParam(namedParams, prefix + "utwalk_pid_step_size_y"),0,0), // related to how smoothly to accelerate
+    //pid_step_size_y_(getParam(getParams(), prefix + "utwalk_pid_step_size_x"),0,0), // related to how smoothly to accelerate
+    pid_step_size_y_(getParam(getParams(), prefix + "utwalk_pid_step_size_y"),0,0), // related to how smoothly to accelerate
 //  pid_step_size_rot_(0.03,0,0), // related to how smoothly to accelerate
-    pid_step_size_rot_(getParam(namedParams, prefix + "utwalk_pid_step_size_rot"),0,0), // related to how smoothly to accelerate
+    pid_step_size_rot_(getParam(getParams(), prefix + "utwalk_pid_step_size_rot"),0,0), // related to how smoothly to accelerate
     // default com
 //  default_com_pos_(-15,0,0), // definitely open for opt.// <<<<<<
-    default_com_pos_(getParam(namedParams, prefix + "utwalk_default_com_pos_x"),0,0), // definitely open for opt.
+    default_com_pos_(getParam(getParams(), prefix + "utwalk_default_com_pos_x"),0,0), // definitely open for opt.
 
     // corrections to commands (for example turning right when walking forwards
     correction_fwd_(0,0,DEG_T_RAD * 0), // fixed parameter
     // handling com error using step size
 //  max_normal_com_error_(7.5,7.5), // open these// <<<<<<
-    max_normal_com_error_(getParam(namedParams, prefix + "utwalk_max_normal_com_error"), getParam(namedParams, prefix + "utwalk_max_normal_com_error")),
+    max_normal_com_error_(getParam(getParams(), prefix + "utwalk_max_normal_com_error"), getParam(getParams(), prefix + "utwalk_max_normal_com_error")),
 //  max_acceptable_com_error_(12.5,12.5)// open these// <<<<<<
-    max_acceptable_com_error_(getParam(namedParams, prefix + "utwalk_max_acceptable_com_error"),getParam(namedParams, prefix + "utwalk_max_acceptable_com_error")),
+    max_acceptable_com_error_(getParam(getParams(), prefix + "utwalk_max_acceptable_com_error"),getParam(getParams(), prefix + "utwalk_max_acceptable_com_error")),
 //  fwd_offset_(2.5),
-    fwd_offset_(getParam(namedParams, prefix + "utwalk_fwd_offset")),
+    fwd_offset_(getParam(getParams(), prefix + "utwalk_fwd_offset")),
 //  fwd_offset_factor_(0.5),
-    fwd_offset_factor_(getParam(namedParams, prefix + "utwalk_fwd_offset_factor")),
+    fwd_offset_factor_(getParam(getParams(), prefix + "utwalk_fwd_offset_factor")),
     //  balanceHipPitch(0),
-    balanceHipPitch(getParam(namedParams,prefix + "utwalk_balance_hip_pitch")),
+    balanceHipPitch(getParam(getParams(), prefix + "utwalk_balance_hip_pitch")),
     // balanceKneePitch(0),
-    balanceKneePitch(getParam(namedParams,prefix + "utwalk_balance_knee_pitch")),
+    balanceKneePitch(getParam(getParams(), prefix + "utwalk_balance_knee_pitch")),
     // balanceHipRoll(0),
-    balanceHipRoll(getParam(namedParams,prefix + "utwalk_balance_hip_roll")),
+    balanceHipRoll(getParam(getParams(), prefix + "utwalk_balance_hip_roll")),
     // balanceAnkleRoll(0),
-    balanceAnkleRoll(getParam(namedParams,prefix + "utwalk_balance_ankle_roll")),
+    balanceAnkleRoll(getParam(getParams(), prefix + "utwalk_balance_ankle_roll")),
     // toeConstOffset(0),
-    toeConstOffset(getParam(namedParams,prefix + "utwalk_toe_const_offset")),
+    toeConstOffset(getParam(getParams(), prefix + "utwalk_toe_const_offset")),
     // toeAmplitude(0),
-    toeAmplitude(getParam(namedParams,prefix + "utwalk_toe_amplitude")),
+    toeAmplitude(getParam(getParams(), prefix + "utwalk_toe_amplitude")),
     // toePhaseOffset(0),
-    toePhaseOffset(getParam(namedParams,prefix + "utwalk_toe_phase_offset")),
+    toePhaseOffset(getParam(getParams(), prefix + "utwalk_toe_phase_offset")),
     // ankleConstOffset(0),
-    ankleConstOffset(getParam(namedParams,prefix + "utwalk_ankle_const_offset")),
+    ankleConstOffset(getParam(getParams(), prefix + "utwalk_ankle_const_offset")),
     //ankleAmplitude(0),
-    ankleAmplitude(getParam(namedParams,prefix + "utwalk_ankle_amplitude")),
+    ankleAmplitude(getParam(getParams(), prefix + "utwalk_ankle_amplitude")),
     //anklePhaseOffset(0)
-    anklePhaseOffset(getParam(namedParams,prefix + "utwalk_ankle_phase_offset"))
+    anklePhaseOffset(getParam(getParams(), prefix + "utwalk_ankle_phase_offset"))
 {
 }
+
+
+static inline float
+lerp(float from, float to, float frac)
+{
+    return from + (to - from) * frac;
+}
+
+template <class V>
+static inline V
+lerp(const V& from, const V& to, float frac)
+{
+    return from + (to - from) * frac;
+}
+
+static inline Pose2D
+lerp(const Pose2D& from, const Pose2D& to, float frac)
+{
+    return Pose2D(lerp(from.rotation, to.rotation, frac),
+                  lerp(from.translation, to.translation, frac));
+}
+
+void WalkEngineParameters::interpolate(const WalkEngineParameters &from, const WalkEngineParameters &to, float frac, WalkEngineParameters &out)
+{
+    out.max_step_size_ = lerp(from.max_step_size_, to.max_step_size_, frac);
+    out.shift_amount_ = lerp(from.shift_amount_, to.shift_amount_, frac);
+    out.foot_separation_ = lerp(from.foot_separation_, to.foot_separation_, frac);
+    out.walk_height_ = lerp(from.walk_height_, to.walk_height_, frac);
+    out.step_height_ = lerp(from.step_height_, to.step_height_, frac);
+    out.fraction_still_ = lerp(from.fraction_still_, to.fraction_still_, frac);
+    out.fraction_moving_ = lerp(from.fraction_moving_, to.fraction_moving_, frac);
+    out.fraction_on_ground_ = lerp(from.fraction_on_ground_, to.fraction_on_ground_, frac);
+    out.fraction_in_air_ = lerp(from.fraction_in_air_, to.fraction_in_air_, frac);
+    out.phase_length_ = lerp(from.phase_length_, to.phase_length_, frac);
+    out.k_ = sqrtf(9806.65f / out.walk_height_); // sqrt(g/h)
+    out.swing_ankle_offset_ = lerp(from.swing_ankle_offset_, to.swing_ankle_offset_, frac);
+    out.com_measurement_delay_ = lerp(from.com_measurement_delay_, to.com_measurement_delay_, frac);
+
+    out.pid_tilt_ = lerp(from.pid_tilt_, to.pid_tilt_, frac);
+    out.pid_roll_ = lerp(from.pid_roll_, to.pid_roll_, frac);
+    out.pid_com_x_ = lerp(from.pid_com_x_, to.pid_com_x_, frac);
+    out.pid_com_y_ = lerp(from.pid_com_y_, to.pid_com_y_, frac);
+    out.pid_com_z_ = lerp(from.pid_com_z_, to.pid_com_z_, frac);
+    out.pid_arm_x_ = lerp(from.pid_arm_x_, to.pid_arm_x_, frac);
+    out.pid_arm_y_ = lerp(from.pid_arm_y_, to.pid_arm_y_, frac);
+    out.pid_step_size_x_ = lerp(from.pid_step_size_x_, to.pid_step_size_x_, frac);
+    out.pid_step_size_y_ = lerp(from.pid_step_size_y_, to.pid_step_size_y_, frac);
+    out.pid_step_size_rot_ = lerp(from.pid_step_size_rot_, to.pid_step_size_rot_, frac);
+
+    out.default_com_pos_ = lerp(from.default_com_pos_, to.default_com_pos_, frac);
+    out.correction_fwd_ = lerp(from.correction_fwd_, to.correction_fwd_, frac);
+    out.max_normal_com_error_ = lerp(from.max_normal_com_error_, to.max_normal_com_error_, frac);
+    out.max_acceptable_com_error_ = lerp(from.max_acceptable_com_error_, to.max_acceptable_com_error_, frac);
+
+    out.fwd_offset_ = lerp(from.fwd_offset_, to.fwd_offset_, frac);
+    out.fwd_offset_factor_ = lerp(from.fwd_offset_factor_, to.fwd_offset_factor_, frac);
+
+    out.balanceHipPitch = lerp(from.balanceHipPitch, to.balanceHipPitch, frac);
+    out.balanceKneePitch = lerp(from.balanceKneePitch, to.balanceKneePitch, frac);
+    out.balanceHipRoll = lerp(from.balanceHipRoll, to.balanceHipRoll, frac);
+    out.balanceAnkleRoll = lerp(from.balanceAnkleRoll, to.balanceAnkleRoll, frac);
+
+    out.toeConstOffset = lerp(from.toeConstOffset, to.toeConstOffset, frac);
+    out.toeAmplitude = lerp(from.toeAmplitude, to.toeAmplitude, frac);
+    out.toePhaseOffset = lerp(from.toePhaseOffset, to.toePhaseOffset, frac);
+    out.ankleConstOffset = lerp(from.ankleConstOffset, to.ankleConstOffset, frac);
+    out.ankleAmplitude = lerp(from.ankleAmplitude, to.ankleAmplitude, frac);
+    out.anklePhaseOffset = lerp(from.anklePhaseOffset, to.anklePhaseOffset, frac);
+}
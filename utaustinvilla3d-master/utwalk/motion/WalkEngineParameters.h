@@ -11,6 +11,13 @@ struct WalkEngineParameters {
      */
     WalkEngineParameters(const std::string& prefix = "");
 
+    /**
+     * Linearly interpolate every parameter between from (frac = 0) and
+     * to (frac = 1), writing the result into out.  Derived values such as
+     * k_ are recomputed from the interpolated values.
+     */
+    static void interpolate(const WalkEngineParameters &from, const WalkEngineParameters &to, float frac, WalkEngineParameters &out);
+
     // all distances refer to mm unless otherwise specified
     // angles are all in radians
     // times are all in seconds
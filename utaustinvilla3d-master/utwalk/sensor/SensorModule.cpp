@@ -8,12 +8,12 @@
 SensorModule::~SensorModule() {};
 
 void SensorModule::specifyMemoryBlocks() {
-    requiresMemoryBlock("raw_sensors");
-    requiresMemoryBlock("processed_sensors");
-    requiresMemoryBlock("frame_info");
-    getMemoryBlock(raw_sensors_,"raw_sensors");
-    getMemoryBlock(sensors_,"processed_sensors");
-    getMemoryBlock(frame_info_,"frame_info");
+    requiresMemoryBlock(MB_RAW_SENSORS);
+    requiresMemoryBlock(MB_PROCESSED_SENSORS);
+    requiresMemoryBlock(MB_FRAME_INFO);
+    getMemoryBlock<MB_RAW_SENSORS>(raw_sensors_);
+    getMemoryBlock<MB_PROCESSED_SENSORS>(sensors_);
+    getMemoryBlock<MB_FRAME_INFO>(frame_info_);
 
     inertial_filter_.init(frame_info_->source == MEMORY_SIM);
 }
@@ -0,0 +1,235 @@
+/*
+ * ringlogreader: prints the frames of a ring log written by RingLogger
+ * (the motion_log_file parameter), oldest first.
+ *
+ * usage: ringlogreader <log file> [--blocks name,name,...] [--from frame_id] [--to frame_id] [--list]
+ */
+
+#include <memory/RingLogger.h>
+#include <memory/FrameInfoBlock.h>
+#include <memory/JointBlock.h>
+#include <memory/JointCommandBlock.h>
+#include <memory/SensorBlock.h>
+#include <memory/WalkRequestBlock.h>
+#include <memory/WalkEngineBlock.h>
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+using namespace std;
+
+struct Record {
+    unsigned long long sequence;
+    const char *data;
+
+    bool operator<(const Record &other) const {
+        return sequence < other.sequence;
+    }
+};
+
+/*
+ * Copies a logged block over block.  The logged vtable pointer belongs to
+ * the agent process, so ours is kept.  Returns false if the block changed
+ * layout since the log was written.
+ */
+template <class T>
+static bool decodeBlock(const char *data, const RingLogBlockEntry &entry, T &block) {
+    if (entry.size != sizeof(T) || entry.version != block.header.version) {
+        return false;
+    }
+    char vptr[sizeof(void*)];
+    memcpy(vptr, (const void*)&block, sizeof(vptr));
+    memcpy((void*)&block, data, sizeof(T));
+    memcpy((void*)&block, vptr, sizeof(vptr));
+    return true;
+}
+
+static void printValues(const float values[], int num) {
+    for (int i = 0; i < num; i++) {
+        cout << " " << values[i];
+    }
+    cout << "\n";
+}
+
+static void printHex(const char *data, unsigned int size) {
+    for (unsigned int i = 0; i < size; i++) {
+        cout << (i % 32 == 0 ? "\n    " : " ") << hex << setw(2) << setfill('0') << (unsigned int)(unsigned char)data[i];
+    }
+    cout << dec << setfill(' ') << "\n";
+}
+
+static void printBlock(const char *data, const RingLogBlockEntry &entry) {
+    string name = entry.name;
+    cout << "  " << name << ":";
+
+    if (name == "frame_info" || name == "vision_frame_info") {
+        FrameInfoBlock block(0, 0, MEMORY_ROBOT);
+        if (decodeBlock(data, entry, block)) {
+            cout << " frame " << block.frame_id << " time " << block.seconds_since_start << "\n";
+            return;
+        }
+    }
+    else if (name == "raw_joint_angles" || name == "processed_joint_angles") {
+        JointBlock block;
+        if (decodeBlock(data, entry, block)) {
+            printValues(block.values_, NUM_JOINTS);
+            return;
+        }
+    }
+    else if (name == "raw_joint_commands" || name == "processed_joint_commands") {
+        JointCommandBlock block;
+        if (decodeBlock(data, entry, block)) {
+            cout << " angle_time " << block.angle_time_;
+            printValues(block.angles_, NUM_JOINTS);
+            return;
+        }
+    }
+    else if (name == "raw_sensors" || name == "processed_sensors") {
+        SensorBlock block;
+        if (decodeBlock(data, entry, block)) {
+            printValues(block.values_, NUM_SENSORS);
+            return;
+        }
+    }
+    else if (name == "walk_request") {
+        WalkRequestBlock block;
+        if (decodeBlock(data, entry, block)) {
+            cout << " motion " << block.motion_ << " params " << block.paramSet_
+                 << " speed " << block.speed_.translation.x << " " << block.speed_.translation.y << " " << block.speed_.rotation << "\n";
+            return;
+        }
+    }
+    else if (name == "walk_engine") {
+        WalkEngineBlock block;
+        if (decodeBlock(data, entry, block)) {
+            cout << " phase " << block.phase_frac_ << (block.left_swing_ ? " left" : " right")
+                 << " step " << block.step_size_.translation.x << " " << block.step_size_.translation.y << " " << block.step_size_.rotation << "\n";
+            return;
+        }
+    }
+
+    printHex(data, entry.size);
+}
+
+static void printHelp() {
+    cout << "usage: ringlogreader <log file> [options]\n";
+    cout << " --blocks <name,name,...>\tonly print these blocks\n";
+    cout << " --from <frame id>\tskip frames before this one\n";
+    cout << " --to <frame id>\tskip frames after this one\n";
+    cout << " --list\tonly list the logged blocks\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printHelp();
+        return 1;
+    }
+
+    vector<string> onlyBlocks;
+    unsigned int fromFrame = 0;
+    unsigned int toFrame = ~0u;
+    bool fList = false;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--blocks") == 0 && i + 1 < argc) {
+            stringstream ss(argv[++i]);
+            string name;
+            while (getline(ss, name, ',')) {
+                onlyBlocks.push_back(name);
+            }
+        }
+        else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            fromFrame = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            toFrame = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--list") == 0) {
+            fList = true;
+        }
+        else {
+            printHelp();
+            return 1;
+        }
+    }
+
+    ifstream in(argv[1], ios::binary);
+    if (!in) {
+        cerr << "Could not open ring log " << argv[1] << endl;
+        return 1;
+    }
+    vector<char> log((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+    RingLogHeader header;
+    if (log.size() < sizeof(header)) {
+        cerr << argv[1] << " is not a ring log" << endl;
+        return 1;
+    }
+    memcpy(&header, &log[0], sizeof(header));
+    if (strncmp(header.magic, RING_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+            header.format_version != RING_LOG_FORMAT_VERSION) {
+        cerr << argv[1] << " is not a ring log of format version " << RING_LOG_FORMAT_VERSION << endl;
+        return 1;
+    }
+    if (log.size() < header.records_offset + (size_t)header.record_size * header.num_records) {
+        cerr << argv[1] << " is truncated" << endl;
+        return 1;
+    }
+
+    vector<RingLogBlockEntry> blocks(header.num_blocks);
+    if (header.num_blocks > 0) {
+        memcpy(&blocks[0], &log[sizeof(header)], header.num_blocks * sizeof(RingLogBlockEntry));
+    }
+
+    if (fList) {
+        for (unsigned int i = 0; i < blocks.size(); i++) {
+            cout << blocks[i].name << " version " << blocks[i].version << " size " << blocks[i].size << "\n";
+        }
+        cout << header.num_records << " records of " << header.record_size << " bytes\n";
+        return 0;
+    }
+
+    int frameInfo = -1;
+    for (unsigned int i = 0; i < blocks.size(); i++) {
+        if (strcmp(blocks[i].name, "frame_info") == 0) {
+            frameInfo = i;
+        }
+    }
+
+    vector<Record> records;
+    for (unsigned int i = 0; i < header.num_records; i++) {
+        Record record;
+        record.data = &log[header.records_offset + (size_t)header.record_size * i];
+        memcpy(&record.sequence, record.data, sizeof(record.sequence));
+        if (record.sequence != 0) {
+            records.push_back(record);
+        }
+    }
+    sort(records.begin(), records.end());
+
+    for (unsigned int r = 0; r < records.size(); r++) {
+        if (frameInfo >= 0) {
+            FrameInfoBlock frame(0, 0, MEMORY_ROBOT);
+            if (decodeBlock(records[r].data + blocks[frameInfo].offset, blocks[frameInfo], frame) &&
+                    (frame.frame_id < fromFrame || frame.frame_id > toFrame)) {
+                continue;
+            }
+        }
+
+        cout << "record " << records[r].sequence << "\n";
+        for (unsigned int i = 0; i < blocks.size(); i++) {
+            if (!onlyBlocks.empty() && find(onlyBlocks.begin(), onlyBlocks.end(), string(blocks[i].name)) == onlyBlocks.end()) {
+                continue;
+            }
+            printBlock(records[r].data + blocks[i].offset, blocks[i]);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "playerindex.h"
+
+PlayerIndex::PlayerIndex() {
+    numTeammates = 0;
+    numOpponents = 0;
+}
+
+void PlayerIndex::build(const WorldObject *worldObjects, int myUNum, const VecPosition &myPosition,
+                        const VecPosition &ball) {
+    VecPosition flatBall = ball;
+    flatBall.setZ(0);
+
+    numTeammates = 0;
+    numOpponents = 0;
+    for (int i = 0; i < NUM_AGENTS; ++i) {
+        int uNum = i + 1;
+
+        IndexedPlayer &teammate = teammates[numTeammates];
+        teammate.id = WO_TEAMMATE1 + i;
+        teammate.uNum = uNum;
+        teammate.fTeammate = true;
+        teammate.fSelf = uNum == myUNum;
+        if (teammate.fSelf) {
+            teammate.pos = myPosition;
+        } else if (worldObjects[teammate.id].validPosition) {
+            teammate.pos = worldObjects[teammate.id].pos;
+        }
+        if (teammate.fSelf || worldObjects[teammate.id].validPosition) {
+            teammate.pos.setZ(0);
+            teammate.distanceToBall = teammate.pos.getDistanceTo(flatBall);
+            numTeammates++;
+        }
+
+        IndexedPlayer &opponent = opponents[numOpponents];
+        opponent.id = WO_OPPONENT1 + i;
+        opponent.uNum = uNum;
+        opponent.fTeammate = false;
+        opponent.fSelf = false;
+        if (worldObjects[opponent.id].validPosition) {
+            opponent.pos = worldObjects[opponent.id].pos;
+            opponent.pos.setZ(0);
+            opponent.distanceToBall = opponent.pos.getDistanceTo(flatBall);
+            numOpponents++;
+        }
+    }
+
+    sortByDistanceToBall(teammates, numTeammates);
+    sortByDistanceToBall(opponents, numOpponents);
+}
+
+// Insertion sort: stable, so ties stay in uniform number order, and the
+// fastest there is for at most NUM_AGENTS players
+void PlayerIndex::sortByDistanceToBall(IndexedPlayer *players, int numPlayers) {
+    for (int i = 1; i < numPlayers; ++i) {
+        IndexedPlayer player = players[i];
+        int j = i;
+        for (; j > 0 && players[j - 1].distanceToBall > player.distanceToBall; --j) {
+            players[j] = players[j - 1];
+        }
+        players[j] = player;
+    }
+}
+
+const IndexedPlayer* PlayerIndex::getNearest(const VecPosition &pos, bool fTeammates, bool fOpponents,
+        bool fSkipSelf) const {
+    VecPosition flatPos = pos;
+    flatPos.setZ(0);
+
+    const IndexedPlayer *nearest = NULL;
+    double nearestDistance = 0;
+    if (fTeammates) {
+        for (int i = 0; i < numTeammates; ++i) {
+            if (fSkipSelf && teammates[i].fSelf) {
+                continue;
+            }
+            double distance = flatPos.getDistanceTo(teammates[i].pos);
+            if (nearest == NULL || distance < nearestDistance) {
+                nearest = &teammates[i];
+                nearestDistance = distance;
+            }
+        }
+    }
+    if (fOpponents) {
+        for (int i = 0; i < numOpponents; ++i) {
+            double distance = flatPos.getDistanceTo(opponents[i].pos);
+            if (nearest == NULL || distance < nearestDistance) {
+                nearest = &opponents[i];
+                nearestDistance = distance;
+            }
+        }
+    }
+    return nearest;
+}
+
+int PlayerIndex::getWithinRadius(const VecPosition &pos, double radius, bool fTeammates, bool fOpponents,
+                                 const IndexedPlayer **found, int maxFound, bool fSkipSelf) const {
+    VecPosition flatPos = pos;
+    flatPos.setZ(0);
+
+    int numFound = 0;
+    if (fTeammates) {
+        for (int i = 0; i < numTeammates && numFound < maxFound; ++i) {
+            if (!(fSkipSelf && teammates[i].fSelf) && flatPos.getDistanceTo(teammates[i].pos) <= radius) {
+                found[numFound++] = &teammates[i];
+            }
+        }
+    }
+    if (fOpponents) {
+        for (int i = 0; i < numOpponents && numFound < maxFound; ++i) {
+            if (flatPos.getDistanceTo(opponents[i].pos) <= radius) {
+                found[numFound++] = &opponents[i];
+            }
+        }
+    }
+    return numFound;
+}
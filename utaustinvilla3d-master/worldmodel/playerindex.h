@@ -0,0 +1,87 @@
+#ifndef PLAYERINDEX_H
+#define PLAYERINDEX_H
+
+#include "WorldObject.h"
+#include "../headers/headers.h"
+
+/*
+ * A player whose position the world model knows, flattened onto the field
+ */
+struct IndexedPlayer {
+    int id; // WO_TEAMMATE1..WO_TEAMMATE11 or WO_OPPONENT1..WO_OPPONENT11
+    int uNum;
+    bool fTeammate;
+    bool fSelf;
+    VecPosition pos; // z is 0
+    double distanceToBall;
+};
+
+/*
+ * Answers the spatial questions behaviors keep asking about the players,
+ * such as who is closest to the ball or what is near a point, from one
+ * snapshot of the world model taken per cycle.
+ *
+ * Teammates (including ourself) and opponents are kept apart, each sorted
+ * by distance to the ball.  Only players with a valid position are
+ * indexed; ourself always is, at our localized position.  With at most 22
+ * players a linear scan of the compact arrays beats any tree, so the
+ * nearest and radius queries are just that.
+ */
+class PlayerIndex {
+
+public:
+
+    PlayerIndex();
+
+    void build(const WorldObject *worldObjects, int myUNum, const VecPosition &myPosition,
+               const VecPosition &ball);
+
+    inline int getNumTeammates() const {
+        return numTeammates;
+    }
+    // The i'th closest teammate to the ball
+    inline const IndexedPlayer& getTeammate(int i) const {
+        return teammates[i];
+    }
+
+    inline int getNumOpponents() const {
+        return numOpponents;
+    }
+    // The i'th closest opponent to the ball
+    inline const IndexedPlayer& getOpponent(int i) const {
+        return opponents[i];
+    }
+
+    // The teammate or opponent closest to the ball, or NULL if none is known
+    inline const IndexedPlayer* getTeammateClosestToBall() const {
+        return numTeammates > 0 ? &teammates[0] : NULL;
+    }
+    inline const IndexedPlayer* getOpponentClosestToBall() const {
+        return numOpponents > 0 ? &opponents[0] : NULL;
+    }
+
+    /*
+     * The player closest to pos among those selected, or NULL if there is
+     * none.  fSkipSelf leaves ourself out of the teammates.
+     */
+    const IndexedPlayer* getNearest(const VecPosition &pos, bool fTeammates, bool fOpponents,
+                                    bool fSkipSelf = true) const;
+
+    /*
+     * Fills found with the selected players within radius of pos, up to
+     * maxFound of them, and returns how many there were.
+     */
+    int getWithinRadius(const VecPosition &pos, double radius, bool fTeammates, bool fOpponents,
+                        const IndexedPlayer **found, int maxFound, bool fSkipSelf = true) const;
+
+private:
+
+    IndexedPlayer teammates[NUM_AGENTS];
+    int numTeammates;
+    IndexedPlayer opponents[NUM_AGENTS];
+    int numOpponents;
+
+    static void sortByDistanceToBall(IndexedPlayer *players, int numPlayers);
+};
+
+#endif // PLAYERINDEX_H
@@ -0,0 +1,63 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+/*
+ * The last N items pushed, kept in place: pushing never allocates, and
+ * once full each push overwrites the oldest item.  Index 0 is the newest
+ * item and size() - 1 the oldest.
+ */
+template<class T, int N>
+class RingBuffer {
+
+public:
+
+    RingBuffer() {
+        newest = N - 1;
+        count = 0;
+    }
+
+    inline void push(const T &item) {
+        newest = (newest + 1) % N;
+        items[newest] = item;
+        if (count < N) {
+            count++;
+        }
+    }
+
+    // Fills the buffer with N copies of item
+    inline void fill(const T &item) {
+        for (int i = 0; i < N; i++) {
+            items[i] = item;
+        }
+        count = N;
+    }
+
+    inline void clear() {
+        count = 0;
+    }
+
+    inline const T& operator[](int i) const {
+        return items[(newest - i + N) % N];
+    }
+
+    inline int size() const {
+        return count;
+    }
+    inline bool empty() const {
+        return count == 0;
+    }
+    inline bool full() const {
+        return count == N;
+    }
+    static inline int capacity() {
+        return N;
+    }
+
+private:
+
+    T items[N];
+    int newest;
+    int count;
+};
+
+#endif // RINGBUFFER_H
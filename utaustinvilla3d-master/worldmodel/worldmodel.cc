@@ -19,8 +19,7 @@ WorldModel::WorldModel() {
     side = SIDE_LEFT;//dummy
     sideSet = false;
 
-    lastSkills.push_back( SKILL_STAND ) ;//dummy
-    lastSkills.push_back( SKILL_STAND ) ;//dummy
+    lastSkills.fill( SKILL_STAND ) ;//dummy
 
     lastOdometryPos = SIM::Point2D(0,0);
     lastOdometryAngDeg = 0;
@@ -48,13 +47,13 @@ WorldModel::WorldModel() {
 
     lastBallSightingTime = -100;
 
-    lastBallSeenPosition = vector<VecPosition>(3,VecPosition(0,0,0));
-    lastBallSeenTime = vector<double>(3,0);
+    lastBallSeenPosition.fill(VecPosition(0,0,0));
+    lastBallSeenTime.fill(0);
 
     lastLineSightingTime = -100;
 
     localToGlobal = HCTMatrix();
-    globalToLocal = HCTMatrix();
+    updateGlobalToLocal();
 
     fallenTeammate = vector<bool>(NUM_AGENTS);
     fallenOpponent = vector<bool>(NUM_AGENTS);
@@ -177,6 +176,35 @@ void WorldModel::updateGoalPostsAndFlags() {
 
 }
 
+/*
+ * Derives globalToLocal, and the cached torso origin and axes, from
+ * localToGlobal.  localToGlobal is a rotation and a translation, so its
+ * inverse is the transposed rotation and the translation brought back
+ * through it; the rows are normalized as the corners the rotation comes
+ * from are noisy and may leave it slightly off orthonormal.
+ */
+void WorldModel::updateGlobalToLocal() {
+    myTorsoGlobal = l2g(VecPosition(0, 0, 0));
+
+    for (int j = 0; j < 3; j++) {
+        myTorsoAxesGlobal[j] = VecPosition(localToGlobal.getCell(0, j),
+                                           localToGlobal.getCell(1, j),
+                                           localToGlobal.getCell(2, j));
+        VecPosition row = myTorsoAxesGlobal[j];
+        row.normalize();
+
+        setGlobalToLocal(j, 0, row.getX());
+        setGlobalToLocal(j, 1, row.getY());
+        setGlobalToLocal(j, 2, row.getZ());
+        setGlobalToLocal(j, 3, -(myTorsoGlobal.dotProduct(row)));
+    }
+
+    setGlobalToLocal(3, 0, 0);
+    setGlobalToLocal(3, 1, 0);
+    setGlobalToLocal(3, 2, 0);
+    setGlobalToLocal(3, 3, 1.0);
+}
+
 // Updates the l2g and g2l matrices based on 4 points of the field
 void WorldModel::
 updateMatricesAndMovingObjs( VecPosition& fieldXPlusYPlus,
@@ -209,64 +237,41 @@ updateMatricesAndMovingObjs( VecPosition& fieldXPlusYPlus,
     setLocalToGlobal(3, 2, 0);
     setLocalToGlobal(3, 3, 1.0);
 
+    updateGlobalToLocal();
 
-    VecPosition localBodyCentre = VecPosition(0, 0, 0);
-    VecPosition localBodyXDirection = VecPosition(1.0, 0, 0);
-    VecPosition localBodyYDirection = VecPosition(0, 1.0, 0);
-    VecPosition localBodyZDirection = VecPosition(0, 0, 1.0);
-
-    VecPosition bodyCentre = l2g(localBodyCentre);
-    VecPosition bodyXDirection = (l2g(localBodyXDirection) - bodyCentre).normalize();
-    VecPosition bodyYDirection = (l2g(localBodyYDirection) - bodyCentre).normalize();
-    VecPosition bodyZDirection = (l2g(localBodyZDirection) - bodyCentre).normalize();
-
-    setGlobalToLocal(0, 0, bodyXDirection.getX());
-    setGlobalToLocal(0, 1, bodyXDirection.getY());
-    setGlobalToLocal(0, 2, bodyXDirection.getZ());
-    setGlobalToLocal(0, 3, -(bodyCentre.dotProduct(bodyXDirection)));
-
-    setGlobalToLocal(1, 0, bodyYDirection.getX());
-    setGlobalToLocal(1, 1, bodyYDirection.getY());
-    setGlobalToLocal(1, 2, bodyYDirection.getZ());
-    setGlobalToLocal(1, 3, -(bodyCentre.dotProduct(bodyYDirection)));
-
-    setGlobalToLocal(2, 0, bodyZDirection.getX());
-    setGlobalToLocal(2, 1, bodyZDirection.getY());
-    setGlobalToLocal(2, 2, bodyZDirection.getZ());
-    setGlobalToLocal(2, 3, -(bodyCentre.dotProduct(bodyZDirection)));
-
-    setGlobalToLocal(3, 0, 0);
-    setGlobalToLocal(3, 1, 0);
-    setGlobalToLocal(3, 2, 0);
-    setGlobalToLocal(3, 3, 1.0);
-
-    // Set coordinates for moving objects
+    // Set coordinates for moving objects, transforming all those seen at once
+    int seenIDs[NUM_WORLD_OBJS];
+    VecPosition seenPositions[NUM_WORLD_OBJS];
+    int numSeen = 0;
     for( int i = WO_BALL; i <= WO_OPPONENT_FOOT_R11; ++i ) {
-
         WorldObject* pObj = getWorldObject(i);
-
         if( pObj->currentlySeen ) {
+            seenIDs[numSeen] = i;
+            seenPositions[numSeen] = pObj->vision.polar.getCartesianFromPolar();
+            numSeen++;
+        }
+    }
+    l2g(seenPositions, seenPositions, numSeen);
 
+    for( int s = 0; s < numSeen; ++s ) {
 
-            VecPosition objLocalOrigin = pObj->vision.polar.getCartesianFromPolar();
-            VecPosition objGlobal = l2g( objLocalOrigin );
-
-            if( pObj->id == WO_BALL ) {
+        WorldObject* pObj = getWorldObject(seenIDs[s]);
+        VecPosition objGlobal = seenPositions[s];
 
-                setBall( objGlobal );
+        if( pObj->id == WO_BALL ) {
 
-            } else if( WO_OPPONENT1 <= pObj->id && pObj->id <= WO_OPPONENT11 ) {
+            setBall( objGlobal );
 
-                setOpponent( pObj->id, objGlobal );
+        } else if( WO_OPPONENT1 <= pObj->id && pObj->id <= WO_OPPONENT11 ) {
 
-            } else if( WO_TEAMMATE1 <= pObj->id && pObj->id <= WO_TEAMMATE11 ) {
+            setOpponent( pObj->id, objGlobal );
 
-                setTeammate( pObj->id, objGlobal );
+        } else if( WO_TEAMMATE1 <= pObj->id && pObj->id <= WO_TEAMMATE11 ) {
 
-            } else if( WO_TEAMMATE_HEAD1 <= pObj->id && pObj->id <= WO_OPPONENT_FOOT_R11 ) {
-                setObjectPosition( pObj->id, objGlobal );
-            }
+            setTeammate( pObj->id, objGlobal );
 
+        } else if( WO_TEAMMATE_HEAD1 <= pObj->id && pObj->id <= WO_OPPONENT_FOOT_R11 ) {
+            setObjectPosition( pObj->id, objGlobal );
         }
     }
 
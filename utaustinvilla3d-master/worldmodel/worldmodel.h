@@ -5,6 +5,8 @@
 #include "../math/Geometry.h"
 #include "../math/hctmatrix.h"
 #include "WorldObject.h"
+#include "playerindex.h"
+#include "ringbuffer.h"
 #include "../headers/Field.h"
 #include "../rvdraw/rvdraw.h"
 
@@ -13,6 +15,11 @@ class PlayerKF;
 
 using namespace std;
 
+// Sizes of the history WorldModel keeps
+#define BALL_SEEN_HISTORY 3
+#define SKILL_HISTORY 2
+#define MAX_EXECUTED_SKILLS 32
+
 class WorldModel {
 
 private:
@@ -32,6 +39,7 @@ private:
     bool sideSet;
 
     WorldObject worldObjects[NUM_WORLD_OBJS];
+    PlayerIndex playerIndex;
     VecPosition myPosition;
     SIM::AngDeg myAngDegrees;
     bool confident;
@@ -52,12 +60,14 @@ private:
     double lastLineSightingTime;
 
     // This is where we actually saw the ball ourself
-    vector<VecPosition> lastBallSeenPosition;
-    vector<double> lastBallSeenTime;
+    RingBuffer<VecPosition, BALL_SEEN_HISTORY> lastBallSeenPosition;
+    RingBuffer<double, BALL_SEEN_HISTORY> lastBallSeenTime;
 
     // remember last two skills
-    vector<SkillType> lastSkills;
-    vector<SkillType> executedSkillsForOdometry;
+    RingBuffer<SkillType, SKILL_HISTORY> lastSkills;
+    // skills executed since the last resetExecutedSkills(), the oldest
+    // dropped past MAX_EXECUTED_SKILLS
+    RingBuffer<SkillType, MAX_EXECUTED_SKILLS> executedSkillsForOdometry;
 
     // record last odometry from particle filter
     SIM::Point2D lastOdometryPos;
@@ -67,6 +77,12 @@ private:
     bool fFallen;
 
     HCTMatrix localToGlobal, globalToLocal;
+    // The torso's origin and unit axes in global coordinates, derived from
+    // localToGlobal whenever it changes
+    VecPosition myTorsoGlobal;
+    VecPosition myTorsoAxesGlobal[3];
+
+    void updateGlobalToLocal();
 
     vector<bool> fallenTeammate;
     vector<bool> fallenOpponent;
@@ -92,6 +108,15 @@ public:
         return &worldObjects[index];
     }
     void updateGoalPostsAndFlags();
+
+    // Rebuilds the player index from the current positions; done once a
+    // cycle after vision and localization have updated them
+    inline void updatePlayerIndex() {
+        playerIndex.build(worldObjects, uNum, myPosition, getBall());
+    }
+    inline const PlayerIndex& getPlayerIndex() const {
+        return playerIndex;
+    }
     void updateMatricesAndMovingObjs( VecPosition& fieldXPlusYPlus,
                                       VecPosition& fieldXPlusYMinus,
                                       VecPosition& fieldXMinusYPlus,
@@ -194,20 +219,19 @@ public:
         return lastLineSightingTime;
     }
 
-    inline void setLastBallSeenPosition(VecPosition position) {
-        lastBallSeenPosition.insert(lastBallSeenPosition.begin(),position);
-        lastBallSeenPosition.pop_back();
+    // Index 0 is the most recent sighting
+    inline void setLastBallSeenPosition(const VecPosition &position) {
+        lastBallSeenPosition.push(position);
     }
-    inline vector<VecPosition> getLastBallSeenPosition() const {
+    inline const RingBuffer<VecPosition, BALL_SEEN_HISTORY>& getLastBallSeenPosition() const {
         return lastBallSeenPosition;
     }
 
     inline void setLastBallSeenTime(double time) {
-        lastBallSeenTime.insert(lastBallSeenTime.begin(),time);
-        lastBallSeenTime.pop_back();
+        lastBallSeenTime.push(time);
     }
 
-    inline vector<double> getLastBallSeenTime() const {
+    inline const RingBuffer<double, BALL_SEEN_HISTORY>& getLastBallSeenTime() const {
         return lastBallSeenTime;
     }
 
@@ -292,17 +316,17 @@ public:
         return lastSkills[1];
     }
     inline void setLastSkill(const SkillType &lastSkill) {
-        this->lastSkills[1] = this->lastSkills[0];
-        this->lastSkills[0] = lastSkill;
+        this->lastSkills.push(lastSkill);
     }
 
 
 
     // functions for odometry
     inline void addExecutedSkill(const SkillType &skill) {
-        executedSkillsForOdometry.push_back( skill );
+        executedSkillsForOdometry.push( skill );
     }
-    inline const vector<SkillType>& getExecutedSkills() const {
+    // Index 0 is the most recently executed skill
+    inline const RingBuffer<SkillType, MAX_EXECUTED_SKILLS>& getExecutedSkills() const {
         return executedSkillsForOdometry;
     }
     inline void resetExecutedSkills() {
@@ -454,6 +478,23 @@ public:
     inline VecPosition l2g(const VecPosition &local) const {
         return localToGlobal.transform(local);
     }
+    // Batched versions for arrays of n points; in and out may be the same array
+    inline void g2l(const VecPosition *global, VecPosition *local, int n) const {
+        globalToLocal.transform(global, local, n);
+    }
+    inline void l2g(const VecPosition *local, VecPosition *global, int n) const {
+        localToGlobal.transform(local, global, n);
+    }
+
+    // l2g(VecPosition(0, 0, 0)), cached with the transforms
+    inline const VecPosition& getMyTorsoGlobal() const {
+        return myTorsoGlobal;
+    }
+    // l2g of the unit vector along axis 0 (x), 1 (y) or 2 (z) minus
+    // getMyTorsoGlobal(), cached with the transforms
+    inline const VecPosition& getMyTorsoAxisGlobal(int axis) const {
+        return myTorsoAxesGlobal[axis];
+    }
 
 
     inline bool canTrustVision() {